@@ -0,0 +1,240 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    Device.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Description of the general Device Interface.
+ *
+ *          The general Device Interface shall be used as base class for all
+ *          kind of specific devices.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include "Device.h"
+#include "DeviceData.h"
+#include <stdint.h>
+#include <iostream>
+#include <string>
+
+
+/*
+ * --- Methods Definition ----------------------------------------------------- *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* Device()
+*/
+Device::Device()
+    : m_name( "undefined" )
+    , m_online( true )
+{
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* Device()
+*/
+Device::Device( std::string name )
+    : m_name( name )
+    , m_online( true )
+{
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* ~Device()
+*/
+Device::~Device()
+{
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* getName()
+*/
+const std::string& Device::getName( void ) const
+{
+    return m_name;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* setName()
+*/
+void Device::setName( std::string name )
+{
+    m_name = name;
+
+    for( size_t i = 0; i < m_data.size(); i++ )
+    {
+        if( m_data[i] != NULL )
+            m_data[i]->setMetricsDevice( m_name );
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* addData()
+*/
+Device::t_handle Device::addData( DeviceData* p_data )
+{
+    t_handle handle;
+
+    if( (p_data == NULL) || (m_index.count( p_data->getName() ) != 0) )
+        return HANDLE_INVALID;
+
+    if( m_free.empty() == false )
+    {
+        /* reuse the handle of a removed element */
+        handle = m_free.back();
+        m_free.pop_back();
+        m_data[handle] = p_data;
+    }
+    else
+    {
+        handle = (t_handle)m_data.size();
+        m_data.push_back( p_data );
+    }
+
+    m_index[p_data->getName()] = handle;
+    p_data->setOnline( m_online );
+    p_data->setMetricsDevice( m_name );
+    return handle;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* removeData()
+*/
+int16_t Device::removeData( t_handle handle )
+{
+    DeviceData* p_data = getData( handle );
+
+    if( p_data == NULL )
+        return -1;
+
+    m_index.erase( p_data->getName() );
+    m_data[handle] = NULL;
+    m_free.push_back( handle );
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* findData()
+*/
+Device::t_handle Device::findData( const std::string& name ) const
+{
+    std::unordered_map<std::string, t_handle>::const_iterator it =
+            m_index.find( name );
+
+    if( it == m_index.end() )
+        return HANDLE_INVALID;
+    return it->second;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* readAll()
+*/
+int16_t Device::readAll( std::vector<const DeviceDataValue*>& vals )
+{
+    int16_t ret = 0;
+
+    DeviceData::getVals( m_data, vals );
+
+    /* only existing elements can fail */
+    for( size_t i = 0; i < m_data.size(); i++ )
+    {
+        if( (m_data[i] != NULL) && (vals[i] == NULL) )
+            ret = -1;
+    }
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* observeAll()
+*/
+size_t Device::observeAll( DeviceDataObserver* p_obs, void* p_param )
+{
+    size_t failed = 0;
+
+    for( size_t i = 0; i < m_data.size(); i++ )
+    {
+        if( (m_data[i] != NULL) && m_data[i]->getObserveable() )
+        {
+            if( m_data[i]->observeVal( p_obs, p_param ) != 0 )
+                failed++;
+        }
+    }
+    return failed;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* unobserveAll()
+*/
+size_t Device::unobserveAll( DeviceDataObserver* p_obs, void* p_param )
+{
+    size_t num = 0;
+
+    for( size_t i = 0; i < m_data.size(); i++ )
+    {
+        if( m_data[i] != NULL )
+            num += m_data[i]->unobserveVal( p_obs, p_param );
+    }
+    return num;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* setOnline()
+*/
+void Device::setOnline( bool online )
+{
+    m_online = online;
+
+    for( size_t i = 0; i < m_data.size(); i++ )
+    {
+        if( m_data[i] != NULL )
+            m_data[i]->setOnline( online );
+    }
+}
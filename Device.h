@@ -57,6 +57,15 @@
 #include <stdint.h>
 #include <iostream>
 #include <string>
+#include <vector>
+#include <unordered_map>
+
+/*
+ * --- Forward Declaration ----------------------------------------------------- *
+ */
+class DeviceData;
+class DeviceDataValue;
+class DeviceDataObserver;
 
 /*
  * --- Class Definition ----------------------------------------------------- *
@@ -65,13 +74,25 @@
 /**
  * \brief   General Device Class.
  *
- *          The Device Class provides the base class for all devices.
+ *          The Device Class provides the base class for all devices. A
+ *          device holds all of its device data elements. Each element is
+ *          identified by a handle that can be used for constant time
+ *          access. Elements can also be looked up by their names.
+ *
+ *          Adding or removing elements must not happen concurrently to
+ *          other accesses of the device.
  */
 class Device
 {
 
 public:
 
+    /** handle of a device data element */
+    typedef uint32_t t_handle;
+
+    /** invalid handle */
+    static const t_handle HANDLE_INVALID = 0xFFFFFFFF;
+
     /**
      * \brief   Default Constructor to create a device.
      */
@@ -87,6 +108,9 @@ public:
 
     /**
      * \brief   Default Destructor of the device.
+     *
+     *          The device data elements are not owned by the device and
+     *          are therefore not deleted.
      */
 	virtual ~Device();
 
@@ -95,7 +119,7 @@ public:
      *
      * \return  The name of the device.
      */
-    std::string getName( void );
+    const std::string& getName( void ) const;
 
     /**
      * \brief   Set the name of the device.
@@ -104,12 +128,142 @@ public:
      */
     void setName( std::string name );
 
+    /**
+     * \brief   Add a device data element to the device.
+     *
+     * \param   p_data  Element to add.
+     *
+     * \return  Handle of the element or HANDLE_INVALID if an element
+     *          with the same name exists already.
+     */
+    t_handle addData( DeviceData* p_data );
+
+    /**
+     * \brief   Remove a device data element from the device.
+     *
+     *          The handle of the element becomes invalid and might be
+     *          reused for other elements.
+     *
+     * \param   handle  Handle of the element to remove.
+     *
+     * \return  0 on success.
+     */
+    int16_t removeData( t_handle handle );
+
+    /**
+     * \brief   Get a device data element by its handle.
+     *
+     * \param   handle  Handle of the element.
+     *
+     * \return  The element or NULL if the handle is not valid.
+     */
+    DeviceData* getData( t_handle handle ) const {
+        if( handle < m_data.size() )
+            return m_data[handle];
+        return NULL;
+    }
+
+    /**
+     * \brief   Get the handle of a device data element by its name.
+     *
+     * \param   name    Name of the element.
+     *
+     * \return  The handle or HANDLE_INVALID if there is no such element.
+     */
+    t_handle findData( const std::string& name ) const;
+
+    /**
+     * \brief   Get all device data elements of the device.
+     *
+     *          The elements are stored at the index of their handles.
+     *          Entries of removed elements are NULL.
+     *
+     * \return  All the device data elements.
+     */
+    const std::vector<DeviceData*>& getDataList( void ) const {
+        return m_data;
+    }
+
+    /**
+     * \brief   Get the number of device data elements.
+     *
+     * \return  Number of device data elements.
+     */
+    size_t getNumData( void ) const {
+        return m_index.size();
+    }
+
+    /**
+     * \brief   Read all device data elements of the device.
+     *
+     *          The elements are read using DeviceData::getVals() so that
+     *          elements of the same backend are read together.
+     *
+     * \param   vals    Filled with the values of the elements at the index
+     *                  of their handles. Entries of elements that could not
+     *                  be read are NULL.
+     *
+     * \return  0 if all elements were read or -1 if at least one failed.
+     */
+    int16_t readAll( std::vector<const DeviceDataValue*>& vals );
+
+    /**
+     * \brief   Observe all observable device data elements of the device.
+     *
+     * \param   p_obs   Observer.
+     * \param   p_param Additional parameter that will given as
+     *                  parameter to the callback function.
+     *
+     * \return  Number of elements that could not be observed.
+     */
+    size_t observeAll( DeviceDataObserver* p_obs, void* p_param );
+
+    /**
+     * \brief   Stop observing all device data elements of the device.
+     *
+     * \param   p_obs   Observer.
+     * \param   p_param Parameter the observer was registered with.
+     *
+     * \return  Number of removed registrations.
+     */
+    size_t unobserveAll( DeviceDataObserver* p_obs, void* p_param );
+
+    /**
+     * \brief   Set the device and all its device data elements online or
+     *          offline.
+     *
+     *          Accesses to elements of an offline device fail immediately.
+     *
+     * \param   online  true if the device is online.
+     */
+    void setOnline( bool online );
+
+    /**
+     * \brief   Check if the device is online.
+     *
+     * \return  true if the device is online.
+     */
+    bool getOnline( void ) const {
+        return m_online;
+    }
+
 private:
 
     /** name of the device */
     std::string m_name;
+
+    /** device data elements at the index of their handles */
+    std::vector<DeviceData*> m_data;
+
+    /** handles of the device data elements by name */
+    std::unordered_map<std::string, t_handle> m_index;
+
+    /** handles of removed elements that can be reused */
+    std::vector<t_handle> m_free;
+
+    /** device is online */
+    bool m_online;
 	
 };
 
 #endif /* #ifndef __DEVICE_H__ */
-
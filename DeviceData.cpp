@@ -48,33 +48,270 @@
  */
 #include "DeviceData.h"
 #include "DeviceDataObserver.h"
+#include "DeviceDataDispatcher.h"
+#include "DeviceDataTimer.h"
+#include "DeviceDataHistory.h"
+#include "DeviceDataLog.h"
 #include <stdint.h>
 #include <iostream>
 #include <string>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 
+/*
+ * --- Local Class Definition ----------------------------------------------- *
+ */
+
+/**
+ * \brief   Rate limit of a single observer.
+ *
+ *          The first change after a quiet period is delivered directly.
+ *          Further changes within the interval are kept and the latest
+ *          one is delivered by the timer when the interval expired. Only
+ *          one notification is delivered at a time. A change offered while
+ *          a notification is delivered is kept as well, so the observer
+ *          may change the element from within the notification.
+ */
+class DeviceDataRateLimit
+        : public DeviceDataTimer::Entry
+{
+
+public:
+
+    /**
+     * \brief   Constructor of a rate limit.
+     *
+     * \param   p_timer     Timer to use.
+     * \param   interval    Minimum interval between two notifications.
+     * \param   p_data      Observed device data element.
+     * \param   p_obs       Observer.
+     * \param   p_param     Parameter of the observer.
+     */
+    DeviceDataRateLimit( DeviceDataTimer* p_timer,
+            std::chrono::milliseconds interval, const DeviceData* p_data,
+            DeviceDataObserver* p_obs, void* p_param )
+        : mp_timer( p_timer )
+        , m_interval( interval )
+        , mp_data( p_data )
+        , mp_obs( p_obs )
+        , mp_param( p_param )
+        , m_val( DeviceDataValue::TYPE_INTEGER )
+        , m_pending( false )
+        , m_delivering( false )
+        , m_cancelled( false )
+        , m_suppressed( 0 ) {};
+
+    /**
+     * \brief   Default Destructor of a rate limit.
+     */
+    virtual ~DeviceDataRateLimit( void ) {
+        mp_timer->stop( this );
+    }
+
+    /**
+     * \brief   Hand over a changed value.
+     *
+     * \param   val     The changed value.
+     */
+    void offer( const DeviceDataValue* val ) {
+        std::unique_lock< std::mutex > lock( m_mutex );
+        std::chrono::steady_clock::time_point now =
+            std::chrono::steady_clock::now();
+
+        if( m_cancelled )
+            return;
+
+        if( (m_pending == false) && (m_delivering == false) && (now >= m_next) )
+        {
+            /* quiet period, deliver directly */
+            m_next = now + m_interval;
+            deliver( lock, val, 0 );
+            return;
+        }
+
+        if( m_pending )
+            /* the value kept before is replaced */
+            m_suppressed++;
+        else
+        {
+            m_pending = true;
+            mp_timer->start( this, (uint32_t)std::chrono::duration_cast<
+                std::chrono::milliseconds >( m_next - now ).count() + 1 );
+        }
+        m_val = *val;
+    }
+
+    /**
+     * \brief   Drop a value waiting for delivery and ignore further values.
+     */
+    void cancel( void ) {
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            m_cancelled = true;
+            m_pending = false;
+        }
+        mp_timer->stop( this );
+    }
+
+private:
+
+    /**
+     * \brief   Deliver the latest value when the interval expired.
+     */
+    virtual void expired( void ) {
+        std::unique_lock< std::mutex > lock( m_mutex );
+
+        if( (m_pending == false) || m_cancelled )
+            return;
+
+        if( m_delivering )
+        {
+            /* wait for the notification running to return */
+            mp_timer->start( this, 1 );
+            return;
+        }
+
+        DeviceDataValue val( m_val );
+        uint32_t suppressed = m_suppressed;
+
+        m_pending = false;
+        m_suppressed = 0;
+        m_next = std::chrono::steady_clock::now() + m_interval;
+        deliver( lock, &val, suppressed );
+    }
+
+    /**
+     * \brief   Notify the observer without holding the lock.
+     *
+     * \param   lock        Lock of the state, held on entry and on return.
+     * \param   val         Value to deliver.
+     * \param   suppressed  Number of values replaced before.
+     */
+    void deliver( std::unique_lock< std::mutex >& lock,
+            const DeviceDataValue* val, uint32_t suppressed ) {
+        m_delivering = true;
+        lock.unlock();
+
+        mp_obs->notifyCoalesced( val, mp_data, mp_param, suppressed );
+
+        lock.lock();
+        m_delivering = false;
+    }
+
+private:
+
+    /** timer */
+    DeviceDataTimer* mp_timer;
+
+    /** minimum interval between two notifications */
+    std::chrono::milliseconds m_interval;
+
+    /** observed device data element */
+    const DeviceData* mp_data;
+
+    /** observer */
+    DeviceDataObserver* mp_obs;
+
+    /** parameter of the observer */
+    void* mp_param;
+
+    /** protects the state against the timer thread */
+    std::mutex m_mutex;
+
+    /** latest value not yet delivered */
+    DeviceDataValue m_val;
+
+    /** a value is waiting for the interval to expire */
+    bool m_pending;
+
+    /** a notification is being delivered */
+    bool m_delivering;
+
+    /** the observer was removed */
+    bool m_cancelled;
+
+    /** number of values replaced since the last notification */
+    uint32_t m_suppressed;
+
+    /** earliest time of the next notification */
+    std::chrono::steady_clock::time_point m_next;
+};
+
+
+/*
+ * --- Local Variables ------------------------------------------------------ *
+ */
+
+/** timer to rate limit notifications */
+static DeviceDataTimer* gp_timer = NULL;
+
+/** protects the timer */
+static std::mutex g_timerMutex;
+
 
 /*
  * --- Methods Definition ----------------------------------------------------- *
  */
 
+/*---------------------------------------------------------------------------*/
+/*
+* ~DeviceData()
+*/
+DeviceData::~DeviceData( void )
+{
+    /* elements not derived from a backend */
+    shutdown();
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* shutdown()
+*/
+void DeviceData::shutdown( void )
+{
+    /* wait for queued notifications to be delivered */
+    while( m_dispatchPending > 0 )
+        std::this_thread::yield();
+}
+
 /*---------------------------------------------------------------------------*/
 /*
 * getVal()
 */
-const DeviceDataValue* DeviceData::getVal( void )
+const DeviceDataValue* DeviceData::getVal( uint32_t maxAge )
 {
+    DEVICEDATA_METRICS_COUNT( metricsScope(), DeviceDataMetrics::OP_GETVAL );
+
     /* check if the value is readable */
-    if( m_readable)
+    if( m_readable && m_online )
     {
-        if( m_observed == false )
+        if( m_observed == true )
+            /* observed values are reported by the backend */
+            m_observedReads++;
+        else if( cacheValid( maxAge ) )
+            m_cacheHits++;
+        else
         {
-            /* Value is readable. Call the native function
-             * to access the value. */
-            if( getValNative( &m_val ) != 0 )
+            m_cacheMisses++;
+
+            /* Value is readable. Call the native function to access
+             * the value. A failed read must not change the cached
+             * value, so it is read into a value of its own. */
+            DeviceDataValue val( m_valType );
+            DEVICEDATA_METRICS_START( start );
+            int16_t ret = getValNative( &val );
+            DEVICEDATA_METRICS_NATIVE( metricsScope(),
+                DeviceDataMetrics::NATIVE_READ, ret, start );
+
+            if( ret != 0 )
                 /* invalid value */
                 return NULL;
+
+            storeVal( std::move( val ) );
         }
+
         return &m_val;
     }
     return NULL;
@@ -86,12 +323,23 @@ const DeviceDataValue* DeviceData::getVal( void )
 */
 int16_t DeviceData::setVal( const DeviceDataValue* val )
 {
+    DEVICEDATA_METRICS_COUNT( metricsScope(), DeviceDataMetrics::OP_SETVAL );
+
+    /* an offline element can not be accessed */
+    if( m_online == false )
+        return -3;
+
     /* check if the value is writable */
     if( m_writable)
     {
         /* Value is writable. Call the native function
          * to access the value. */
-        if( setValNative( val ) == 0 )
+        DEVICEDATA_METRICS_START( start );
+        int16_t ret = setValNative( val );
+        DEVICEDATA_METRICS_NATIVE( metricsScope(),
+            DeviceDataMetrics::NATIVE_WRITE, ret, start );
+
+        if( ret == 0 )
         {
             /* value was set properly, issue callbacks */
             valueChanged( val );
@@ -103,30 +351,318 @@ int16_t DeviceData::setVal( const DeviceDataValue* val )
 
 }
 
+/*---------------------------------------------------------------------------*/
+/*
+* getValAsync()
+*/
+int16_t DeviceData::getValAsync( const t_complete& cb )
+{
+    DEVICEDATA_METRICS_COUNT( metricsScope(), DeviceDataMetrics::OP_GETVAL );
+
+    /* check if the value is readable */
+    if( (m_readable == false) || (m_online == false) )
+        return -1;
+
+    if( (m_observed == true) || cacheValid( m_maxAge ) )
+    {
+        /* value is up to date already */
+        if( m_observed == true )
+            m_observedReads++;
+        else
+            m_cacheHits++;
+        cb( 0, &m_val );
+        return 0;
+    }
+    m_cacheMisses++;
+
+    /* the native access works on its own copy of the value since
+     * several requests might be pending at the same time */
+    std::shared_ptr<DeviceDataValue> p_val =
+            std::make_shared<DeviceDataValue>( m_valType );
+
+    /* the latency is measured until the completion */
+    DEVICEDATA_METRICS_START( start );
+
+    return getValNativeAsync( p_val.get(),
+        [=]( int16_t ret, const DeviceDataValue* )
+        {
+            DEVICEDATA_METRICS_NATIVE( metricsScope(),
+                DeviceDataMetrics::NATIVE_READ, ret, start );
+
+            if( ret == 0 )
+            {
+                storeVal( *p_val );
+
+                /* the request's own value is not changed by others */
+                cb( 0, p_val.get() );
+            }
+            else
+                cb( ret, NULL );
+        });
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* setValAsync()
+*/
+int16_t DeviceData::setValAsync( const DeviceDataValue* val, const t_complete& cb )
+{
+    DEVICEDATA_METRICS_COUNT( metricsScope(), DeviceDataMetrics::OP_SETVAL );
+
+    /* check if the value is writable */
+    if( (m_writable == false) || (val == NULL) )
+        return -1;
+
+    /* an offline element can not be accessed */
+    if( m_online == false )
+        return -3;
+
+    std::shared_ptr<DeviceDataValue> p_val =
+            std::make_shared<DeviceDataValue>( *val );
+
+    DEVICEDATA_METRICS_START( start );
+
+    return setValNativeAsync( p_val.get(),
+        [=]( int16_t ret, const DeviceDataValue* )
+        {
+            DEVICEDATA_METRICS_NATIVE( metricsScope(),
+                DeviceDataMetrics::NATIVE_WRITE, ret, start );
+
+            if( ret == 0 )
+            {
+                /* value was set properly, issue callbacks */
+                valueChanged( p_val.get() );
+                cb( 0, p_val.get() );
+            }
+            else
+                cb( -2, NULL );
+        });
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* observeVal()
+*/
+int16_t DeviceData::observeVal( DeviceDataObserver* p_obs, void* p_param,bool direct,
+        t_obsHandle* p_handle )
+{
+    return observe( p_obs, p_param, NULL, NULL, direct, p_handle );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* observeVal()
+*/
+int16_t DeviceData::observeVal( DeviceDataObserver* p_obs, void* p_param,
+        const DeviceDataFilter& filter, bool direct, t_obsHandle* p_handle )
+{
+    std::shared_ptr<DeviceDataFilter> p_filter;
+
+    /* observers without filtering do not need a filter */
+    if( filter.getMode() != DeviceDataFilter::FILTER_NONE )
+        p_filter = std::make_shared<DeviceDataFilter>( filter );
+
+    return observe( p_obs, p_param, p_filter, NULL, direct, p_handle );
+}
+
 /*---------------------------------------------------------------------------*/
 /*
 * observeVal()
 */
-int16_t DeviceData::observeVal( DeviceDataObserver* p_obs, void* p_param,bool direct )
+int16_t DeviceData::observeVal( DeviceDataObserver* p_obs, void* p_param,
+        std::chrono::milliseconds minInterval, const DeviceDataFilter& filter,
+        bool direct, t_obsHandle* p_handle )
 {
-    if( m_observable )
+    std::shared_ptr<DeviceDataFilter> p_filter;
+    std::shared_ptr<DeviceDataRateLimit> p_limit;
+
+    if( p_obs == NULL )
+        return -1;
+
+    if( filter.getMode() != DeviceDataFilter::FILTER_NONE )
+        p_filter = std::make_shared<DeviceDataFilter>( filter );
+
+    if( minInterval.count() > 0 )
+        p_limit = std::make_shared<DeviceDataRateLimit>( getTimer(),
+            minInterval, this, p_obs, p_param );
+
+    return observe( p_obs, p_param, p_filter, p_limit, direct, p_handle );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* unobserveVal()
+*/
+int16_t DeviceData::unobserveVal( t_obsHandle handle )
+{
+    std::shared_ptr<DeviceDataRateLimit> p_limit;
+    std::unique_lock< std::mutex > lock( m_obsMutex );
+    std::unordered_map< t_obsHandle, s_obs >::iterator it =
+            m_obsReg.find( handle );
+
+    if( it == m_obsReg.end() )
+        return -1;
+
+    /* the registration is skipped by the notifications from now on */
+    it->second.p_active->store( false );
+    p_limit = it->second.p_limit;
+
+    /* a direct native observation is kept until the last observer leaves */
+    if( it->second.direct )
+        m_obsDirect--;
+    m_obsReg.erase( it );
+
+    /* Copying the list is only required once as many registrations
+     * were removed as are left, so removing stays O(1) amortized. */
+    if( ++m_obsRemoved > m_obsReg.size() )
+    {
+        m_obs.remove( []( const s_obs& obs ) { return obs.p_active->load() == false; } );
+        m_obsRemoved = 0;
+    }
+
+    bool stop = m_obsReg.empty() && m_observable;
+    if( m_obsReg.empty() )
+        m_observed = false;
+    lock.unlock();
+
+    if( stop )
+    {
+        /* Nobody is interested anymore, so stop the native observation.
+         * The backend might wait for a notification running on another
+         * thread, whose observers might use m_obsMutex. */
+        std::lock_guard< std::mutex > native( m_nativeMutex );
+        lock.lock();
+        stop = m_obsReg.empty();
+        lock.unlock();
+
+        /* an observer registered in the meantime keeps the observation */
+        if( stop )
+            unobserveValNative();
+    }
+
+    /* Cancelling waits for a running delivery of the rate limit, which
+     * might notify an observer that registers or removes observers. */
+    if( p_limit != NULL )
+        p_limit->cancel();
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* unobserveVal()
+*/
+size_t DeviceData::unobserveVal( DeviceDataObserver* p_obs, void* p_param )
+{
+    std::vector< t_obsHandle > handles;
+
+    {
+        std::lock_guard< std::mutex > lock( m_obsMutex );
+        std::unordered_map< t_obsHandle, s_obs >::const_iterator it;
+
+        for( it = m_obsReg.begin(); it != m_obsReg.end(); ++it )
+        {
+            if( (it->second.p_obs == p_obs) && (it->second.p_param == p_param) )
+                handles.push_back( it->first );
+        }
+    }
+
+    size_t num = 0;
+    for( size_t i = 0; i < handles.size(); i++ )
+    {
+        if( unobserveVal( handles[i] ) == 0 )
+            num++;
+    }
+    return num;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* setTimer()
+*/
+void DeviceData::setTimer( DeviceDataTimer* p_timer )
+{
+    std::lock_guard< std::mutex > lock( g_timerMutex );
+    gp_timer = p_timer;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* getTimer()
+*/
+DeviceDataTimer* DeviceData::getTimer( void )
+{
+    std::lock_guard< std::mutex > lock( g_timerMutex );
+    if( gp_timer == NULL )
+        gp_timer = new DeviceDataTimer();
+    return gp_timer;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* observe()
+*/
+int16_t DeviceData::observe( DeviceDataObserver* p_obs, void* p_param,
+        const std::shared_ptr<DeviceDataFilter>& p_filter,
+        const std::shared_ptr<DeviceDataRateLimit>& p_limit, bool direct,
+        t_obsHandle* p_handle )
+{
+    DEVICEDATA_METRICS_COUNT( metricsScope(), DeviceDataMetrics::OP_OBSERVE );
+
+    /* polled values are reported by the poller instead */
+    if( m_observable || (m_polled > 0) )
     {
         if( p_obs != NULL )
         {
-            /* call native observe */
-            if( observeValNative( direct ) == 0 )
+            std::unique_lock< std::mutex > native( m_nativeMutex, std::defer_lock );
+            std::unique_lock< std::mutex > lock( m_obsMutex );
+
+            /* call native observe for the first observer and for the
+             * first one that requests a direct observation */
+            if( m_observable && (m_obsReg.empty() ||
+                (direct && (m_obsDirect == 0))) )
             {
-              /* create a new callback elemet and insert it
-               * into the callback vector */
-              struct s_obs obs =  { p_obs, p_param };
-              m_obs.push_back( obs );
+                /* The native observation is started without holding
+                 * m_obsMutex, see unobserveVal(). Starting and stopping
+                 * are serialized by m_nativeMutex instead. */
+                lock.unlock();
+                native.lock();
+                lock.lock();
 
-              m_observed = true;
-              return 0;
+                if( m_obsReg.empty() || (direct && (m_obsDirect == 0)) )
+                {
+                    lock.unlock();
+                    int8_t ret = observeValNative( direct );
+                    lock.lock();
+
+                    if( ret != 0 )
+                    {
+                      /* Observe was not successful so reset the flag */
+                      if( m_obsReg.empty() )
+                          m_observed = false;
+                      return -1;
+                    }
+                }
             }
-            else
-              /* Observe was not successful so reset the flag */
-              m_observed = false;
+
+            /* create a new callback elemet and insert it
+             * into the callback vector */
+            struct s_obs obs =  { p_obs, p_param, p_filter, p_limit,
+                std::make_shared< std::atomic<bool> >( true ), direct };
+            m_obs.add( obs );
+            if( direct )
+                m_obsDirect++;
+
+            if( ++m_obsHandle == OBS_HANDLE_INVALID )
+                ++m_obsHandle;
+            m_obsReg[m_obsHandle] = obs;
+
+            if( p_handle != NULL )
+                *p_handle = m_obsHandle;
+
+            /* polled values are still read on request */
+            if( m_observable )
+                m_observed = true;
+            return 0;
         }
     }
     return -1;
@@ -134,25 +670,403 @@ int16_t DeviceData::observeVal( DeviceDataObserver* p_obs, void* p_param,bool di
 
 /*---------------------------------------------------------------------------*/
 /*
-* observeVal()
+* getVals()
 */
-void DeviceData::valueChanged( const DeviceDataValue* val )
+int16_t DeviceData::getVals( const std::vector<DeviceData*>& data,
+        std::vector<const DeviceDataValue*>& vals )
 {
-    if(val != NULL)
+    int16_t ret = 0;
+
+    /* groups of elements that can be read using a single request. The
+     * first element of each group is the one the request is issued on. */
+    std::vector< std::vector<DeviceData*> > groups;
+    std::vector< std::vector<size_t> > idx;
+
+    vals.assign( data.size(), NULL );
+
+    for( size_t i = 0; i < data.size(); i++ )
     {
-        /* update value */
-        m_val = *val;
+        DeviceData* p_data = data[i];
+
+        if( p_data != NULL )
+            DEVICEDATA_METRICS_COUNT( p_data->metricsScope(),
+                DeviceDataMetrics::OP_GETVAL );
+
+        if( (p_data == NULL) || (p_data->m_readable == false) ||
+            (p_data->m_online == false) )
+        {
+            ret = -1;
+            continue;
+        }
+
+        if( (p_data->m_observed == true) ||
+            p_data->cacheValid( p_data->m_maxAge ) )
+        {
+            /* observed or cached values are up to date */
+            if( p_data->m_observed == true )
+                p_data->m_observedReads++;
+            else
+                p_data->m_cacheHits++;
+            vals[i] = &p_data->m_val;
+            continue;
+        }
+        p_data->m_cacheMisses++;
+
+        /* search for a group the element can be added to */
+        size_t g;
+        for( g = 0; g < groups.size(); g++ )
+        {
+            if( groups[g].front()->batchCompatible( p_data ) )
+                break;
+        }
+
+        if( g == groups.size() )
+        {
+            groups.push_back( std::vector<DeviceData*>() );
+            idx.push_back( std::vector<size_t>() );
+        }
+        groups[g].push_back( p_data );
+        idx[g].push_back( i );
+    }
+
+    for( size_t g = 0; g < groups.size(); g++ )
+    {
+        /* the values are read into values of their own, so a failed
+         * read does not change the cached value */
+        std::vector<DeviceDataValue> gRead;
+        std::vector<DeviceDataValue*> gVals;
+        std::vector<int16_t> gRet( groups[g].size(), -1 );
+
+        gRead.reserve( groups[g].size() );
+        for( size_t i = 0; i < groups[g].size(); i++ )
+        {
+            gRead.push_back( DeviceDataValue( groups[g][i]->m_valType ) );
+            gVals.push_back( &gRead.back() );
+        }
+
+        /* read the whole group at once */
+        DEVICEDATA_METRICS_START( start );
+        groups[g].front()->getValsNative( groups[g], gVals, gRet );
+        DEVICEDATA_METRICS_LATENCY( groups[g].front()->metricsScope(),
+            DeviceDataMetrics::NATIVE_READ, start );
+
+        for( size_t i = 0; i < groups[g].size(); i++ )
+        {
+            DEVICEDATA_METRICS_RESULT( groups[g][i]->metricsScope(),
+                DeviceDataMetrics::NATIVE_READ, gRet[i] );
+
+            if( gRet[i] == 0 )
+            {
+                groups[g][i]->storeVal( std::move( gRead[i] ) );
+                vals[idx[g][i]] = &groups[g][i]->m_val;
+            }
+            else
+                ret = -1;
+        }
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* getValsNative()
+*/
+void DeviceData::getValsNative( const std::vector<DeviceData*>& data,
+        const std::vector<DeviceDataValue*>& vals, std::vector<int16_t>& ret )
+{
+    /* read the elements one by one */
+    for( size_t i = 0; i < data.size(); i++ )
+        ret[i] = data[i]->getValNative( vals[i] );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* setVals()
+*/
+int16_t DeviceData::setVals( const std::vector<DeviceData*>& data,
+        const std::vector<const DeviceDataValue*>& vals )
+{
+    int16_t ret = 0;
+
+    /* groups of elements that can be written using a single request. The
+     * first element of each group is the one the request is issued on. */
+    std::vector< std::vector<DeviceData*> > groups;
+    std::vector< std::vector<const DeviceDataValue*> > gVals;
+
+    if( vals.size() < data.size() )
+        return -1;
+
+    for( size_t i = 0; i < data.size(); i++ )
+    {
+        DeviceData* p_data = data[i];
+
+        if( p_data != NULL )
+            DEVICEDATA_METRICS_COUNT( p_data->metricsScope(),
+                DeviceDataMetrics::OP_SETVAL );
+
+        if( (p_data == NULL) || (vals[i] == NULL) ||
+            (p_data->m_writable == false) || (p_data->m_online == false) )
+        {
+            ret = -1;
+            continue;
+        }
+
+        /* search for a group the element can be added to */
+        size_t g;
+        for( g = 0; g < groups.size(); g++ )
+        {
+            if( groups[g].front()->batchCompatible( p_data ) )
+                break;
+        }
+
+        if( g == groups.size() )
+        {
+            groups.push_back( std::vector<DeviceData*>() );
+            gVals.push_back( std::vector<const DeviceDataValue*>() );
+        }
+        groups[g].push_back( p_data );
+        gVals[g].push_back( vals[i] );
+    }
+
+    for( size_t g = 0; g < groups.size(); g++ )
+    {
+        std::vector<int16_t> gRet( groups[g].size(), -1 );
+
+        /* write the whole group at once */
+        DEVICEDATA_METRICS_START( start );
+        groups[g].front()->setValsNative( groups[g], gVals[g], gRet );
+        DEVICEDATA_METRICS_LATENCY( groups[g].front()->metricsScope(),
+            DeviceDataMetrics::NATIVE_WRITE, start );
+
+        for( size_t i = 0; i < groups[g].size(); i++ )
+        {
+            DEVICEDATA_METRICS_RESULT( groups[g][i]->metricsScope(),
+                DeviceDataMetrics::NATIVE_WRITE, gRet[i] );
+
+            if( gRet[i] == 0 )
+                /* value was set properly, issue callbacks */
+                groups[g][i]->valueChanged( gVals[g][i] );
+            else
+                ret = -1;
+        }
+    }
 
-        /* check the callback vector and inform all
-         * observers */
-        std::vector< s_obs >::iterator it;;
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* setValsNative()
+*/
+void DeviceData::setValsNative( const std::vector<DeviceData*>& data,
+        const std::vector<const DeviceDataValue*>& vals, std::vector<int16_t>& ret )
+{
+    /* write the elements one by one */
+    for( size_t i = 0; i < data.size(); i++ )
+        ret[i] = data[i]->setValNative( vals[i] );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* pollVals()
+*/
+int16_t DeviceData::pollVals( const std::vector<DeviceData*>& data )
+{
+    int16_t ret = 0;
 
-        for (it = m_obs.begin() ; it != m_obs.end(); ++it)
+    /* groups of elements that can be read using a single request */
+    std::vector< std::vector<DeviceData*> > groups;
+
+    for( size_t i = 0; i < data.size(); i++ )
+    {
+        DeviceData* p_data = data[i];
+
+        if( (p_data == NULL) || (p_data->m_readable == false) ||
+            (p_data->m_online == false) )
+        {
+            ret = -1;
+            continue;
+        }
+
+        /* search for a group the element can be added to */
+        size_t g;
+        for( g = 0; g < groups.size(); g++ )
         {
-            /* call the current callback function */
-            if( (it->p_obs != NULL) )
-                it->p_obs->notify( &m_val, this, it->p_param );
+            if( groups[g].front()->batchCompatible( p_data ) )
+                break;
         }
+
+        if( g == groups.size() )
+            groups.push_back( std::vector<DeviceData*>() );
+        groups[g].push_back( p_data );
     }
+
+    for( size_t g = 0; g < groups.size(); g++ )
+    {
+        /* the values are read into values of their own, so a failed
+         * read does not change the cached value */
+        std::vector<DeviceDataValue> gRead;
+        std::vector<DeviceDataValue*> gVals;
+        std::vector<int16_t> gRet( groups[g].size(), -1 );
+
+        gRead.reserve( groups[g].size() );
+        for( size_t i = 0; i < groups[g].size(); i++ )
+        {
+            gRead.push_back( DeviceDataValue( groups[g][i]->m_valType ) );
+            gVals.push_back( &gRead.back() );
+        }
+
+        /* read the whole group at once */
+        DEVICEDATA_METRICS_START( start );
+        groups[g].front()->getValsNative( groups[g], gVals, gRet );
+        DEVICEDATA_METRICS_LATENCY( groups[g].front()->metricsScope(),
+            DeviceDataMetrics::NATIVE_READ, start );
+
+        for( size_t i = 0; i < groups[g].size(); i++ )
+        {
+            DEVICEDATA_METRICS_RESULT( groups[g][i]->metricsScope(),
+                DeviceDataMetrics::NATIVE_READ, gRet[i] );
+
+            if( gRet[i] == 0 )
+                /* report the value read */
+                groups[g][i]->valueChanged( &gRead[i] );
+            else
+                ret = -1;
+        }
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* cacheValid()
+*/
+bool DeviceData::cacheValid( uint32_t maxAge ) const
+{
+    if( (m_valCached == false) || (maxAge == 0) )
+        return false;
+
+    /* check the age of the cached value */
+    return (std::chrono::steady_clock::now() - m_valTime) <=
+            std::chrono::milliseconds( maxAge );
 }
 
+/*---------------------------------------------------------------------------*/
+/*
+* valueChanged()
+*/
+void DeviceData::valueChanged( const DeviceDataValue* val )
+{
+    if(val != NULL)
+    {
+        if( val->getType() == m_valType )
+        {
+            storeVal( *val );
+            valueReport( *val );
+            return;
+        }
+
+        /* update value, keeping the type of the element */
+        DeviceDataValue conv( m_valType );
+        if( conv.convert( *val ) != 0 )
+            return;
+        storeVal( conv );
+        valueReport( conv );
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* valueChanged()
+*/
+void DeviceData::valueChanged( void )
+{
+    DeviceDataValue val( m_valType );
+    {
+        std::lock_guard< std::mutex > lock( m_valMutex );
+        cacheUpdated();
+        val = m_val;
+    }
+    valueReport( val );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* storeVal()
+*/
+void DeviceData::storeVal( DeviceDataValue val )
+{
+    /* Several threads might update the value at once. The lock only
+     * guards the update itself, observers are notified without it. */
+    std::lock_guard< std::mutex > lock( m_valMutex );
+    m_val = std::move( val );
+    cacheUpdated();
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* valueReport()
+*/
+void DeviceData::valueReport( const DeviceDataValue& val )
+{
+    DeviceDataHistory* p_hist = mp_history;
+    if( p_hist != NULL )
+        p_hist->add( val );
+
+    DeviceDataLog* p_log = mp_log;
+    if( p_log != NULL )
+        p_log->append( m_logHandle, val );
+
+    /* values that did not change significantly are not reported */
+    if( m_filter.pass( val ) == false )
+        return;
+
+    DeviceDataDispatcher* p_disp = mp_dispatcher;
+    if( p_disp != NULL )
+    {
+        /* let the dispatcher deliver the notification. If the
+         * queue is full the notification is dropped. */
+        m_dispatchPending++;
+        if( p_disp->push( this, val ) != 0 )
+            m_dispatchPending--;
+    }
+    else
+        notifyObservers( &val );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* notifyObservers()
+*/
+void DeviceData::notifyObservers( const DeviceDataValue* val )
+{
+    /* check the callback list and inform all
+     * observers */
+    DeviceDataObserverList< s_obs >::Snapshot obs( m_obs );
+    DeviceDataObserverList< s_obs >::t_list::const_iterator it;
+    DEVICEDATA_METRICS_START( start );
+    uint32_t notified = 0;
+
+    for (it = obs.begin() ; it != obs.end(); ++it)
+    {
+        /* call the current callback function */
+        if( (it->p_obs == NULL) || (it->p_active->load() == false) )
+            continue;
+
+        /* apply the filter of the observer */
+        if( (it->p_filter != NULL) && (it->p_filter->pass( *val ) == false) )
+            continue;
+
+        notified++;
+
+        /* rate limited observers are notified by their rate limit */
+        if( it->p_limit != NULL )
+            it->p_limit->offer( val );
+        else
+            it->p_obs->notify( val, this, it->p_param );
+    }
+
+    DEVICEDATA_METRICS_FANOUT( metricsScope(), notified, start );
+}
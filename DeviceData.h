@@ -58,13 +58,28 @@
 #include <iostream>
 #include <string>
 #include <vector>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 #include "DeviceDataValue.h"
+#include "DeviceDataFilter.h"
+#include "DeviceDataObserverList.h"
+#include "DeviceDataMetrics.h"
 
 
 /*
  * --- Forward Declaration ----------------------------------------------------- *
  */
 class DeviceDataObserver;
+class DeviceDataDispatcher;
+class DeviceDataTimer;
+class DeviceDataRateLimit;
+class DeviceDataHistory;
+class DeviceDataLog;
+class DeviceDataPoller;
 
 /*
  * --- Class Definition ----------------------------------------------------- *
@@ -80,6 +95,9 @@ class DeviceDataObserver;
 class DeviceData
 {
 
+    friend class DeviceDataDispatcher;
+    friend class DeviceDataPoller;
+
 public:
 
     /** Enumeration for the different types of access */
@@ -95,6 +113,20 @@ public:
         ACCESS_OBSERVE = 0x04
     };
 
+    /** handle of an observer registration */
+    typedef uint32_t t_obsHandle;
+
+    /** invalid observer handle */
+    static const t_obsHandle OBS_HANDLE_INVALID = 0;
+    /**
+     * \brief   Completion handler of asynchronous accesses.
+     *
+     *          The handler receives the result of the access (0 on success)
+     *          and the value read or written by the request or NULL if
+     *          the access failed. The value is only valid during the call.
+     */
+    typedef std::function< void( int16_t ret, const DeviceDataValue* p_val ) > t_complete;
+
 
     /**
      * \brief   Default Constructor to create a Device element.
@@ -106,7 +138,23 @@ public:
         , m_writable( false )
         , m_observable( false )
         , m_observed( false )
+        , m_online( true )
         , m_val( DeviceDataValue(DeviceDataValue::TYPE_INTEGER) )
+        , m_valType( DeviceDataValue::TYPE_INTEGER )
+        , m_valCached( false )
+        , m_maxAge( 0 )
+        , m_cacheHits( 0 )
+        , m_cacheMisses( 0 )
+        , m_observedReads( 0 )
+        , m_obsRemoved( 0 )
+        , m_obsDirect( 0 )
+        , m_obsHandle( OBS_HANDLE_INVALID )
+        , mp_dispatcher( NULL )
+        , m_dispatchPending( 0 )
+        , mp_history( NULL )
+        , mp_log( NULL )
+        , m_logHandle( 0 )
+        , m_polled( 0 )
         {};
 
     /**
@@ -125,23 +173,35 @@ public:
         , m_writable( access & DeviceData::ACCESS_WRITE )
         , m_observable( access & DeviceData::ACCESS_OBSERVE )
         , m_observed( false )
-        , m_val( type ) {
-
-        /* reset vector */
-        m_obs.clear();
-    };
+        , m_online( true )
+        , m_val( type )
+        , m_valType( type )
+        , m_valCached( false )
+        , m_maxAge( 0 )
+        , m_cacheHits( 0 )
+        , m_cacheMisses( 0 )
+        , m_observedReads( 0 )
+        , m_obsRemoved( 0 )
+        , m_obsDirect( 0 )
+        , m_obsHandle( OBS_HANDLE_INVALID )
+        , mp_dispatcher( NULL )
+        , m_dispatchPending( 0 )
+        , mp_history( NULL )
+        , mp_log( NULL )
+        , m_logHandle( 0 )
+        , m_polled( 0 ) {};
 
     /**
      * \brief   Default Destructor of the device element.
      */
-    virtual ~DeviceData( void ) {};
+    virtual ~DeviceData( void );
 
     /**
      * \brief   Get the name of the device data element.
      *
      * \return  The name of the device data element.
      */
-    std::string getName( void ) {
+    const std::string& getName( void ) const {
         /* return name */
         return m_name;
     }
@@ -151,7 +211,7 @@ public:
      *
      * \return  The description of the device data element.
      */
-    std::string getDescr( void ) {
+    const std::string& getDescr( void ) const {
         /* return description */
         return m_descr;
     }
@@ -186,36 +246,448 @@ public:
         return m_observable;
     }
 
+    /**
+     * \brief   Get the name of the backend of the element.
+     *
+     *          The name is used to aggregate the metrics of the elements.
+     *          Backends shall override this function.
+     *
+     * \return  The name of the backend.
+     */
+    virtual const char* getBackend( void ) const {
+        return "generic";
+    }
+
+    /**
+     * \brief   Set the device the metrics of the element are counted to.
+     *
+     *          Called by the device when the element is added. The
+     *          function does nothing if DEVICEDATA_METRICS is not defined.
+     *
+     * \param   device  Name of the device.
+     */
+    void setMetricsDevice( const std::string& device ) {
+#if defined(DEVICEDATA_METRICS)
+        m_metrics.m_scope = DeviceDataMetrics::getScope( getBackend(), device );
+#else
+        (void)device;
+#endif /* #if defined(DEVICEDATA_METRICS) */
+    }
+
+    /**
+     * \brief   Check if the value is polled by a DeviceDataPoller.
+     *
+     * \return  true if the value is polled.
+     */
+    bool getPolled( void ) const {
+        return m_polled > 0;
+    }
+
+    /**
+     * \brief   Set the device data element online or offline.
+     *
+     *          Accesses to an offline element fail immediately without
+     *          calling the native functions.
+     *
+     * \param   online  true if the element is online.
+     */
+    void setOnline( bool online ) {
+        m_online = online;
+    }
+
+    /**
+     * \brief   Check if the device data element is online.
+     *
+     * \return  true if the element is online.
+     */
+    bool getOnline( void ) const {
+        return m_online;
+    }
+
     /**
      * \brief   Get the actual value device data element.
      *
+     *          The cached value is returned if it is not older than
+     *          the maximum age set using setMaxAge().
+     *
      * \return  The actual value of the device data element.
      */
-    const DeviceDataValue* getVal( void );
+    const DeviceDataValue* getVal( void ) {
+        return getVal( m_maxAge );
+    }
+
+    /**
+     * \brief   Get the actual value device data element.
+     *
+     *          The cached value is returned if it is not older than the
+     *          given maximum age. Otherwise the value is read from the
+     *          device.
+     *
+     * \param   maxAge  Maximum age of the cached value in ms. 0 always
+     *                  reads the value from the device.
+     *
+     * \return  The actual value of the device data element.
+     */
+    const DeviceDataValue* getVal( uint32_t maxAge );
+
+    /**
+     * \brief   Set the default maximum age of the cached value.
+     *
+     * \param   maxAge  Maximum age of the cached value in ms. 0 disables
+     *                  the cache.
+     */
+    void setMaxAge( uint32_t maxAge ) {
+        m_maxAge = maxAge;
+    }
+
+    /**
+     * \brief   Get the default maximum age of the cached value.
+     *
+     * \return  Maximum age of the cached value in ms.
+     */
+    uint32_t getMaxAge( void ) const {
+        return m_maxAge;
+    }
+
+    /**
+     * \brief   Get the type of the value of the element.
+     *
+     * \return  The type of the value, it never changes.
+     */
+    DeviceDataValue::e_type getValType( void ) const {
+        return m_valType;
+    }
+
+    /**
+     * \brief   Get the time the cached value was updated the last time.
+     *
+     * \return  Time of the last update of the value.
+     */
+    std::chrono::steady_clock::time_point getValTime( void ) const {
+        return m_valTime;
+    }
+
+    /**
+     * \brief   Get the number of reads served from the cached value.
+     *
+     * \return  Number of cache hits.
+     */
+    uint32_t getCacheHits( void ) const {
+        return m_cacheHits;
+    }
+
+    /**
+     * \brief   Get the number of reads that required a native read.
+     *
+     * \return  Number of cache misses.
+     */
+    uint32_t getCacheMisses( void ) const {
+        return m_cacheMisses;
+    }
+
+    /**
+     * \brief   Get the number of reads served while the value is observed.
+     *
+     * Observed values are reported by the backend, hence such reads
+     * are neither cache hits nor cache misses.
+     *
+     * \return  Number of observed reads.
+     */
+    uint32_t getObservedReads( void ) const {
+        return m_observedReads;
+    }
+
+    /**
+     * \brief   Reset the cache hit, miss and observed read counters.
+     */
+    void resetCacheStats( void ) {
+        m_cacheHits = 0;
+        m_cacheMisses = 0;
+        m_observedReads = 0;
+    }
 
     /**
      * \brief   Set the actual value device data element.
      *
      * \param   val     Value to set the device data to.
      *
-     * \return  returns true if the value was set.
+     * \return  0 if the value was set, -1 if the value is not writable,
+     *          -2 if the native write failed or -3 if the element is
+     *          offline.
      */
     int16_t setVal( const DeviceDataValue* val );
 
+    /**
+     * \brief   Get the actual value device data element asynchronously.
+     *
+     *          The function returns immediately and the completion handler
+     *          is called as soon as the value is available. Depending on the
+     *          backend the handler might be called from within this function
+     *          or from another thread.
+     *
+     * \param   cb      Completion handler.
+     *
+     * \return  0 if the request was issued, negative value otherwise.
+     */
+    int16_t getValAsync( const t_complete& cb );
+
+    /**
+     * \brief   Set the actual value device data element asynchronously.
+     *
+     *          The function returns immediately and the completion handler
+     *          is called as soon as the value was written. Depending on the
+     *          backend the handler might be called from within this function
+     *          or from another thread.
+     *
+     * \param   val     Value to set the device data to.
+     * \param   cb      Completion handler.
+     *
+     * \return  0 if the request was issued, negative value otherwise.
+     */
+    int16_t setValAsync( const DeviceDataValue* val, const t_complete& cb );
+
     /**
      * \brief   Observe the actual value device data element.
      *
      *          If a value is observed a specific callback function
-     *          will be called whenever the value changes.
+     *          will be called whenever the value changes. Values that are
+     *          not observable can be observed as long as they are polled
+     *          by a DeviceDataPoller.
      *
      * \param   pf_obs       Observer.
      * \param   p_param      Additional parameter that will given as
      *                       parameter to the callback function.
      * \param   direct       Direct Observation or observed by higher instance.
+     * \param   p_handle     Set to the handle of the registration to
+     *                       remove it using unobserveVal(). Can be NULL.
      *
      * \return  returns true if the value is observed.
      */
-    int16_t observeVal( DeviceDataObserver* p_obs, void* p_param, bool direct = true );
+    int16_t observeVal( DeviceDataObserver* p_obs, void* p_param, bool direct = true,
+            t_obsHandle* p_handle = NULL );
+
+    /**
+     * \brief   Observe the actual value using an observer specific filter.
+     *
+     *          The observer is only notified about the values passing the
+     *          given filter in addition to the filter of the element.
+     *
+     * \param   pf_obs       Observer.
+     * \param   p_param      Additional parameter that will given as
+     *                       parameter to the callback function.
+     * \param   filter       Filter of the observer.
+     * \param   direct       Direct Observation or observed by higher instance.
+     * \param   p_handle     Set to the handle of the registration to
+     *                       remove it using unobserveVal(). Can be NULL.
+     *
+     * \return  returns true if the value is observed.
+     */
+    int16_t observeVal( DeviceDataObserver* p_obs, void* p_param,
+            const DeviceDataFilter& filter, bool direct = true,
+            t_obsHandle* p_handle = NULL );
+
+    /**
+     * \brief   Observe the actual value with a minimum interval.
+     *
+     *          The observer is notified at most once per interval. Changes
+     *          within the interval are coalesced and only the latest value
+     *          is delivered using DeviceDataObserver::notifyCoalesced()
+     *          together with the number of changes that were dropped. The
+     *          interval is rounded up to the resolution of the timer.
+     *
+     * \param   pf_obs       Observer.
+     * \param   p_param      Additional parameter that will given as
+     *                       parameter to the callback function.
+     * \param   minInterval  Minimum interval between two notifications.
+     * \param   filter       Filter of the observer.
+     * \param   direct       Direct Observation or observed by higher instance.
+     * \param   p_handle     Set to the handle of the registration to
+     *                       remove it using unobserveVal(). Can be NULL.
+     *
+     * \return  returns true if the value is observed.
+     */
+    int16_t observeVal( DeviceDataObserver* p_obs, void* p_param,
+            std::chrono::milliseconds minInterval,
+            const DeviceDataFilter& filter = DeviceDataFilter(),
+            bool direct = true, t_obsHandle* p_handle = NULL );
+
+    /**
+     * \brief   Stop an observation.
+     *
+     *          The observer is not notified anymore once the function
+     *          returned, except for a notification that was already being
+     *          delivered. When the last observer was removed the native
+     *          observation is cancelled as well.
+     *
+     * \param   handle  Handle returned when the observer was registered.
+     *
+     * \return  0 on success or -1 if the handle is unknown.
+     */
+    int16_t unobserveVal( t_obsHandle handle );
+
+    /**
+     * \brief   Stop all observations of an observer.
+     *
+     * \param   p_obs   Observer.
+     * \param   p_param Parameter the observer was registered with.
+     *
+     * \return  Number of removed registrations.
+     */
+    size_t unobserveVal( DeviceDataObserver* p_obs, void* p_param );
+
+    /**
+     * \brief   Set the timer used to rate limit notifications.
+     *
+     *          The timer is shared by all the device data elements. It
+     *          must be set before any observer with a minimum interval
+     *          is registered.
+     *
+     * \param   p_timer Timer to use.
+     */
+    static void setTimer( DeviceDataTimer* p_timer );
+
+    /**
+     * \brief   Get the timer used to rate limit notifications.
+     *
+     *          A default timer is created if none was set.
+     *
+     * \return  The timer.
+     */
+    static DeviceDataTimer* getTimer( void );
+
+    /**
+     * \brief   Set the filter of the device data element.
+     *
+     *          Changed values that do not pass the filter update the
+     *          actual value but are not reported to any observer. The
+     *          filter shall be set before the value is observed.
+     *
+     * \param   filter  Filter to use.
+     */
+    void setFilter( const DeviceDataFilter& filter ) {
+        m_filter = filter;
+    }
+
+    /**
+     * \brief   Get the filter of the device data element.
+     *
+     * \return  The filter.
+     */
+    const DeviceDataFilter& getFilter( void ) const {
+        return m_filter;
+    }
+
+    /**
+     * \brief   Set the dispatcher to deliver notifications.
+     *
+     *          If a dispatcher is set, changed values are queued to the
+     *          dispatcher and the observers are notified from the dispatcher
+     *          threads. Otherwise the observers are notified directly from
+     *          the thread reporting the change.
+     *
+     * \param   p_disp  Dispatcher to use or NULL to notify directly.
+     */
+    void setDispatcher( DeviceDataDispatcher* p_disp ) {
+        mp_dispatcher = p_disp;
+    }
+
+    /**
+     * \brief   Get the dispatcher to deliver notifications.
+     *
+     * \return  The dispatcher or NULL if observers are notified directly.
+     */
+    DeviceDataDispatcher* getDispatcher( void ) const {
+        return mp_dispatcher;
+    }
+
+    /**
+     * \brief   Wait for the notifications queued to the dispatcher.
+     *
+     *          Backends call this function first in their destructor, so
+     *          the observers are never notified about an element that is
+     *          partly destroyed. Owners may call it before deleting an
+     *          element as well.
+     */
+    void shutdown( void );
+
+    /**
+     * \brief   Set the history of the device data element.
+     *
+     *          Every changed value is added to the history including the
+     *          values that did not pass the filter of the element.
+     *
+     * \param   p_hist  History to use or NULL to keep no history.
+     */
+    void setHistory( DeviceDataHistory* p_hist ) {
+        mp_history = p_hist;
+    }
+
+    /**
+     * \brief   Get the history of the device data element.
+     *
+     * \return  The history or NULL if no history is kept.
+     */
+    DeviceDataHistory* getHistory( void ) const {
+        return mp_history;
+    }
+
+    /**
+     * \brief   Set the log to record the values to.
+     *
+     *          Every changed value is appended to the log like it is
+     *          added to the history.
+     *
+     * \param   p_log   Log to use or NULL to record nothing.
+     * \param   handle  Handle identifying the element within the log.
+     */
+    void setLog( DeviceDataLog* p_log, uint32_t handle ) {
+        m_logHandle = handle;
+        mp_log = p_log;
+    }
+
+    /**
+     * \brief   Get the log the values are recorded to.
+     *
+     * \return  The log or NULL if no values are recorded.
+     */
+    DeviceDataLog* getLog( void ) const {
+        return mp_log;
+    }
+
+    /**
+     * \brief   Get the actual values of several device data elements.
+     *
+     *          Instead of reading each element on its own the elements
+     *          are grouped by their backends (e.g. all LWM2M resources of
+     *          the same object instance) and each group is read using a
+     *          single native request where the backend supports it.
+     *
+     * \param   data    Device data elements to read.
+     * \param   vals    Filled with the actual values of the elements in the
+     *                  same order as data. Elements that could not be read
+     *                  are set to NULL.
+     *
+     * \return  0 if all values were read or -1 if at least one failed.
+     */
+    static int16_t getVals( const std::vector<DeviceData*>& data,
+            std::vector<const DeviceDataValue*>& vals );
+
+    /**
+     * \brief   Set the values of several device data elements.
+     *
+     *          The elements are grouped by their backends like for
+     *          getVals() and each group is written using a single native
+     *          request where the backend supports it (e.g. a write of
+     *          several resources of the same LWM2M object instance). The
+     *          observers of every element written are notified afterwards.
+     *
+     * \param   data    Device data elements to write.
+     * \param   vals    Values to write in the same order as data.
+     *
+     * \return  0 if all values were written or -1 if at least one failed.
+     */
+    static int16_t setVals( const std::vector<DeviceData*>& data,
+            const std::vector<const DeviceDataValue*>& vals );
 
 protected:
 
@@ -229,8 +701,125 @@ protected:
      */
     void valueChanged( const DeviceDataValue* val );
 
+    /**
+     * \brief    Indicates that the stored value was changed in place.
+     *
+     *             Sub classes can update the stored value returned by
+     *             getValStorage() directly instead of providing a new value
+     *             that is copied. Afterwards this function shall be called.
+     */
+    void valueChanged( void );
+
+    /**
+     * \brief    Get the stored value for an update in place.
+     *
+     *             The value can be updated directly e.g. from the data of
+     *             a notification. The update shall hold the lock returned
+     *             by lockValStorage() and valueChanged() shall be called
+     *             afterwards, without the lock.
+     *
+     * \return     The stored value.
+     */
+    DeviceDataValue* getValStorage( void ) {
+        return &m_val;
+    }
+
+    /**
+     * \brief    Lock the stored value for an update in place.
+     *
+     * \return     Lock serializing the update with other updates.
+     */
+    std::unique_lock< std::mutex > lockValStorage( void ) {
+        return std::unique_lock< std::mutex >( m_valMutex );
+    }
+
 private:
 
+    /**
+     * \brief   Register an observer.
+     *
+     * \param   pf_obs       Observer.
+     * \param   p_param      Parameter of the observer.
+     * \param   p_filter     Filter of the observer or NULL.
+     * \param   p_limit      Rate limit of the observer or NULL.
+     * \param   direct       Direct Observation or observed by higher instance.
+     * \param   p_handle     Set to the handle of the registration or NULL.
+     *
+     * \return  0 if the value is observed.
+     */
+    int16_t observe( DeviceDataObserver* p_obs, void* p_param,
+            const std::shared_ptr<DeviceDataFilter>& p_filter,
+            const std::shared_ptr<DeviceDataRateLimit>& p_limit, bool direct,
+            t_obsHandle* p_handle );
+
+    /**
+     * \brief   Notify all the observers about a changed value.
+     *
+     * \param   val     The changed value.
+     */
+    void notifyObservers( const DeviceDataValue* val );
+
+    /**
+     * \brief   Deliver a notification queued to the dispatcher.
+     *
+     * \param   val     The changed value.
+     */
+    void dispatched( const DeviceDataValue* val ) {
+        notifyObservers( val );
+        m_dispatchPending--;
+    }
+
+#if defined(DEVICEDATA_METRICS)
+    /**
+     * \brief   Get the scope the metrics of the element are counted to.
+     *
+     * \return  Handle of the scope.
+     */
+    DeviceDataMetrics::t_scope metricsScope( void ) {
+        DeviceDataMetrics::t_scope scope = m_metrics.m_scope;
+
+        /* the backend is not known before the element was constructed */
+        if( scope == DeviceDataMetrics::SCOPE_UNSET )
+        {
+            scope = DeviceDataMetrics::getScope( getBackend(), "" );
+            m_metrics.m_scope = scope;
+        }
+        return scope;
+    }
+#endif /* #if defined(DEVICEDATA_METRICS) */
+
+    /**
+     * \brief   Check if the cached value can be used.
+     *
+     * \param   maxAge  Maximum age of the cached value in ms.
+     *
+     * \return  true if the cached value is valid and not too old.
+     */
+    bool cacheValid( uint32_t maxAge ) const;
+
+    /**
+     * \brief   Store a value read or written and mark it as just updated.
+     *
+     * \param   val     Value of the type of the element.
+     */
+    void storeVal( DeviceDataValue val );
+
+    /**
+     * \brief   Report a changed value to the history, the log and the
+     *          observers.
+     *
+     * \param   val     Changed value.
+     */
+    void valueReport( const DeviceDataValue& val );
+
+    /**
+     * \brief   Mark the actual value as just updated.
+     */
+    void cacheUpdated( void ) {
+        m_valTime = std::chrono::steady_clock::now();
+        m_valCached = true;
+    }
+
     /**
      * \brief   Native read function to get the device data value.
      *
@@ -266,17 +855,130 @@ private:
      *          description and the actual protocol dependent implementation.
      *          Each device type has to implement this function accordingly.
      *
+     *          The function is called for the first observer. It is called
+     *          again with direct set if the first direct observer joins an
+     *          observation that was started by a higher instance.
+     *
      * \param   direct  Direct Observation or observed by higher instance.
      *
      * \return  0 on success.
      */
     virtual int8_t observeValNative( bool direct = true ) = 0;
 
+    /**
+     * \brief   Native function to stop observing the device data value.
+     *
+     *          Called when the last observer was removed. Backends shall
+     *          override this function to cancel what observeValNative()
+     *          started. The default implementation does nothing.
+     *
+     * \return  0 on success.
+     */
+    virtual int8_t unobserveValNative( void ) {
+        return 0;
+    }
+
+    /**
+     * \brief   Native asynchronous read function.
+     *
+     *          Backends supporting asynchronous accesses shall override this
+     *          function. The default implementation calls getValNative()
+     *          and the completion handler directly.
+     *
+     * \param   val     Value to store the result to. It remains valid until
+     *                  the completion handler was called.
+     * \param   cb      Completion handler to call with the result.
+     *
+     * \return  0 if the request was issued.
+     */
+    virtual int16_t getValNativeAsync( DeviceDataValue* val, const t_complete& cb ) {
+        cb( getValNative( val ), val );
+        return 0;
+    }
+
+    /**
+     * \brief   Native asynchronous write function.
+     *
+     *          Backends supporting asynchronous accesses shall override this
+     *          function. The default implementation calls setValNative()
+     *          and the completion handler directly.
+     *
+     * \param   val     Value to write. It remains valid until the
+     *                  completion handler was called.
+     * \param   cb      Completion handler to call with the result.
+     *
+     * \return  0 if the request was issued.
+     */
+    virtual int16_t setValNativeAsync( const DeviceDataValue* val, const t_complete& cb ) {
+        cb( setValNative( val ), val );
+        return 0;
+    }
+
+    /**
+     * \brief   Check if an element can be accessed together with this one.
+     *
+     *          Backends that are able to access several elements using a
+     *          single request shall return true for all the elements that
+     *          can be handled by the same call to getValsNative() and
+     *          setValsNative().
+     *
+     * \param   p_data  Element to check.
+     *
+     * \return  true if both elements can be accessed within the same request.
+     */
+    virtual bool batchCompatible( const DeviceData* ) const {
+        return false;
+    }
+
+    /**
+     * \brief   Native read function to get several device data values.
+     *
+     *          The elements handed over were grouped using batchCompatible()
+     *          of this element which is always the first of the group. The
+     *          default implementation reads the elements one by one.
+     *
+     * \param   data    Elements to read.
+     * \param   vals    Values to store the results of the elements to.
+     * \param   ret     Result of getValNative() for each of the elements.
+     */
+    virtual void getValsNative( const std::vector<DeviceData*>& data,
+            const std::vector<DeviceDataValue*>& vals,
+            std::vector<int16_t>& ret );
+
+    /**
+     * \brief   Native write function to set several device data values.
+     *
+     *          The elements handed over were grouped using batchCompatible()
+     *          of this element which is always the first of the group. The
+     *          default implementation writes the elements one by one.
+     *
+     * \param   data    Elements to write.
+     * \param   vals    Values to write to the elements.
+     * \param   ret     Result of setValNative() for each of the elements.
+     */
+    virtual void setValsNative( const std::vector<DeviceData*>& data,
+            const std::vector<const DeviceDataValue*>& vals,
+            std::vector<int16_t>& ret );
+
+    /**
+     * \brief   Read several device data elements and report the values.
+     *
+     *          Used by the poller to read the elements polled within the
+     *          same tick. The elements are grouped like for getVals() but
+     *          the cache is bypassed and every value read is reported
+     *          using valueChanged().
+     *
+     * \param   data    Elements to read.
+     *
+     * \return  0 if all values were read or -1 if at least one failed.
+     */
+    static int16_t pollVals( const std::vector<DeviceData*>& data );
+
 
 protected:
 
     /** value is observed */
-    bool m_observed;
+    std::atomic<bool> m_observed;
 
 private:
 
@@ -295,18 +997,97 @@ private:
     /** defines if the value is observable */
     bool m_observable;
 
+    /** defines if the element is online */
+    std::atomic<bool> m_online;
+
     /** The actual value */
     DeviceDataValue m_val;
 
+    /** type of the value, it does not change while the value is updated */
+    DeviceDataValue::e_type m_valType;
+
+    /** the actual value is valid and can be used as cache */
+    bool m_valCached;
+
+    /** time of the last update of the actual value */
+    std::chrono::steady_clock::time_point m_valTime;
+
+    /** default maximum age of the cached value in ms */
+    uint32_t m_maxAge;
+
+    /** number of reads served from the cache */
+    std::atomic<uint32_t> m_cacheHits;
+
+    /** number of reads that required a native read */
+    std::atomic<uint32_t> m_cacheMisses;
+
+    /** number of reads served while the value is observed */
+    std::atomic<uint32_t> m_observedReads;
+
     struct s_obs{
         /** observer */
         DeviceDataObserver* p_obs;
         /** parameter */
         void* p_param;
+        /** filter of the observer or NULL */
+        std::shared_ptr<DeviceDataFilter> p_filter;
+        /** rate limit of the observer or NULL */
+        std::shared_ptr<DeviceDataRateLimit> p_limit;
+        /** registration is active */
+        std::shared_ptr< std::atomic<bool> > p_active;
+        /** direct observation was requested */
+        bool direct;
     };
 
-    /** vector including all the registered observer */
-    std::vector< s_obs > m_obs;
+    /** filter of the notifications */
+    DeviceDataFilter m_filter;
+
+    /** list including all the registered observer */
+    DeviceDataObserverList< s_obs > m_obs;
+
+    /** active registrations by their handles */
+    std::unordered_map< t_obsHandle, s_obs > m_obsReg;
+
+    /** number of removed registrations still within the list */
+    size_t m_obsRemoved;
+
+    /** number of registrations requesting a direct observation */
+    size_t m_obsDirect;
+
+    /** last handle assigned */
+    t_obsHandle m_obsHandle;
+
+    /** protects the registrations of the observers */
+    std::mutex m_obsMutex;
+
+    /** serializes starting and stopping the native observation */
+    std::mutex m_nativeMutex;
+
+    /** serializes the updates of the stored value */
+    std::mutex m_valMutex;
+
+    /** dispatcher to deliver the notifications */
+    DeviceDataDispatcher* mp_dispatcher;
+
+    /** number of notifications queued to the dispatcher */
+    std::atomic<uint32_t> m_dispatchPending;
+
+    /** history of the values */
+    DeviceDataHistory* mp_history;
+
+    /** log to record the values to */
+    DeviceDataLog* mp_log;
+
+    /** handle of the element within the log */
+    uint32_t m_logHandle;
+
+    /** number of poller registrations of the element */
+    std::atomic<uint32_t> m_polled;
+
+#if defined(DEVICEDATA_METRICS)
+    /** scope the metrics are counted to */
+    DeviceDataMetrics::Scope m_metrics;
+#endif /* #if defined(DEVICEDATA_METRICS) */
 };
 
 #endif /* #ifndef __DEVICEDATA_H__ */
@@ -0,0 +1,279 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataDispatcher.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Dispatcher for device data notifications.
+ *
+ *          By default observers are notified from the thread that reported
+ *          the changed value. A dispatcher decouples both sides. The changed
+ *          values are put into a bounded lock-free queue and delivered to the
+ *          observers by the dispatcher threads.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include "DeviceDataDispatcher.h"
+#include "DeviceData.h"
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** maximum time a dispatcher thread sleeps before checking the queue in ms */
+#define DEVICEDATADISPATCHER_IDLE_MS            10
+
+
+/*
+ * --- Methods Definition ----------------------------------------------------- *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* DeviceDataDispatcher()
+*/
+DeviceDataDispatcher::DeviceDataDispatcher( uint32_t size, uint16_t numThreads )
+    : m_head( 0 )
+    , m_tail( 0 )
+    , m_sleeping( 0 )
+    , m_stop( false )
+    , m_maxDepth( 0 )
+    , m_enqueued( 0 )
+    , m_delivered( 0 )
+    , m_dropped( 0 )
+    , m_latencySum( 0 )
+    , m_latencyMax( 0 )
+{
+    /* the size must be a power of two */
+    size_t num = 2;
+    while( num < size )
+        num <<= 1;
+
+    mp_slots = new s_slot[num];
+    m_mask = num - 1;
+    for( size_t i = 0; i < num; i++ )
+        mp_slots[i].seq.store( i, std::memory_order_relaxed );
+
+    if( numThreads == 0 )
+        numThreads = 1;
+
+    /* start the dispatcher threads */
+    for( uint16_t i = 0; i < numThreads; i++ )
+        m_threads.push_back( std::thread( &DeviceDataDispatcher::run, this ) );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* ~DeviceDataDispatcher()
+*/
+DeviceDataDispatcher::~DeviceDataDispatcher( void )
+{
+    m_stop = true;
+    m_cond.notify_all();
+
+    /* the threads deliver the remaining notifications before they stop */
+    for( size_t i = 0; i < m_threads.size(); i++ )
+        m_threads[i].join();
+
+    delete[] mp_slots;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* push()
+*/
+int16_t DeviceDataDispatcher::push( DeviceData* p_data, const DeviceDataValue& val )
+{
+    s_slot* p_slot;
+    size_t pos = m_head.load( std::memory_order_relaxed );
+
+    /* reserve a slot */
+    while( true )
+    {
+        p_slot = &mp_slots[pos & m_mask];
+        size_t seq = p_slot->seq.load( std::memory_order_acquire );
+        intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+
+        if( diff == 0 )
+        {
+            if( m_head.compare_exchange_weak( pos, pos + 1,
+                    std::memory_order_relaxed ) )
+                break;
+        }
+        else if( diff < 0 )
+        {
+            /* queue is full */
+            m_dropped.fetch_add( 1, std::memory_order_relaxed );
+            return -1;
+        }
+        else
+            pos = m_head.load( std::memory_order_relaxed );
+    }
+
+    p_slot->p_data = p_data;
+    p_slot->val = val;
+    p_slot->time = std::chrono::steady_clock::now();
+    p_slot->seq.store( pos + 1, std::memory_order_release );
+
+    /* update statistics */
+    m_enqueued.fetch_add( 1, std::memory_order_relaxed );
+    uint32_t depth = (uint32_t)(pos + 1 - m_tail.load( std::memory_order_relaxed ));
+    uint32_t maxDepth = m_maxDepth.load( std::memory_order_relaxed );
+    while( (depth > maxDepth) &&
+        !m_maxDepth.compare_exchange_weak( maxDepth, depth, std::memory_order_relaxed ) );
+
+    /* wake up a dispatcher thread if required */
+    if( m_sleeping.load() > 0 )
+        m_cond.notify_one();
+
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* pop()
+*/
+bool DeviceDataDispatcher::pop( DeviceData*& p_data, DeviceDataValue& val,
+        std::chrono::steady_clock::time_point& time )
+{
+    s_slot* p_slot;
+    size_t pos = m_tail.load( std::memory_order_relaxed );
+
+    /* search for a filled slot */
+    while( true )
+    {
+        p_slot = &mp_slots[pos & m_mask];
+        size_t seq = p_slot->seq.load( std::memory_order_acquire );
+        intptr_t diff = (intptr_t)seq - (intptr_t)(pos + 1);
+
+        if( diff == 0 )
+        {
+            if( m_tail.compare_exchange_weak( pos, pos + 1,
+                    std::memory_order_relaxed ) )
+                break;
+        }
+        else if( diff < 0 )
+            /* queue is empty */
+            return false;
+        else
+            pos = m_tail.load( std::memory_order_relaxed );
+    }
+
+    p_data = p_slot->p_data;
+    val = p_slot->val;
+    time = p_slot->time;
+    p_slot->seq.store( pos + m_mask + 1, std::memory_order_release );
+
+    return true;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* getStats()
+*/
+void DeviceDataDispatcher::getStats( s_stats& stats ) const
+{
+    size_t head = m_head.load( std::memory_order_relaxed );
+    size_t tail = m_tail.load( std::memory_order_relaxed );
+
+    stats.depth = (head > tail) ? (uint32_t)(head - tail) : 0;
+    stats.maxDepth = m_maxDepth.load( std::memory_order_relaxed );
+    stats.enqueued = m_enqueued.load( std::memory_order_relaxed );
+    stats.delivered = m_delivered.load( std::memory_order_relaxed );
+    stats.dropped = m_dropped.load( std::memory_order_relaxed );
+    stats.latencySum = m_latencySum.load( std::memory_order_relaxed );
+    stats.latencyMax = m_latencyMax.load( std::memory_order_relaxed );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* resetStats()
+*/
+void DeviceDataDispatcher::resetStats( void )
+{
+    m_maxDepth = 0;
+    m_enqueued = 0;
+    m_delivered = 0;
+    m_dropped = 0;
+    m_latencySum = 0;
+    m_latencyMax = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* run()
+*/
+void DeviceDataDispatcher::run( void )
+{
+    DeviceData* p_data;
+    DeviceDataValue val( DeviceDataValue::TYPE_INTEGER );
+    std::chrono::steady_clock::time_point time;
+
+    while( true )
+    {
+        if( pop( p_data, val, time ) )
+        {
+            /* deliver the notification to the observers */
+            p_data->dispatched( &val );
+
+            uint64_t latency = std::chrono::duration_cast< std::chrono::microseconds >(
+                    std::chrono::steady_clock::now() - time ).count();
+            m_latencySum.fetch_add( latency, std::memory_order_relaxed );
+            uint64_t latencyMax = m_latencyMax.load( std::memory_order_relaxed );
+            while( (latency > latencyMax) &&
+                !m_latencyMax.compare_exchange_weak( latencyMax, latency,
+                        std::memory_order_relaxed ) );
+            m_delivered.fetch_add( 1, std::memory_order_relaxed );
+            continue;
+        }
+
+        if( m_stop )
+            /* stopped and nothing left to deliver */
+            return;
+
+        /* nothing to do, so wait for new notifications */
+        m_sleeping++;
+        {
+            std::unique_lock< std::mutex > lock( m_mutex );
+            if( (m_stop == false) && (m_head.load() == m_tail.load()) )
+                m_cond.wait_for( lock, std::chrono::milliseconds(
+                        DEVICEDATADISPATCHER_IDLE_MS ) );
+        }
+        m_sleeping--;
+    }
+}
@@ -0,0 +1,222 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataDispatcher.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Dispatcher for device data notifications.
+ *
+ *          By default observers are notified from the thread that reported
+ *          the changed value. A dispatcher decouples both sides. The changed
+ *          values are put into a bounded lock-free queue and delivered to the
+ *          observers by the dispatcher threads.
+ */
+
+
+#ifndef __DEVICEDATADISPATCHER_H__
+#define __DEVICEDATADISPATCHER_H__
+#ifndef __DECL_DEVICEDATADISPATCHER_H__
+#define __DECL_DEVICEDATADISPATCHER_H__ extern
+#endif /* #ifndef __DECL_DEVICEDATADISPATCHER_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <vector>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include "DeviceDataValue.h"
+
+/*
+ * --- Forward Declaration ----------------------------------------------------- *
+ */
+class DeviceData;
+
+/*
+ * --- Class Definition ----------------------------------------------------- *
+ */
+
+/**
+ * \brief   DeviceDataDispatcher Class.
+ *
+ *          The queue of the dispatcher supports several producers and
+ *          consumers. If several dispatcher threads are used the order of the
+ *          notifications of a single device data element is not guaranteed.
+ */
+class DeviceDataDispatcher
+{
+
+public:
+
+    /** statistics of the dispatcher */
+    struct s_stats
+    {
+        /** actual number of queued notifications */
+        uint32_t depth;
+        /** maximum number of queued notifications */
+        uint32_t maxDepth;
+        /** number of queued notifications */
+        uint64_t enqueued;
+        /** number of delivered notifications */
+        uint64_t delivered;
+        /** number of notifications dropped since the queue was full */
+        uint64_t dropped;
+        /** sum of the enqueue-to-delivery latencies in us */
+        uint64_t latencySum;
+        /** maximum enqueue-to-delivery latency in us */
+        uint64_t latencyMax;
+    };
+
+    /**
+     * \brief   Constructor to create a dispatcher.
+     *
+     * \param   size        Size of the queue. It is rounded up to the
+     *                      next power of two.
+     * \param   numThreads  Number of dispatcher threads.
+     */
+    DeviceDataDispatcher( uint32_t size, uint16_t numThreads = 1 );
+
+    /**
+     * \brief   Default Destructor of the dispatcher.
+     *
+     *          Queued notifications are delivered before the threads
+     *          are stopped.
+     */
+    virtual ~DeviceDataDispatcher( void );
+
+    /**
+     * \brief   Queue a notification.
+     *
+     * \param   p_data  Device data element the value belongs to.
+     * \param   val     The changed value.
+     *
+     * \return  0 on success or -1 if the queue is full.
+     */
+    int16_t push( DeviceData* p_data, const DeviceDataValue& val );
+
+    /**
+     * \brief   Get the statistics of the dispatcher.
+     *
+     * \param   stats   Statistics to fill.
+     */
+    void getStats( s_stats& stats ) const;
+
+    /**
+     * \brief   Reset the statistics of the dispatcher.
+     */
+    void resetStats( void );
+
+private:
+
+    /** element of the queue */
+    struct s_slot
+    {
+        s_slot( void )
+            : seq( 0 )
+            , p_data( NULL )
+            , val( DeviceDataValue::TYPE_INTEGER ) {};
+
+        /** sequence number of the slot */
+        std::atomic<size_t> seq;
+        /** device data element */
+        DeviceData* p_data;
+        /** the changed value */
+        DeviceDataValue val;
+        /** time the notification was queued */
+        std::chrono::steady_clock::time_point time;
+    };
+
+    /**
+     * \brief   Take a notification from the queue.
+     *
+     * \param   p_data  Device data element the value belongs to.
+     * \param   val     The changed value.
+     * \param   time    Time the notification was queued.
+     *
+     * \return  true if a notification was available.
+     */
+    bool pop( DeviceData*& p_data, DeviceDataValue& val,
+            std::chrono::steady_clock::time_point& time );
+
+    /**
+     * \brief   Dispatcher thread function.
+     */
+    void run( void );
+
+private:
+
+    /** the queue */
+    s_slot* mp_slots;
+
+    /** mask to get the slot index */
+    size_t m_mask;
+
+    /** enqueue position */
+    std::atomic<size_t> m_head;
+
+    /** dequeue position */
+    std::atomic<size_t> m_tail;
+
+    /** dispatcher threads */
+    std::vector< std::thread > m_threads;
+
+    /** number of sleeping dispatcher threads */
+    std::atomic<uint32_t> m_sleeping;
+
+    /** lock for the sleeping threads */
+    std::mutex m_mutex;
+
+    /** signals new notifications to sleeping threads */
+    std::condition_variable m_cond;
+
+    /** dispatcher is stopping */
+    std::atomic<bool> m_stop;
+
+    /** statistics */
+    std::atomic<uint32_t> m_maxDepth;
+    std::atomic<uint64_t> m_enqueued;
+    std::atomic<uint64_t> m_delivered;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<uint64_t> m_latencySum;
+    std::atomic<uint64_t> m_latencyMax;
+};
+
+#endif /* #ifndef __DEVICEDATADISPATCHER_H__ */
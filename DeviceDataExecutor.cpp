@@ -0,0 +1,142 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataExecutor.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Executor for asynchronous device data accesses.
+ *
+ *          The executor runs device data accesses on a set of worker
+ *          threads. This way backends providing only blocking accesses
+ *          can be used asynchronously without blocking the caller.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include "DeviceDataExecutor.h"
+#include <utility>
+
+
+/*
+ * --- Methods Definition ----------------------------------------------------- *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* DeviceDataExecutor()
+*/
+DeviceDataExecutor::DeviceDataExecutor( uint16_t numThreads )
+    : m_stop( false )
+{
+    if( numThreads == 0 )
+        numThreads = 1;
+
+    /* start the worker threads */
+    for( uint16_t i = 0; i < numThreads; i++ )
+        m_threads.push_back( std::thread( &DeviceDataExecutor::run, this ) );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* ~DeviceDataExecutor()
+*/
+DeviceDataExecutor::~DeviceDataExecutor( void )
+{
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        m_stop = true;
+    }
+    m_cond.notify_all();
+
+    /* wait for the workers to finish the remaining tasks */
+    for( size_t i = 0; i < m_threads.size(); i++ )
+        m_threads[i].join();
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* post()
+*/
+int16_t DeviceDataExecutor::post( const t_task& task )
+{
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        if( m_stop )
+            return -1;
+        m_tasks.push_back( task );
+    }
+    m_cond.notify_one();
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* getPending()
+*/
+size_t DeviceDataExecutor::getPending( void )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+    return m_tasks.size();
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* run()
+*/
+void DeviceDataExecutor::run( void )
+{
+    while( true )
+    {
+        t_task task;
+
+        {
+            std::unique_lock< std::mutex > lock( m_mutex );
+            while( (m_stop == false) && m_tasks.empty() )
+                m_cond.wait( lock );
+
+            if( m_tasks.empty() )
+                /* stopped and nothing left to do */
+                return;
+
+            task = std::move( m_tasks.front() );
+            m_tasks.pop_front();
+        }
+
+        /* run the task outside of the lock */
+        task();
+    }
+}
@@ -0,0 +1,140 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataExecutor.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Executor for asynchronous device data accesses.
+ *
+ *          The executor runs device data accesses on a set of worker
+ *          threads. This way backends providing only blocking accesses
+ *          can be used asynchronously without blocking the caller.
+ */
+
+
+#ifndef __DEVICEDATAEXECUTOR_H__
+#define __DEVICEDATAEXECUTOR_H__
+#ifndef __DECL_DEVICEDATAEXECUTOR_H__
+#define __DECL_DEVICEDATAEXECUTOR_H__ extern
+#endif /* #ifndef __DECL_DEVICEDATAEXECUTOR_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+/*
+ * --- Class Definition ----------------------------------------------------- *
+ */
+
+/**
+ * \brief   DeviceDataExecutor Class.
+ *
+ *          The executor holds a queue of tasks that are processed by
+ *          a fixed number of worker threads.
+ */
+class DeviceDataExecutor
+{
+
+public:
+
+    /** Task to execute */
+    typedef std::function< void( void ) > t_task;
+
+    /**
+     * \brief   Constructor to create an executor.
+     *
+     * \param   numThreads  Number of worker threads.
+     */
+    DeviceDataExecutor( uint16_t numThreads );
+
+    /**
+     * \brief   Default Destructor of the executor.
+     *
+     *          All the pending tasks are processed before the worker
+     *          threads are stopped.
+     */
+    virtual ~DeviceDataExecutor( void );
+
+    /**
+     * \brief   Add a task to the executor.
+     *
+     * \param   task    Task to execute.
+     *
+     * \return  0 on success or -1 if the executor is stopping.
+     */
+    int16_t post( const t_task& task );
+
+    /**
+     * \brief   Get the number of tasks not yet started.
+     *
+     * \return  Number of pending tasks.
+     */
+    size_t getPending( void );
+
+private:
+
+    /**
+     * \brief   Worker thread function.
+     */
+    void run( void );
+
+private:
+
+    /** worker threads */
+    std::vector< std::thread > m_threads;
+
+    /** pending tasks */
+    std::deque< t_task > m_tasks;
+
+    /** lock of the task queue */
+    std::mutex m_mutex;
+
+    /** signals new tasks */
+    std::condition_variable m_cond;
+
+    /** executor is stopping */
+    bool m_stop;
+};
+
+#endif /* #ifndef __DEVICEDATAEXECUTOR_H__ */
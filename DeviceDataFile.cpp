@@ -49,13 +49,36 @@
  * --- Includes ------------------------------------------------------------- *
  */
 #include "DeviceDataFile.h"
+#include "DeviceDataFileWatcher.h"
 #include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/uio.h>
 
 
 /*
  * --- Methods Definition ----------------------------------------------------- *
  */
 
+/*---------------------------------------------------------------------------*/
+/*
+* ~DeviceDataFile()
+*/
+DeviceDataFile::~DeviceDataFile( void )
+{
+    /* no more notifications from the watcher */
+    if( m_watched )
+        DeviceDataFileWatcher::getInstance()->remove( this );
+
+    /* deliver the queued notifications while the element is complete */
+    shutdown();
+
+    closePersistent();
+
+    /* delete file from system */
+    remove( getName().c_str() );
+}
+
 /*---------------------------------------------------------------------------*/
 /*
 * getValNative()
@@ -63,115 +86,183 @@
 int16_t DeviceDataFile::getValNative( DeviceDataValue* val )
 {
     int16_t ret = -1;
-    FILE* p_file = openFile();
+    std::string line;
 
-    /* Check for the file reference first */
-    if( (p_file != NULL) && (val != 0) )
+    if( val == 0 )
+        return -4;
+
+    if( m_fd >= 0 )
+        /* read the value line using the file kept open */
+        ret = readLine( line );
+    else
     {
-        char buf[DEVICEDATAVALUE_STRMAX];
+        FILE* p_file = openFile();
 
-        /* Seek to the value position which is the length of the description
-         * + its prefix + the newline at the end */
-        if( fseek( p_file, strlen(DEVICEDATAFILE_DESCR_PFX) + getDescr().length() + 1,
-                SEEK_SET ) == 0 )
+        /* Check for the file reference first */
+        if( p_file != NULL )
         {
+            char buf[DEVICEDATAFILE_LINE_CHUNK];
 
-            /* depending on the type read the value of the data */
-            if( fgets( buf, DEVICEDATAVALUE_STRMAX, p_file ) != NULL )
+            /* Seek to the value position which is the length of the description
+             * + its prefix + the newline at the end */
+            if( fseek( p_file, strlen(DEVICEDATAFILE_DESCR_PFX) + getDescr().length() + 1,
+                    SEEK_SET ) == 0 )
             {
-                /* Data was read successfully. now put it to the
-                 * according value buffer */
-                switch( val->getType() )
+                /* read the whole line since values are not limited in length */
+                while( fgets( buf, sizeof(buf), p_file ) != NULL )
                 {
-                    case DeviceDataValue::TYPE_INTEGER:
-                    {
-                        int32_t ibuf;
-                        sscanf( buf, "%d", &ibuf );
-                        ret = val->setVal( ibuf );
-                        break;
-                    }
-
-
-                    case DeviceDataValue::TYPE_FLOAT:
-                    {
-                        float fbuf;
-                        sscanf( buf, "%f", &fbuf );
-                        ret = val->setVal( fbuf );
-                        break;
-                    }
-
-                    case DeviceDataValue::TYPE_STRING:
-                        ret = val->setVal( buf );
-                        break;
-
-                    default:
-                        ret = -1;
+                    line.append( buf );
+                    if( line[line.length() - 1] == '\n' )
                         break;
                 }
+                ret = line.empty() ? -2 : 0;
             }
             else
-                ret = -2;
+                ret = -3;
+            fclose( p_file );
         }
         else
-            ret = -3;
-        fclose( p_file );
+            ret = -4;
     }
-    else
-        ret = -4;
-
-    return ret;
-}
-
-/*---------------------------------------------------------------------------*/
-/*
-* setValNative()
-*/
-int16_t DeviceDataFile::setValNative( const DeviceDataValue* val )
-{
-    int16_t ret = -1;
-    FILE* p_file = openFile( true );
 
-    /* Check for the file reference first */
-    if( (p_file != NULL) && (val != 0) )
+    /* depending on the type read the value of the data */
+    if( ret == 0 )
     {
-        /* Write the new data */
+        /* Data was read successfully. now put it to the
+         * according value buffer */
         switch( val->getType() )
         {
             case DeviceDataValue::TYPE_INTEGER:
-                fprintf( p_file, "%d\n", val->getVal().i32 );
-                ret = 0;
-                break;
-
+            case DeviceDataValue::TYPE_INTEGER64:
             case DeviceDataValue::TYPE_FLOAT:
-                fprintf( p_file, "%g\n", val->getVal().f );
-                ret = 0;
-                break;
-
+            case DeviceDataValue::TYPE_DOUBLE:
             case DeviceDataValue::TYPE_STRING:
-                fprintf( p_file, "%s\n", val->getVal().cStr );
-                ret = 0;
+                /* numbers are parsed by the value */
+                ret = val->setVal( line );
                 break;
 
             default:
                 ret = -1;
                 break;
         }
-        fclose( p_file );
     }
-    else
-        ret = -1;
 
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+/*
+* setValNative()
+*/
+int16_t DeviceDataFile::setValNative( const DeviceDataValue* val )
+{
+    char buf[DEVICEDATAVALUE_NUMSTRMAX];
+    const char* p_str = buf;
+    size_t len = 0;
+
+    if( val == 0 )
+        return -1;
+
+    /* create the new value line */
+    switch( val->getType() )
+    {
+        case DeviceDataValue::TYPE_INTEGER:
+        case DeviceDataValue::TYPE_INTEGER64:
+        case DeviceDataValue::TYPE_FLOAT:
+        case DeviceDataValue::TYPE_DOUBLE:
+            len = val->toChars( buf, sizeof(buf) );
+            break;
+
+        case DeviceDataValue::TYPE_STRING:
+            p_str = val->getStr();
+            len = val->getLen();
+            break;
+
+        default:
+            return -1;
+    }
+
+    if( m_fd >= 0 )
+        /* replace the value line of the file kept open */
+        return writeLine( p_str, len );
+
+    return writeFile( p_str, len );
+}
+
 /*---------------------------------------------------------------------------*/
 /*
 * observeValNative()
 */
 int8_t DeviceDataFile::observeValNative( bool direct )
 {
-    int8_t ret = 0;
-    return ret;
+    if( m_watched )
+        return 0;
+
+    m_ownChanges = 0;
+    if( DeviceDataFileWatcher::getInstance()->add( this ) != 0 )
+        return -1;
+    m_watched = true;
+
+    /* observed values are not read anymore, so start with the
+     * actual content of the file */
+    fileChanged();
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* unobserveValNative()
+*/
+int8_t DeviceDataFile::unobserveValNative( void )
+{
+    if( m_watched == false )
+        return 0;
+
+    DeviceDataFileWatcher::getInstance()->remove( this );
+    m_watched = false;
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* fileChanged()
+*/
+void DeviceDataFile::fileChanged( bool replaced )
+{
+    /* the element notified its own change already */
+    if( (replaced == false) && (m_ownChanges > 0) )
+    {
+        m_ownChanges--;
+        return;
+    }
+
+    DeviceDataValue val( getValType() );
+
+    /* a file kept open still refers to the replaced one. The new file
+     * takes over the descriptor so concurrent accesses stay valid. */
+    if( replaced && (m_fd >= 0) )
+    {
+        int fd = open( getName().c_str(), getWritable() ? O_RDWR : O_RDONLY );
+        if( fd >= 0 )
+        {
+            dup2( fd, m_fd );
+            close( fd );
+            m_valLen = (size_t)-1;
+        }
+    }
+
+    /* the file might be incomplete while it is written */
+    if( getValNative( &val ) != 0 )
+        return;
+
+    bool changed;
+    {
+        std::unique_lock< std::mutex > lock( lockValStorage() );
+        changed = (val != *getValStorage());
+    }
+
+    if( changed )
+        valueChanged( &val );
 }
 
 /*---------------------------------------------------------------------------*/
@@ -219,4 +310,129 @@ FILE* DeviceDataFile::openFile( bool wr, bool defaultVal )
     return p_ret;
 }
 
+/*---------------------------------------------------------------------------*/
+/*
+* openPersistent()
+*/
+void DeviceDataFile::openPersistent( void )
+{
+    /* the value line follows the description line */
+    m_valOffset = (off_t)(strlen(DEVICEDATAFILE_DESCR_PFX) + getDescr().length() + 1);
+    /* the length of the line is unknown, the first write truncates */
+    m_valLen = (size_t)-1;
+
+    m_fd = open( getName().c_str(), getWritable() ? O_RDWR : O_RDONLY );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* closePersistent()
+*/
+void DeviceDataFile::closePersistent( void )
+{
+    if( m_fd >= 0 )
+        close( m_fd );
+    m_fd = -1;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* readLine()
+*/
+int16_t DeviceDataFile::readLine( std::string& line )
+{
+    char buf[DEVICEDATAFILE_LINE_CHUNK];
+    off_t offset = m_valOffset;
+
+    /* read the whole line since values are not limited in length */
+    while( true )
+    {
+        ssize_t len = pread( m_fd, buf, sizeof(buf), offset );
+
+        if( len < 0 )
+            return -3;
+        if( len == 0 )
+            break;
+
+        const char* p_end = (const char*)memchr( buf, '\n', len );
+        if( p_end != NULL )
+        {
+            line.append( buf, p_end - buf );
+            break;
+        }
+
+        line.append( buf, len );
+        offset += len;
+    }
+
+    return line.empty() ? -2 : 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* writeLine()
+*/
+int16_t DeviceDataFile::writeLine( const char* p_val, size_t len )
+{
+    struct iovec iov[2];
+
+    /* value and line feed are written using a single call */
+    iov[0].iov_base = (void*)p_val;
+    iov[0].iov_len = len;
+    iov[1].iov_base = (void*)"\n";
+    iov[1].iov_len = 1;
 
+    if( pwritev( m_fd, iov, 2, m_valOffset ) != (ssize_t)(len + 1) )
+        return -1;
+
+    /* remove the rest of a longer value written before */
+    if( (len + 1) < m_valLen )
+    {
+        if( ftruncate( m_fd, m_valOffset + len + 1 ) != 0 )
+            return -1;
+    }
+    m_valLen = len + 1;
+
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* writeFile()
+*/
+int16_t DeviceDataFile::writeFile( const char* p_val, size_t len )
+{
+    /* the file is written in place so links, mode and owner persist */
+    int fd = open( getName().c_str(), O_WRONLY | O_CREAT, 0666 );
+    if( fd < 0 )
+        return -1;
+
+    /* Write the description and the new data with a single call */
+    struct iovec iov[5];
+    iov[0].iov_base = (void*)DEVICEDATAFILE_DESCR_PFX;
+    iov[0].iov_len = strlen(DEVICEDATAFILE_DESCR_PFX);
+    iov[1].iov_base = (void*)getDescr().c_str();
+    iov[1].iov_len = getDescr().length();
+    iov[2].iov_base = (void*)"\n";
+    iov[2].iov_len = 1;
+    iov[3].iov_base = (void*)p_val;
+    iov[3].iov_len = len;
+    iov[4].iov_base = (void*)"\n";
+    iov[4].iov_len = 1;
+    size_t total = iov[0].iov_len + iov[1].iov_len + 1 + len + 1;
+
+    /* a longer old content is cut off afterwards */
+    int16_t ret = 0;
+    if( (pwritev( fd, iov, 5, 0 ) != (ssize_t)total) ||
+            (ftruncate( fd, total ) != 0) )
+        ret = -1;
+
+    /* the watcher reports closing the file, which is skipped since the
+     * caller notifies the new value itself */
+    if( m_watched )
+        m_ownChanges++;
+    if( close( fd ) != 0 )
+        ret = -1;
+
+    return ret;
+}
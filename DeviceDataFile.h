@@ -55,7 +55,10 @@
 /*
  * --- Includes ------------------------------------------------------------- *
  */
+#include <atomic>
 #include <iostream>
+#include <string>
+#include <sys/types.h>
 #include "DeviceData.h"
 
 /*
@@ -65,6 +68,9 @@
 /** Prefix of the description line */
 #define DEVICEDATAFILE_DESCR_PFX            "# "
 
+/** Size of the chunks a value line is read with */
+#define DEVICEDATAFILE_LINE_CHUNK           64
+
 
 /*
  * --- Class Definition ----------------------------------------------------- *
@@ -79,6 +85,8 @@ class DeviceDataFile
         : public DeviceData
 {
 
+    friend class DeviceDataFileWatcher;
+
 public:
 
     /**
@@ -86,7 +94,12 @@ public:
      *
      */
     DeviceDataFile( void )
-        : DeviceData() {
+        : DeviceData()
+        , m_fd( -1 )
+        , m_valOffset( 0 )
+        , m_valLen( 0 )
+        , m_watched( false )
+        , m_ownChanges( 0 ) {
 
         /* open the file */
         FILE* p_file = openFile( true, true );
@@ -102,15 +115,26 @@ public:
      * \param   descr   Description of the device data element.
      * \param    type    Type of the data value.
      * \param    access    Access permissions.
+     * \param    persistent Keep the file open for the lifetime of the
+     *                      element and access the value line directly
+     *                      instead of opening the file on every access.
      */
     DeviceDataFile( std::string name, std::string descr, DeviceDataValue::e_type type,
-            int access )
-        : DeviceData( name, descr, type, access ) {
+            int access, bool persistent = false )
+        : DeviceData( name, descr, type, access )
+        , m_fd( -1 )
+        , m_valOffset( 0 )
+        , m_valLen( 0 )
+        , m_watched( false )
+        , m_ownChanges( 0 ) {
 
         /* open the file */
         FILE* p_file = openFile( true, true );
         if( p_file != NULL )
             fclose(p_file);
+
+        if( persistent )
+            openPersistent();
     };
 
     /**
@@ -119,10 +143,25 @@ public:
      *          Since this is a pure virtual class acting as an interface
      *          this destructor should never be called directly.
      */
-    virtual ~DeviceDataFile( void ) {
-        /* delete file from system */
-        remove( getName().c_str() );
-    };
+    virtual ~DeviceDataFile( void );
+
+    /**
+     * \brief   Check if the file is kept open.
+     *
+     * \return  true if the file is kept open.
+     */
+    bool getPersistent( void ) const {
+        return m_fd >= 0;
+    }
+
+    /**
+     * \brief   Get the name of the backend of the element.
+     *
+     * \return  The name of the backend.
+     */
+    virtual const char* getBackend( void ) const {
+        return "file";
+    }
 
 
 private:
@@ -162,12 +201,34 @@ private:
      *          description and the actual protocol dependent implementation.
      *          Each device type has to implement this function accordingly.
      *
+     *          The file is watched for changes by other processes.
+     *
      * \param   direct  Direct Observation or observed by higher instance.
      *
      * \return  0 on success.
      */
     virtual int8_t observeValNative( bool direct = true );
 
+    /**
+     * \brief   Native function to stop observing the device data value.
+     *
+     *          The file is not watched for changes anymore.
+     *
+     * \return  0 on success.
+     */
+    virtual int8_t unobserveValNative( void );
+
+    /**
+     * \brief    Read the file again after it was changed.
+     *
+     *             Observers are notified only if the value differs from
+     *             the actual one. Writes of the element itself are
+     *             skipped.
+     *
+     * \param    replaced   The file was replaced by another one.
+     */
+    void fileChanged( bool replaced = false );
+
     /**
      * \brief    Opens the internal file descriptor.
      *
@@ -178,8 +239,71 @@ private:
      */
     FILE* openFile( bool wr = false, bool defaultVal = false );
 
+    /**
+     * \brief    Open the file for the lifetime of the element.
+     *
+     *             The file must exist including the description line.
+     */
+    void openPersistent( void );
+
+    /**
+     * \brief    Close the file kept open.
+     */
+    void closePersistent( void );
+
+    /**
+     * \brief    Read the value line using the file kept open.
+     *
+     * \param    line       Returns the value line.
+     *
+     * \return     0 on success.
+     */
+    int16_t readLine( std::string& line );
+
+    /**
+     * \brief    Write the value line using the file kept open.
+     *
+     *             Only the value line is written. The file is truncated
+     *             if the new line is shorter than the old one.
+     *
+     * \param    p_val      Value as text without line feed.
+     * \param    len        Length of the value.
+     *
+     * \return     0 on success.
+     */
+    int16_t writeLine( const char* p_val, size_t len );
+
+    /**
+     * \brief    Write the file holding the new value.
+     *
+     *             The file is rewritten in place, so links, mode and owner
+     *             are kept. The watcher event of closing the file is
+     *             skipped.
+     *
+     * \param    p_val      Value as text without line feed.
+     * \param    len        Length of the value.
+     *
+     * \return     0 on success.
+     */
+    int16_t writeFile( const char* p_val, size_t len );
+
 private:
 
+    /** file descriptor kept open or -1 */
+    int m_fd;
+
+    /** offset of the value line within the file */
+    off_t m_valOffset;
+
+    /** length of the value line including the line feed */
+    size_t m_valLen;
+
+    /** the file is watched for changes */
+    std::atomic<bool> m_watched;
+
+    /** writes of the element not yet seen by the watcher */
+    std::atomic<uint32_t> m_ownChanges;
+
 };
 
 #endif /* #ifndef __DEVICEDATAFILE_H__ */
@@ -0,0 +1,282 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataFileWatcher.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Watcher of the files of observed file device data elements.
+ *
+ *          A single thread waits for changes of the files of all observed
+ *          file device data elements using inotify and lets the according
+ *          element read the changed file again.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <unistd.h>
+#include <poll.h>
+#include <errno.h>
+#include <sys/inotify.h>
+#include "DeviceDataFileWatcher.h"
+#include "DeviceDataFile.h"
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** events of the watched directories */
+#define DEVICEDATAFILEWATCHER_EVENTS        (IN_CLOSE_WRITE | IN_MOVED_TO)
+
+/** size of the event buffer */
+#define DEVICEDATAFILEWATCHER_BUF_SIZE      4096
+
+
+/*
+ * --- Local Variables ------------------------------------------------------ *
+ */
+
+/** the watcher */
+static DeviceDataFileWatcher* gp_watcher = NULL;
+
+/** protects the creation of the watcher */
+static std::mutex g_watcherMutex;
+
+
+/*
+ * --- Methods Definition ----------------------------------------------------- *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* getInstance()
+*/
+DeviceDataFileWatcher* DeviceDataFileWatcher::getInstance( void )
+{
+    std::lock_guard< std::mutex > lock( g_watcherMutex );
+    if( gp_watcher == NULL )
+        gp_watcher = new DeviceDataFileWatcher();
+    return gp_watcher;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* DeviceDataFileWatcher()
+*/
+DeviceDataFileWatcher::DeviceDataFileWatcher( void )
+    : m_fd( -1 )
+    , mp_notifying( NULL )
+{
+    m_fd = inotify_init1( IN_CLOEXEC );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* add()
+*/
+int16_t DeviceDataFileWatcher::add( DeviceDataFile* p_file )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+    std::string dir;
+    std::string file;
+
+    if( m_fd < 0 )
+        return -1;
+
+    split( p_file->getName(), dir, file );
+
+    /* the same directory always results in the same descriptor */
+    int wd = inotify_add_watch( m_fd, dir.c_str(), DEVICEDATAFILEWATCHER_EVENTS );
+    if( wd < 0 )
+        return -1;
+
+    s_dir& d = m_dirs[wd];
+    d.path = dir;
+    d.files.insert( std::make_pair( file, p_file ) );
+
+    /* start the thread with the first watch */
+    if( m_thread.joinable() == false )
+        m_thread = std::thread( &DeviceDataFileWatcher::run, this );
+
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* remove()
+*/
+void DeviceDataFileWatcher::remove( DeviceDataFile* p_file )
+{
+    std::unique_lock< std::mutex > lock( m_mutex );
+    std::map< int, s_dir >::iterator it;
+
+    /* wait for a running notification of the element to return */
+    if( std::this_thread::get_id() != m_thread.get_id() )
+    {
+        while( mp_notifying == p_file )
+            m_notified.wait( lock );
+    }
+
+    for( it = m_dirs.begin(); it != m_dirs.end(); ++it )
+    {
+        std::multimap< std::string, DeviceDataFile* >::iterator f;
+        for( f = it->second.files.begin(); f != it->second.files.end(); ++f )
+        {
+            if( f->second == p_file )
+                break;
+        }
+
+        if( f == it->second.files.end() )
+            continue;
+
+        it->second.files.erase( f );
+        if( it->second.files.empty() )
+        {
+            /* nothing left to watch within the directory */
+            inotify_rm_watch( m_fd, it->first );
+            m_dirs.erase( it );
+        }
+        return;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* run()
+*/
+void DeviceDataFileWatcher::run( void )
+{
+    char buf[DEVICEDATAFILEWATCHER_BUF_SIZE]
+        __attribute__ ((aligned(__alignof__(struct inotify_event))));
+
+    while( true )
+    {
+        ssize_t len = read( m_fd, buf, sizeof(buf) );
+
+        if( len < 0 )
+        {
+            if( errno == EINTR )
+                continue;
+            return;
+        }
+
+        /* handle all the events read */
+        for( char* p = buf; p < (buf + len); )
+        {
+            const struct inotify_event* p_ev = (const struct inotify_event*)p;
+            p += sizeof(struct inotify_event) + p_ev->len;
+
+            if( p_ev->mask & IN_IGNORED )
+            {
+                /* the directory was removed */
+                std::lock_guard< std::mutex > lock( m_mutex );
+                m_dirs.erase( p_ev->wd );
+                continue;
+            }
+
+            if( (p_ev->mask & DEVICEDATAFILEWATCHER_EVENTS) && (p_ev->len > 0) )
+                changed( p_ev->wd, std::string( p_ev->name ),
+                    (p_ev->mask & IN_MOVED_TO) != 0 );
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* changed()
+*/
+void DeviceDataFileWatcher::changed( int wd, const std::string& name,
+        bool replaced )
+{
+    std::unique_lock< std::mutex > lock( m_mutex );
+    std::vector< DeviceDataFile* > files;
+
+    std::map< int, s_dir >::iterator it = m_dirs.find( wd );
+    if( it == m_dirs.end() )
+        return;
+
+    std::pair< std::multimap< std::string, DeviceDataFile* >::iterator,
+        std::multimap< std::string, DeviceDataFile* >::iterator > range =
+            it->second.files.equal_range( name );
+    for( ; range.first != range.second; ++range.first )
+        files.push_back( range.first->second );
+
+    for( size_t i = 0; i < files.size(); i++ )
+    {
+        /* an observer might have removed an element in the meantime */
+        it = m_dirs.find( wd );
+        if( it == m_dirs.end() )
+            return;
+
+        bool found = false;
+        range = it->second.files.equal_range( name );
+        for( ; range.first != range.second; ++range.first )
+            found |= (range.first->second == files[i]);
+
+        if( found == false )
+            continue;
+
+        /* Notify without holding the lock, since the observers might
+         * observe or unobserve elements. remove() waits instead. */
+        mp_notifying = files[i];
+        lock.unlock();
+        files[i]->fileChanged( replaced );
+        lock.lock();
+        mp_notifying = NULL;
+        m_notified.notify_all();
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* split()
+*/
+void DeviceDataFileWatcher::split( const std::string& path, std::string& dir,
+        std::string& file )
+{
+    size_t pos = path.rfind( '/' );
+
+    if( pos == std::string::npos )
+    {
+        dir = ".";
+        file = path;
+    }
+    else
+    {
+        dir = (pos == 0) ? std::string( "/" ) : path.substr( 0, pos );
+        file = path.substr( pos + 1 );
+    }
+}
@@ -0,0 +1,178 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataFileWatcher.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Watcher of the files of observed file device data elements.
+ *
+ *          A single thread waits for changes of the files of all observed
+ *          file device data elements using inotify and lets the according
+ *          element read the changed file again.
+ */
+
+
+#ifndef __DEVICEDATAFILEWATCHER_H__
+#define __DEVICEDATAFILEWATCHER_H__
+#ifndef __DECL_DEVICEDATAFILEWATCHER_H__
+#define __DECL_DEVICEDATAFILEWATCHER_H__ extern
+#endif /* #ifndef __DECL_DEVICEDATAFILEWATCHER_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+/*
+ * --- Forward Declaration ----------------------------------------------------- *
+ */
+class DeviceDataFile;
+
+/*
+ * --- Class Definition ----------------------------------------------------- *
+ */
+
+/**
+ * \brief   DeviceDataFileWatcher Class.
+ *
+ *          The directories of the files are watched instead of the files
+ *          themselves. This way files replaced by renaming another file
+ *          are detected as well and a directory containing many files
+ *          needs a single watch only. A file is read again once a writer
+ *          closed it or it was moved into place.
+ */
+class DeviceDataFileWatcher
+{
+
+public:
+
+    /**
+     * \brief   Get the watcher.
+     *
+     *          The watcher is created on first use.
+     *
+     * \return  The watcher.
+     */
+    static DeviceDataFileWatcher* getInstance( void );
+
+    /**
+     * \brief   Start watching the file of an element.
+     *
+     * \param   p_file  Element to watch.
+     *
+     * \return  0 on success or -1 if the file can not be watched.
+     */
+    int16_t add( DeviceDataFile* p_file );
+
+    /**
+     * \brief   Stop watching the file of an element.
+     *
+     *          Returns after a running notification of the element has
+     *          finished, except if called from that notification.
+     *
+     * \param   p_file  Element to stop watching.
+     */
+    void remove( DeviceDataFile* p_file );
+
+private:
+
+    /** watched directory */
+    struct s_dir
+    {
+        /** path of the directory */
+        std::string path;
+        /** watched elements by file name */
+        std::multimap< std::string, DeviceDataFile* > files;
+    };
+
+    /**
+     * \brief   Constructor to create the watcher.
+     */
+    DeviceDataFileWatcher( void );
+
+    /**
+     * \brief   Watcher thread function.
+     */
+    void run( void );
+
+    /**
+     * \brief   Let the elements of a changed file read it again.
+     *
+     * \param   wd      Watch descriptor of the directory.
+     * \param   name    Name of the changed file.
+     * \param   replaced The file was replaced by another one.
+     */
+    void changed( int wd, const std::string& name, bool replaced );
+
+    /**
+     * \brief   Split a path into directory and file name.
+     *
+     * \param   path    The path.
+     * \param   dir     Returns the directory.
+     * \param   file    Returns the file name.
+     */
+    static void split( const std::string& path, std::string& dir,
+            std::string& file );
+
+private:
+
+    /** inotify instance */
+    int m_fd;
+
+    /** watched directories by watch descriptor */
+    std::map< int, s_dir > m_dirs;
+
+    /** protects the watches, not held while notifying */
+    std::mutex m_mutex;
+
+    /** element being notified */
+    DeviceDataFile* mp_notifying;
+
+    /** signals the end of a notification */
+    std::condition_variable m_notified;
+
+    /** watcher thread */
+    std::thread m_thread;
+};
+
+#endif /* #ifndef __DEVICEDATAFILEWATCHER_H__ */
@@ -0,0 +1,157 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataFilter.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Change filter of device data notifications.
+ *
+ *          A filter decides whether a changed value is reported to the
+ *          observers. It remembers the last value that passed and drops
+ *          values that are equal or within a deadband around it.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <math.h>
+#include "DeviceDataFilter.h"
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** FNV-1a offset basis */
+#define DEVICEDATAFILTER_FNV_OFFSET         0xcbf29ce484222325ULL
+
+/** FNV-1a prime */
+#define DEVICEDATAFILTER_FNV_PRIME          0x100000001b3ULL
+
+
+/*
+ * --- Methods Definition ----------------------------------------------------- *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* check()
+*/
+bool DeviceDataFilter::check( const DeviceDataValue& val )
+{
+    bool ret = true;
+    int16_t type = val.getType();
+
+    lock();
+
+    if( (type == DeviceDataValue::TYPE_STRING) ||
+        (type == DeviceDataValue::TYPE_OPAQUE) )
+    {
+        uint64_t h = hash( val.getOpaque(), val.getLen() );
+
+        /* deadbands are not defined for strings and opaque values */
+        if( m_valid && (m_lastLen == val.getLen()) && (m_lastHash == h) )
+            ret = false;
+        else
+        {
+            m_lastHash = h;
+            m_lastLen = val.getLen();
+        }
+    }
+    else if( (type == DeviceDataValue::TYPE_INTEGER) ||
+        (type == DeviceDataValue::TYPE_INTEGER64) )
+    {
+        int64_t i64 = val.getNum<int64_t>();
+
+        if( m_valid )
+        {
+            double diff = fabs( (double)i64 - (double)m_lastInt );
+
+            if( m_mode == FILTER_EQUAL )
+                ret = (i64 != m_lastInt);
+            else if( m_mode == FILTER_DEADBAND_ABS )
+                ret = (diff > m_deadband);
+            else
+                ret = (diff > (fabs( (double)m_lastInt ) * m_deadband / 100.0));
+        }
+
+        if( ret )
+            m_lastInt = i64;
+    }
+    else
+    {
+        double d = val.getNum<double>();
+
+        if( m_valid )
+        {
+            double diff = fabs( d - m_lastNum );
+
+            /* NaN never compares equal and always passes */
+            if( m_mode == FILTER_EQUAL )
+                ret = (d != m_lastNum);
+            else if( m_mode == FILTER_DEADBAND_ABS )
+                ret = !(diff <= m_deadband);
+            else
+                ret = !(diff <= (fabs( m_lastNum ) * m_deadband / 100.0));
+        }
+
+        if( ret )
+            m_lastNum = d;
+    }
+
+    m_valid = true;
+    unlock();
+
+    if( ret == false )
+        m_suppressed++;
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* hash()
+*/
+uint64_t DeviceDataFilter::hash( const uint8_t* p, uint32_t len )
+{
+    uint64_t h = DEVICEDATAFILTER_FNV_OFFSET;
+
+    for( uint32_t i = 0; i < len; i++ )
+    {
+        h ^= p[i];
+        h *= DEVICEDATAFILTER_FNV_PRIME;
+    }
+    return h;
+}
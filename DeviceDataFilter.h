@@ -0,0 +1,253 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataFilter.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Change filter of device data notifications.
+ *
+ *          A filter decides whether a changed value is reported to the
+ *          observers. It remembers the last value that passed and drops
+ *          values that are equal or within a deadband around it.
+ */
+
+
+#ifndef __DEVICEDATAFILTER_H__
+#define __DEVICEDATAFILTER_H__
+#ifndef __DECL_DEVICEDATAFILTER_H__
+#define __DECL_DEVICEDATAFILTER_H__ extern
+#endif /* #ifndef __DECL_DEVICEDATAFILTER_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <atomic>
+#include "DeviceDataValue.h"
+
+
+/*
+ * --- Class Definition ----------------------------------------------------- *
+ */
+
+/**
+ * \brief   DeviceDataFilter Class.
+ *
+ *          Numeric values are compared by value. String and opaque values
+ *          are compared using their length and a 64 bit FNV-1a hash so no
+ *          copy of the last value has to be kept. Deadbands apply to
+ *          numeric values only, other values are filtered by equality.
+ *          The first value always passes.
+ */
+class DeviceDataFilter
+{
+
+public:
+
+    /** Enumeration of the filter modes */
+    enum e_mode
+    {
+        /** every value passes */
+        FILTER_NONE,
+        /** values equal to the last one are dropped */
+        FILTER_EQUAL,
+        /** values within an absolute deadband are dropped */
+        FILTER_DEADBAND_ABS,
+        /** values within a deadband given in percent of the
+         * last value are dropped */
+        FILTER_DEADBAND_PERCENT
+    };
+
+
+    /**
+     * \brief   Constructor of a filter.
+     *
+     * \param   mode        Filter mode.
+     * \param   deadband    Absolute deadband or deadband in percent.
+     */
+    DeviceDataFilter( e_mode mode = FILTER_NONE, double deadband = 0 )
+        : m_mode( mode )
+        , m_deadband( deadband )
+        , m_valid( false )
+        , m_lastInt( 0 )
+        , m_lastNum( 0 )
+        , m_lastHash( 0 )
+        , m_lastLen( 0 )
+        , m_suppressed( 0 ) {
+        m_lock.clear();
+    };
+
+    /**
+     * \brief   Copy constructor.
+     *
+     *          Only the configuration is copied, the copy starts without
+     *          a last value.
+     *
+     * \param   filter  Filter to copy.
+     */
+    DeviceDataFilter( const DeviceDataFilter& filter )
+        : DeviceDataFilter( filter.m_mode, filter.m_deadband ) {};
+
+    /** assignment operator, copies the configuration only */
+    DeviceDataFilter& operator=( const DeviceDataFilter& filter ) {
+        if( this != &filter )
+        {
+            lock();
+            m_mode = filter.m_mode;
+            m_deadband = filter.m_deadband;
+            m_valid = false;
+            unlock();
+        }
+        return *this;
+    }
+
+    /**
+     * \brief   Get the filter mode.
+     *
+     * \return  The filter mode.
+     */
+    e_mode getMode( void ) const {
+        return m_mode;
+    }
+
+    /**
+     * \brief   Get the deadband.
+     *
+     * \return  The deadband.
+     */
+    double getDeadband( void ) const {
+        return m_deadband;
+    }
+
+    /**
+     * \brief   Get the number of dropped values.
+     *
+     * \return  Number of values that did not pass the filter.
+     */
+    uint32_t getSuppressed( void ) const {
+        return m_suppressed;
+    }
+
+    /**
+     * \brief   Forget the last value.
+     *
+     *          The next value passes in any case.
+     */
+    void reset( void ) {
+        lock();
+        m_valid = false;
+        unlock();
+    }
+
+    /**
+     * \brief   Check if a value passes the filter.
+     *
+     *          If the value passes it becomes the new reference value.
+     *
+     * \param   val     Value to check.
+     *
+     * \return  true if the value shall be reported.
+     */
+    bool pass( const DeviceDataValue& val ) {
+        if( m_mode == FILTER_NONE )
+            return true;
+        return check( val );
+    }
+
+private:
+
+    /**
+     * \brief   Check a value against the last one.
+     *
+     * \param   val     Value to check.
+     *
+     * \return  true if the value shall be reported.
+     */
+    bool check( const DeviceDataValue& val );
+
+    /**
+     * \brief   Calculate the hash of a string or opaque value.
+     *
+     * \param   p       Data of the value.
+     * \param   len     Length of the data.
+     *
+     * \return  The FNV-1a hash.
+     */
+    static uint64_t hash( const uint8_t* p, uint32_t len );
+
+    /** acquire the filter state */
+    void lock( void ) {
+        while( m_lock.test_and_set( std::memory_order_acquire ) )
+            ;
+    }
+
+    /** release the filter state */
+    void unlock( void ) {
+        m_lock.clear( std::memory_order_release );
+    }
+
+private:
+
+    /** filter mode */
+    e_mode m_mode;
+
+    /** deadband */
+    double m_deadband;
+
+    /** a last value is available */
+    bool m_valid;
+
+    /** last integer value */
+    int64_t m_lastInt;
+
+    /** last floating point value */
+    double m_lastNum;
+
+    /** hash of the last string or opaque value */
+    uint64_t m_lastHash;
+
+    /** length of the last string or opaque value */
+    uint32_t m_lastLen;
+
+    /** number of dropped values */
+    std::atomic<uint32_t> m_suppressed;
+
+    /** protects the state if notifications are delivered concurrently */
+    std::atomic_flag m_lock;
+};
+
+#endif /* #ifndef __DEVICEDATAFILTER_H__ */
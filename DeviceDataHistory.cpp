@@ -0,0 +1,225 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataHistory.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   In-memory history of a device data element.
+ *
+ *          The history keeps the latest values of a device data element
+ *          together with their timestamps in a ring buffer of a fixed
+ *          capacity. The oldest values are overwritten once it is full.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <chrono>
+#include <algorithm>
+#include "DeviceDataHistory.h"
+
+
+/*
+ * --- Methods Definition ----------------------------------------------------- *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* DeviceDataHistory()
+*/
+DeviceDataHistory::DeviceDataHistory( size_t capacity, DeviceDataValue::e_type type )
+    : m_samples( (capacity > 0) ? capacity : 1, s_sample{ 0, DeviceDataValue( type ) } )
+    , m_first( 0 )
+    , m_size( 0 )
+{
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* add()
+*/
+void DeviceDataHistory::add( const DeviceDataValue& val, uint64_t time )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+    size_t idx;
+
+    /* keep the samples sorted */
+    if( (m_size > 0) && (time < at( m_size - 1 ).time) )
+        time = at( m_size - 1 ).time;
+
+    if( m_size < m_samples.size() )
+    {
+        idx = (m_first + m_size) % m_samples.size();
+        m_size++;
+    }
+    else
+    {
+        /* overwrite the oldest sample */
+        idx = m_first;
+        m_first = (m_first + 1) % m_samples.size();
+    }
+
+    /* the buffers of string values are reused */
+    m_samples[idx].time = time;
+    m_samples[idx].val = val;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* getRange()
+*/
+size_t DeviceDataHistory::getRange( uint64_t from, uint64_t to,
+        std::vector< s_sample >& samples, size_t max ) const
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    samples.clear();
+    if( from > to )
+        return 0;
+
+    size_t first = find( from );
+    size_t last = (to == UINT64_MAX) ? m_size : find( to + 1 );
+
+    if( (max > 0) && ((last - first) > max) )
+        last = first + max;
+
+    copy( first, last - first, samples );
+    return samples.size();
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* getLatest()
+*/
+size_t DeviceDataHistory::getLatest( size_t num, std::vector< s_sample >& samples ) const
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    samples.clear();
+    if( num > m_size )
+        num = m_size;
+
+    copy( m_size - num, num, samples );
+    return samples.size();
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* copy()
+*/
+size_t DeviceDataHistory::copy( s_sample* p_samples, size_t size ) const
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    if( size > m_size )
+        size = m_size;
+
+    /* copy the samples of the ring buffer in at most two parts */
+    size_t part = m_samples.size() - m_first;
+    if( part > size )
+        part = size;
+
+    std::copy( m_samples.begin() + m_first, m_samples.begin() + m_first + part,
+        p_samples );
+    std::copy( m_samples.begin(), m_samples.begin() + (size - part),
+        p_samples + part );
+
+    return size;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* getSize()
+*/
+size_t DeviceDataHistory::getSize( void ) const
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+    return m_size;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* clear()
+*/
+void DeviceDataHistory::clear( void )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+    m_first = 0;
+    m_size = 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* now()
+*/
+uint64_t DeviceDataHistory::now( void )
+{
+    return (uint64_t)std::chrono::duration_cast< std::chrono::microseconds >(
+        std::chrono::system_clock::now().time_since_epoch() ).count();
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* find()
+*/
+size_t DeviceDataHistory::find( uint64_t time ) const
+{
+    size_t lo = 0;
+    size_t hi = m_size;
+
+    /* binary search for the first sample not older than time */
+    while( lo < hi )
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if( at( mid ).time < time )
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* copy()
+*/
+void DeviceDataHistory::copy( size_t idx, size_t num,
+        std::vector< s_sample >& samples ) const
+{
+    samples.reserve( samples.size() + num );
+    for( size_t i = 0; i < num; i++ )
+        samples.push_back( at( idx + i ) );
+}
@@ -0,0 +1,230 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataHistory.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   In-memory history of a device data element.
+ *
+ *          The history keeps the latest values of a device data element
+ *          together with their timestamps in a ring buffer of a fixed
+ *          capacity. The oldest values are overwritten once it is full.
+ */
+
+
+#ifndef __DEVICEDATAHISTORY_H__
+#define __DEVICEDATAHISTORY_H__
+#ifndef __DECL_DEVICEDATAHISTORY_H__
+#define __DECL_DEVICEDATAHISTORY_H__ extern
+#endif /* #ifndef __DECL_DEVICEDATAHISTORY_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+#include "DeviceDataValue.h"
+
+/*
+ * --- Class Definition ----------------------------------------------------- *
+ */
+
+/**
+ * \brief   DeviceDataHistory Class.
+ *
+ *          Timestamps are given in us since the epoch of the system clock.
+ *          They never decrease within a history, a timestamp older than
+ *          the latest one is replaced by the latest one. This keeps the
+ *          samples sorted so ranges are found using a binary search.
+ */
+class DeviceDataHistory
+{
+
+public:
+
+    /** a single sample of the history */
+    struct s_sample
+    {
+        /** timestamp in us since the epoch */
+        uint64_t time;
+        /** value */
+        DeviceDataValue val;
+    };
+
+    /**
+     * \brief   Constructor to create a history.
+     *
+     * \param   capacity    Maximum number of samples.
+     * \param   type        Type of the values.
+     */
+    DeviceDataHistory( size_t capacity, DeviceDataValue::e_type type );
+
+    /**
+     * \brief   Default Destructor of the history.
+     */
+    virtual ~DeviceDataHistory( void ) {};
+
+    /**
+     * \brief   Add a sample.
+     *
+     * \param   val     Value of the sample.
+     * \param   time    Timestamp of the sample in us since the epoch.
+     */
+    void add( const DeviceDataValue& val, uint64_t time );
+
+    /**
+     * \brief   Add a sample taken now.
+     *
+     * \param   val     Value of the sample.
+     */
+    void add( const DeviceDataValue& val ) {
+        add( val, now() );
+    }
+
+    /**
+     * \brief   Get the samples within a time range.
+     *
+     * \param   from    Start of the range in us since the epoch (incl.).
+     * \param   to      End of the range in us since the epoch (incl.).
+     * \param   samples Filled with the samples in ascending order.
+     * \param   max     Maximum number of samples to return starting with
+     *                  the oldest one or 0 for no limit.
+     *
+     * \return  Number of samples returned.
+     */
+    size_t getRange( uint64_t from, uint64_t to,
+            std::vector< s_sample >& samples, size_t max = 0 ) const;
+
+    /**
+     * \brief   Get the latest samples.
+     *
+     * \param   num     Number of samples.
+     * \param   samples Filled with the samples in ascending order.
+     *
+     * \return  Number of samples returned.
+     */
+    size_t getLatest( size_t num, std::vector< s_sample >& samples ) const;
+
+    /**
+     * \brief   Copy the whole history.
+     *
+     *          The values are copied to the buffer given without any
+     *          allocation if the buffer is large enough.
+     *
+     * \param   p_samples   Buffer to copy the samples to.
+     * \param   size        Size of the buffer in samples.
+     *
+     * \return  Number of samples copied.
+     */
+    size_t copy( s_sample* p_samples, size_t size ) const;
+
+    /**
+     * \brief   Get the number of samples.
+     *
+     * \return  Number of samples within the history.
+     */
+    size_t getSize( void ) const;
+
+    /**
+     * \brief   Get the capacity.
+     *
+     * \return  Maximum number of samples.
+     */
+    size_t getCapacity( void ) const {
+        return m_samples.size();
+    }
+
+    /**
+     * \brief   Remove all samples.
+     */
+    void clear( void );
+
+    /**
+     * \brief   Get the actual time.
+     *
+     * \return  Actual time in us since the epoch.
+     */
+    static uint64_t now( void );
+
+private:
+
+    /**
+     * \brief   Find the first sample not older than a timestamp.
+     *
+     * \param   time    Timestamp.
+     *
+     * \return  Index of the sample counted from the oldest one.
+     */
+    size_t find( uint64_t time ) const;
+
+    /**
+     * \brief   Get a sample.
+     *
+     * \param   idx     Index of the sample counted from the oldest one.
+     *
+     * \return  The sample.
+     */
+    const s_sample& at( size_t idx ) const {
+        return m_samples[(m_first + idx) % m_samples.size()];
+    }
+
+    /**
+     * \brief   Copy a range of samples.
+     *
+     * \param   idx     Index of the first sample counted from the oldest one.
+     * \param   num     Number of samples.
+     * \param   samples Vector to append the samples to.
+     */
+    void copy( size_t idx, size_t num, std::vector< s_sample >& samples ) const;
+
+private:
+
+    /** ring buffer of the samples */
+    std::vector< s_sample > m_samples;
+
+    /** index of the oldest sample */
+    size_t m_first;
+
+    /** number of samples */
+    size_t m_size;
+
+    /** protects the samples */
+    mutable std::mutex m_mutex;
+};
+
+#endif /* #ifndef __DEVICEDATAHISTORY_H__ */
@@ -50,6 +50,21 @@
  */
 #include <DeviceDataLWM2M.h>
 #include <iostream>
+#include <thread>
+#include <mutex>
+
+/*
+ * --- Local Variables ------------------------------------------------------ *
+ */
+
+/** number of worker threads of the default executor */
+#define DEVICEDATALWM2M_EXECUTOR_THREADS        4
+
+/** executor for asynchronous accesses */
+static DeviceDataExecutor* gp_executor = NULL;
+
+/** lock to create the default executor */
+static std::mutex g_executorMutex;
 
 
 
@@ -60,42 +75,59 @@
 
 /*---------------------------------------------------------------------------*/
 /*
-* getValNative()
+* ~DeviceDataLWM2M()
 */
-int8_t DeviceDataLWM2M::notify( const LWM2MServer* p_srv,  const LWM2MResource* p_res,
-        const s_lwm2m_obsparams_t* p_params )
+DeviceDataLWM2M::~DeviceDataLWM2M( void )
 {
-    std::string dataStr = "";
+    /* wait for pending asynchronous accesses to finish */
+    while( m_pending > 0 )
+        std::this_thread::yield();
 
-    if( (p_params != NULL) && (p_params->data != NULL) )
-    {
-        DeviceDataValue val = *(getVal());
-        switch( p_params->data->type )
-        {
-          case LWM2M_TYPE_STRING:
-            dataStr.append( (char*)p_params->data->value.asBuffer.buffer );
-            val.setVal( (char*)dataStr.c_str() );
-            break;
+    /* deliver the queued notifications while the element is complete */
+    shutdown();
+}
 
-          case LWM2M_TYPE_INTEGER:
-          case LWM2M_TYPE_BOOLEAN:
-            val.setVal( (int)p_params->data->value.asInteger );
-            break;
+/*---------------------------------------------------------------------------*/
+/*
+* setExecutor()
+*/
+void DeviceDataLWM2M::setExecutor( DeviceDataExecutor* p_exec )
+{
+    std::lock_guard< std::mutex > lock( g_executorMutex );
+    gp_executor = p_exec;
+}
 
-          case LWM2M_TYPE_FLOAT:
-            val.setVal( (float)p_params->data->value.asFloat );
-            break;
+/*---------------------------------------------------------------------------*/
+/*
+* getExecutor()
+*/
+DeviceDataExecutor* DeviceDataLWM2M::getExecutor( void )
+{
+    std::lock_guard< std::mutex > lock( g_executorMutex );
+    if( gp_executor == NULL )
+        gp_executor = new DeviceDataExecutor( DEVICEDATALWM2M_EXECUTOR_THREADS );
+    return gp_executor;
+}
 
-          case LWM2M_TYPE_OPAQUE:
-            val.setVal( p_params->data->value.asBuffer.buffer,
-                p_params->data->value.asBuffer.length );
-            break;
+/*---------------------------------------------------------------------------*/
+/*
+* notify()
+*/
+int8_t DeviceDataLWM2M::notify( const LWM2MServer* p_srv,  const LWM2MResource* p_res,
+        const s_lwm2m_obsparams_t* p_params )
+{
+    if( (p_params != NULL) && (p_params->data != NULL) )
+    {
+        int16_t ret;
 
-          default:
-            break;
+        /* decode the data directly into the stored value */
+        {
+            std::unique_lock< std::mutex > lock( lockValStorage() );
+            ret = toVal( p_params->data, getValStorage() );
         }
 
-        valueChanged( &val );
+        if( ret == 0 )
+            valueChanged();
     }
 
     return 0;
@@ -109,48 +141,147 @@ int16_t DeviceDataLWM2M::getValNative( DeviceDataValue* val )
 {
     int16_t ret = -1;
 
-    if( (mp_lwm2mSrv != NULL) &&
-        (mp_lwm2mSrv->hasDevice( mp_lwm2mRes->getDevice()->getName() )))
+    if( (mp_lwm2mSrv != NULL) && getOnline() )
     {
-        lwm2m_data_t* data;
-        std::string dataStr = "";
+        lwm2m_data_t* data = NULL;
 
         /* The Device with the according resource is available. So we can read
          * the value from the device. */
-        ret = mp_lwm2mSrv->read( mp_lwm2mRes, &data, NULL );
+        int16_t num = mp_lwm2mSrv->read( mp_lwm2mRes, &data, NULL );
+        ret = num;
+
+        if( (val != NULL) && (data != NULL) && (num > 0) )
+            ret = toVal( data, val );
 
-        if( (val != NULL) && (data != NULL) && (ret > 0) )
+        if( (data != NULL) && (num > 0) )
+          lwm2m_data_free( num, data );
+    }
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* getValNativeAsync()
+*/
+int16_t DeviceDataLWM2M::getValNativeAsync( DeviceDataValue* val, const t_complete& cb )
+{
+    m_pending++;
+
+    int16_t ret = getExecutor()->post( [this, val, cb]( void )
         {
-            switch( data->type )
-            {
-                case LWM2M_TYPE_STRING:
-                    dataStr.assign( (char*)data->value.asBuffer.buffer,
-                        data->value.asBuffer.length );
-                    val->setVal( (char*)dataStr.c_str() );
-                    break;
-
-                case LWM2M_TYPE_INTEGER:
-                case LWM2M_TYPE_BOOLEAN:
-                    val->setVal( (int)data->value.asInteger );
-                    break;
-
-                case LWM2M_TYPE_FLOAT:
-                    val->setVal( (float)data->value.asFloat );
-                    break;
-
-                case LWM2M_TYPE_OPAQUE:
-                  val->setVal( data->value.asBuffer.buffer,
-                      data->value.asBuffer.length );
-                  break;
-
-                default:
-                    break;
-            }
-            ret = 0;
-        }
+            /* run the blocking read within the executor */
+            cb( getValNative( val ), val );
+            m_pending--;
+        });
+
+    if( ret != 0 )
+        m_pending--;
+    return ret;
+}
 
-        if( (data != NULL) && (ret > 0) )
-          lwm2m_data_free( ret, data );
+/*---------------------------------------------------------------------------*/
+/*
+* setValNativeAsync()
+*/
+int16_t DeviceDataLWM2M::setValNativeAsync( const DeviceDataValue* val, const t_complete& cb )
+{
+    m_pending++;
+
+    int16_t ret = getExecutor()->post( [this, val, cb]( void )
+        {
+            /* run the blocking write within the executor */
+            cb( setValNative( val ), val );
+            m_pending--;
+        });
+
+    if( ret != 0 )
+        m_pending--;
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* batchCompatible()
+*/
+bool DeviceDataLWM2M::batchCompatible( const DeviceData* p_data ) const
+{
+    const DeviceDataLWM2M* p_lwm2m = dynamic_cast<const DeviceDataLWM2M*>( p_data );
+
+    if( (p_lwm2m == NULL) || (mp_lwm2mRes == NULL) ||
+        (p_lwm2m->mp_lwm2mRes == NULL) )
+        return false;
+
+    /* resources of the same device share the online state */
+    return (p_lwm2m->mp_lwm2mSrv == mp_lwm2mSrv) &&
+        (p_lwm2m->mp_lwm2mRes->getDevice() == mp_lwm2mRes->getDevice());
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* getValsNative()
+*/
+void DeviceDataLWM2M::getValsNative( const std::vector<DeviceData*>& data,
+        const std::vector<DeviceDataValue*>& vals, std::vector<int16_t>& ret )
+{
+    /* the resources of a device that is offline are not read */
+    if( (mp_lwm2mSrv == NULL) || (getOnline() == false) )
+        return;
+
+    /* the server reads single resources only */
+    for( size_t i = 0; i < data.size(); i++ )
+        ret[i] = static_cast<DeviceDataLWM2M*>( data[i] )->getValNative( vals[i] );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* setValsNative()
+*/
+void DeviceDataLWM2M::setValsNative( const std::vector<DeviceData*>& data,
+        const std::vector<const DeviceDataValue*>& vals, std::vector<int16_t>& ret )
+{
+    /* the resources of a device that is offline are not written */
+    if( (mp_lwm2mSrv == NULL) || (getOnline() == false) )
+        return;
+
+    /* the server writes single resources only */
+    for( size_t i = 0; i < data.size(); i++ )
+        ret[i] = static_cast<DeviceDataLWM2M*>( data[i] )->setValNative( vals[i] );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* toVal()
+*/
+int16_t DeviceDataLWM2M::toVal( const lwm2m_data_t* p_data, DeviceDataValue* p_val )
+{
+    int16_t ret = 0;
+
+    switch( p_data->type )
+    {
+        case LWM2M_TYPE_STRING:
+            p_val->setVal( (const char*)p_data->value.asBuffer.buffer,
+                p_data->value.asBuffer.length );
+            break;
+
+        case LWM2M_TYPE_INTEGER:
+            p_val->setVal( (int64_t)p_data->value.asInteger );
+            break;
+
+        case LWM2M_TYPE_BOOLEAN:
+            p_val->setVal( (int32_t)(p_data->value.asBoolean ? 1 : 0) );
+            break;
+
+        case LWM2M_TYPE_FLOAT:
+            p_val->setVal( (double)p_data->value.asFloat );
+            break;
+
+        case LWM2M_TYPE_OPAQUE:
+            p_val->setVal( p_data->value.asBuffer.buffer,
+                p_data->value.asBuffer.length );
+            break;
+
+        default:
+            break;
     }
     return ret;
 }
@@ -163,25 +294,23 @@ int16_t DeviceDataLWM2M::setValNative( const DeviceDataValue* val )
 {
     int16_t ret = -1;
     char buf[100];
+    const char* p_str = buf;
 
-    if( (mp_lwm2mSrv != NULL) &&
-        (mp_lwm2mSrv->hasDevice( mp_lwm2mRes->getDevice()->getName() )))
+    if( (mp_lwm2mSrv != NULL) && getOnline() )
     {
         /* Write the new data */
         switch( val->getType() )
         {
             case DeviceDataValue::TYPE_INTEGER:
-                snprintf( buf, 100, "%d", val->getVal().i32 );
-                ret = 0;
-                break;
-
+            case DeviceDataValue::TYPE_INTEGER64:
             case DeviceDataValue::TYPE_FLOAT:
-                snprintf( buf, 100, "%f", val->getVal().f );
+            case DeviceDataValue::TYPE_DOUBLE:
+                buf[val->toChars( buf, sizeof(buf) - 1 )] = '\0';
                 ret = 0;
                 break;
 
             case DeviceDataValue::TYPE_STRING:
-                snprintf( buf, 100, "%s", val->getVal().cStr );
+                p_str = val->getStr();
                 ret = 0;
                 break;
 
@@ -193,7 +322,7 @@ int16_t DeviceDataLWM2M::setValNative( const DeviceDataValue* val )
         if( ret == 0 )
         {
             /* write the data via LWM2M */
-            ret = mp_lwm2mSrv->write( mp_lwm2mRes, buf, NULL );
+            ret = mp_lwm2mSrv->write( mp_lwm2mRes, (char*)p_str, NULL );
         }
     }
     return ret;
@@ -207,25 +336,35 @@ int8_t DeviceDataLWM2M::observeValNative( bool direct )
 {
     int8_t ret = -1;
 
-    if( (mp_lwm2mSrv != NULL) &&
-        (mp_lwm2mSrv->hasDevice( mp_lwm2mRes->getDevice()->getName() )))
+    if( (mp_lwm2mSrv != NULL) && getOnline() )
     {
+      bool registered = m_observed;
 
-      /* register observer in advance */
-      ret = mp_lwm2mRes->registerObserver( this );
+      /* register observer in advance. An observation by a higher
+       * instance is already registered and only becomes direct. */
+      ret = registered ? 0 : mp_lwm2mRes->registerObserver( this );
 
-      if( (ret == 0) && (m_observed == false))
+      if( ret == 0 )
       {
         m_observed = true;
 
-        if( direct )
+        /* an observation that is direct already is kept */
+        if( direct && (m_direct == false) )
+        {
           /* observe the value */
           ret = mp_lwm2mSrv->observe( mp_lwm2mRes, true );
+          m_direct = (ret == 0);
+        }
 
         if( ret != 0 )
         {
-          /* observe was not successful */
-          ret = mp_lwm2mRes->deregisterObserver( this );
+          /* observe was not successful, an existing registration
+           * is kept */
+          if( registered == false )
+          {
+            mp_lwm2mRes->deregisterObserver( this );
+            m_observed = false;
+          }
           ret = -1;
         }
       }
@@ -233,3 +372,24 @@ int8_t DeviceDataLWM2M::observeValNative( bool direct )
     return ret;
 }
 
+/*---------------------------------------------------------------------------*/
+/*
+* unobserveValNative()
+*/
+int8_t DeviceDataLWM2M::unobserveValNative( void )
+{
+    int8_t ret = 0;
+
+    if( (mp_lwm2mSrv == NULL) || (m_observed == false) )
+        return 0;
+
+    /* cancel the observation at the device. A device that is
+     * offline has dropped the observation already. */
+    if( m_direct && getOnline() )
+        ret = mp_lwm2mSrv->observe( mp_lwm2mRes, false );
+
+    mp_lwm2mRes->deregisterObserver( this );
+    m_direct = false;
+    m_observed = false;
+    return ret;
+}
@@ -56,8 +56,10 @@
  * --- Includes ------------------------------------------------------------- *
  */
 #include <iostream>
-
+#include <atomic>
+
 #include "DeviceData.h"
+#include "DeviceDataExecutor.h"
 #include "LWM2MServer.h"
 #include "LWM2MDevice.h"
 #include "LWM2MObject.h"
@@ -84,7 +86,9 @@ public:
     DeviceDataLWM2M( void )
         : DeviceData()
         , mp_lwm2mSrv( NULL )
-        , mp_lwm2mRes( NULL ) {};
+        , mp_lwm2mRes( NULL )
+        , m_pending( 0 )
+        , m_direct( false ) {};
 
 
     /**
@@ -99,7 +103,9 @@ public:
             int access, LWM2MResource* p_lwm2mRes )
         : DeviceData( name, descr, type, access )
         , mp_lwm2mSrv( NULL )
-        , mp_lwm2mRes( p_lwm2mRes ){
+        , mp_lwm2mRes( p_lwm2mRes )
+        , m_pending( 0 )
+        , m_direct( false ) {
 
             if( mp_lwm2mRes != NULL )
                 mp_lwm2mSrv = mp_lwm2mRes->getServer();
@@ -112,7 +118,7 @@ public:
      *          Since this is a pure virtual class acting as an interface
      *          this destructor should never be called directly.
      */
-    virtual ~DeviceDataLWM2M( void ) {};
+    virtual ~DeviceDataLWM2M( void );
 
 
     /**
@@ -122,6 +128,27 @@ public:
      */
     LWM2MResource* getResource( void ) const { return mp_lwm2mRes; };
 
+    /**
+     * \brief   Get the name of the backend of the element.
+     *
+     * \return  The name of the backend.
+     */
+    virtual const char* getBackend( void ) const {
+        return "lwm2m";
+    }
+
+    /**
+     * \brief   Set the executor used for asynchronous accesses.
+     *
+     *          The LWM2M server only provides blocking accesses. Therefore,
+     *          asynchronous accesses are executed by an executor. If no
+     *          executor was set a default executor is created on the first
+     *          asynchronous access.
+     *
+     * \param   p_exec  Executor to use for all LWM2M data elements.
+     */
+    static void setExecutor( DeviceDataExecutor* p_exec );
+
     /**
      * \brief    Get the resource ID.
      *
@@ -177,6 +204,102 @@ private:
      */
     virtual int8_t observeValNative( bool direct = true );
 
+    /**
+     * \brief   Native function to stop observing the device data value.
+     *
+     *          The observation at the device is cancelled and the
+     *          element is not notified by the resource anymore.
+     *
+     * \return  0 on success.
+     */
+    virtual int8_t unobserveValNative( void );
+
+    /**
+     * \brief   Native asynchronous read function.
+     *
+     *          The read is executed by the executor of the LWM2M data
+     *          elements so the caller is not blocked.
+     *
+     * \param   val     Value to store the result to.
+     * \param   cb      Completion handler to call with the result.
+     *
+     * \return  0 if the request was issued.
+     */
+    virtual int16_t getValNativeAsync( DeviceDataValue* val, const t_complete& cb );
+
+    /**
+     * \brief   Native asynchronous write function.
+     *
+     *          The write is executed by the executor of the LWM2M data
+     *          elements so the caller is not blocked.
+     *
+     * \param   val     Value to write.
+     * \param   cb      Completion handler to call with the result.
+     *
+     * \return  0 if the request was issued.
+     */
+    virtual int16_t setValNativeAsync( const DeviceDataValue* val, const t_complete& cb );
+
+    /**
+     * \brief   Get the executor for asynchronous accesses.
+     *
+     * \return  The executor set or the default executor.
+     */
+    static DeviceDataExecutor* getExecutor( void );
+
+    /**
+     * \brief   Check if an element can be accessed together with this one.
+     *
+     *          LWM2M resources can be accessed together if they belong to
+     *          the same device of the same server.
+     *
+     * \param   p_data  Element to check.
+     *
+     * \return  true if both elements can be accessed within the same request.
+     */
+    virtual bool batchCompatible( const DeviceData* p_data ) const;
+
+    /**
+     * \brief   Native read function to get several device data values.
+     *
+     *          The server reads single resources only. Therefore, the
+     *          online state of the device is checked once for the group and
+     *          the resources are read one after the other. The accesses
+     *          to a device that is offline fail at once.
+     *
+     * \param   data    Elements to read.
+     * \param   vals    Values to store the results of the elements to.
+     * \param   ret     Result of the read for each of the elements.
+     */
+    virtual void getValsNative( const std::vector<DeviceData*>& data,
+            const std::vector<DeviceDataValue*>& vals,
+            std::vector<int16_t>& ret );
+
+    /**
+     * \brief   Native write function to set several device data values.
+     *
+     *          The server writes single resources only. Therefore, the
+     *          online state of the device is checked once for the group and
+     *          the resources are written one after the other.
+     *
+     * \param   data    Elements to write.
+     * \param   vals    Values to write to the elements.
+     * \param   ret     Result of the write for each of the elements.
+     */
+    virtual void setValsNative( const std::vector<DeviceData*>& data,
+            const std::vector<const DeviceDataValue*>& vals,
+            std::vector<int16_t>& ret );
+
+    /**
+     * \brief   Convert LWM2M data into a device data value.
+     *
+     * \param   p_data  LWM2M data to convert.
+     * \param   p_val   Value to store the data to.
+     *
+     * \return  0 on success.
+     */
+    static int16_t toVal( const lwm2m_data_t* p_data, DeviceDataValue* p_val );
+
 private:
 
     /** LWM2M Server this data was assigned to */
@@ -184,6 +307,13 @@ private:
 
     /** LWM2M Resource this data was assigned to */
     LWM2MResource* mp_lwm2mRes;
+
+
+    /** number of pending asynchronous accesses */
+    std::atomic<uint32_t> m_pending;
+
+    /** the resource is observed at the device */
+    bool m_direct;
 };
 
 #endif /* #ifndef __SENSORDATALWM2M_H__ */
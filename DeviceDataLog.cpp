@@ -0,0 +1,591 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataLog.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Append-only binary log of device data values.
+ *
+ *          The log records the values of many device data elements as
+ *          compact binary records to a sequence of segment files. Each
+ *          segment has a sparse index of the record times so ranges of
+ *          time can be scanned without reading the whole log.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <chrono>
+#include <algorithm>
+#include "DeviceDataLog.h"
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** extension of the segment files */
+#define DEVICEDATALOG_EXT_LOG               "log"
+
+/** extension of the index files */
+#define DEVICEDATALOG_EXT_IDX               "idx"
+
+
+/*
+ * --- Methods Definition ----------------------------------------------------- *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* DeviceDataLog()
+*/
+DeviceDataLog::DeviceDataLog( const std::string& prefix, size_t segSize,
+        size_t bufSize, size_t interval )
+    : m_prefix( prefix )
+    , m_segSize( segSize )
+    , m_interval( (interval > 0) ? interval : 1 )
+    , m_fd( -1 )
+    , m_buf( (bufSize > 0) ? bufSize : 1 )
+    , m_bufLen( 0 )
+    , m_lastIndex( 0 )
+    , m_lastTime( 0 )
+{
+    load();
+
+    /* A last segment that could not be rebuilt has no size. It is kept
+     * as it is and a new segment is started instead. */
+    if( (m_segments.empty() == false) && (m_segments.back().size > 0) &&
+        (m_segments.back().size < m_segSize) )
+    {
+        /* continue the last segment, its index is written again
+         * when the segment is closed */
+        m_fd = open( path( m_segments.back().num, DEVICEDATALOG_EXT_LOG ).c_str(),
+            O_WRONLY | O_APPEND );
+        unlink( path( m_segments.back().num, DEVICEDATALOG_EXT_IDX ).c_str() );
+    }
+
+    if( m_fd < 0 )
+        roll();
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* ~DeviceDataLog()
+*/
+DeviceDataLog::~DeviceDataLog( void )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+    closeSegment();
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* append()
+*/
+int16_t DeviceDataLog::append( uint32_t handle, const DeviceDataValue& val,
+        uint64_t time )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+    s_recHeader hdr;
+    const uint8_t* p_data;
+    DeviceDataValue::u_val num;
+
+    if( m_fd < 0 )
+        return -1;
+
+    /* keep the records sorted */
+    if( time < m_lastTime )
+        time = m_lastTime;
+
+    memset( &hdr, 0, sizeof(hdr) );
+    hdr.handle = handle;
+    hdr.time = time;
+    hdr.type = (uint8_t)val.getType();
+
+    if( DeviceDataValue::isNumeric( (DeviceDataValue::e_type)val.getType() ) )
+    {
+        num = val.getVal();
+        p_data = (const uint8_t*)&num;
+        hdr.len = sizeof(num);
+    }
+    else
+    {
+        p_data = val.getOpaque();
+        hdr.len = val.getLen();
+    }
+    hdr.size = (uint32_t)(sizeof(hdr) + align( hdr.len ));
+
+    /* start a new segment if the record does not fit anymore */
+    if( (m_segments.back().index.empty() == false) &&
+        ((m_segments.back().size + hdr.size) > m_segSize) )
+    {
+        if( roll() != 0 )
+            return -1;
+    }
+
+    if( (m_bufLen + hdr.size) > m_buf.size() )
+    {
+        if( writeBuf() != 0 )
+            return -1;
+        if( hdr.size > m_buf.size() )
+            m_buf.resize( hdr.size );
+    }
+
+    /* copy the record to the buffer */
+    uint8_t* p = &m_buf[m_bufLen];
+    memcpy( p, &hdr, sizeof(hdr) );
+    memcpy( p + sizeof(hdr), p_data, hdr.len );
+    memset( p + sizeof(hdr) + hdr.len, 0, hdr.size - sizeof(hdr) - hdr.len );
+    m_bufLen += hdr.size;
+
+    /* add an index entry for the first record and after each interval */
+    s_segment& seg = m_segments.back();
+    if( seg.index.empty() || ((seg.size - m_lastIndex) >= m_interval) )
+    {
+        s_index idx = { time, seg.size };
+        seg.index.push_back( idx );
+        m_lastIndex = seg.size;
+    }
+
+    seg.size += hdr.size;
+    m_lastTime = time;
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* flush()
+*/
+int16_t DeviceDataLog::flush( void )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+    return writeBuf();
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* scan()
+*/
+size_t DeviceDataLog::scan( uint64_t from, uint64_t to, const t_record& cb,
+        uint32_t handle )
+{
+    std::vector< s_segment > segments;
+    size_t ret = 0;
+
+    {
+        /* the segments are read from the files. Segments only grow, so
+         * a snapshot can be scanned while records are appended. */
+        std::lock_guard< std::mutex > lock( m_mutex );
+        writeBuf();
+        segments = m_segments;
+    }
+
+    for( size_t i = 0; i < segments.size(); i++ )
+    {
+        const s_segment& seg = segments[i];
+
+        if( seg.index.empty() )
+            continue;
+
+        /* the segments are sorted by time */
+        if( seg.index.front().time > to )
+            break;
+
+        if( ((i + 1) < segments.size()) &&
+            (segments[i + 1].index.empty() == false) &&
+            (segments[i + 1].index.front().time < from) )
+            continue;
+
+        ret += scan( seg, from, to, cb, handle );
+    }
+
+    return ret;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* getNumSegments()
+*/
+size_t DeviceDataLog::getNumSegments( void )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+    return m_segments.size();
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* now()
+*/
+uint64_t DeviceDataLog::now( void )
+{
+    return (uint64_t)std::chrono::duration_cast< std::chrono::microseconds >(
+        std::chrono::system_clock::now().time_since_epoch() ).count();
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* path()
+*/
+std::string DeviceDataLog::path( uint32_t num, const char* ext ) const
+{
+    char buf[32];
+    snprintf( buf, sizeof(buf), ".%08u.%s", num, ext );
+    return m_prefix + buf;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* load()
+*/
+void DeviceDataLog::load( void )
+{
+    std::string dir = ".";
+    std::string base = m_prefix;
+    size_t pos = m_prefix.rfind( '/' );
+
+    if( pos != std::string::npos )
+    {
+        dir = (pos == 0) ? std::string( "/" ) : m_prefix.substr( 0, pos );
+        base = m_prefix.substr( pos + 1 );
+    }
+
+    DIR* p_dir = opendir( dir.c_str() );
+    if( p_dir == NULL )
+        return;
+
+    /* search for the segments <base>.<number>.log */
+    struct dirent* p_ent;
+    while( (p_ent = readdir( p_dir )) != NULL )
+    {
+        std::string name( p_ent->d_name );
+        std::string ext = std::string( "." ) + DEVICEDATALOG_EXT_LOG;
+
+        if( (name.length() <= (base.length() + 1 + ext.length())) ||
+            (name.compare( 0, base.length() + 1, base + "." ) != 0) ||
+            (name.compare( name.length() - ext.length(), ext.length(), ext ) != 0) )
+            continue;
+
+        std::string digits = name.substr( base.length() + 1,
+            name.length() - base.length() - 1 - ext.length() );
+        if( digits.find_first_not_of( "0123456789" ) != std::string::npos )
+            continue;
+
+        s_segment seg;
+        seg.num = (uint32_t)strtoul( digits.c_str(), NULL, 10 );
+        seg.size = 0;
+        m_segments.push_back( seg );
+    }
+    closedir( p_dir );
+
+    std::sort( m_segments.begin(), m_segments.end(),
+        []( const s_segment& a, const s_segment& b ) { return a.num < b.num; } );
+
+    for( size_t i = 0; i < m_segments.size(); i++ )
+    {
+        s_segment& seg = m_segments[i];
+        struct stat st;
+        bool loaded = false;
+
+        /* use the index of a closed segment */
+        if( ((i + 1) < m_segments.size()) &&
+            (stat( path( seg.num, DEVICEDATALOG_EXT_LOG ).c_str(), &st ) == 0) )
+        {
+            FILE* p_file = fopen( path( seg.num, DEVICEDATALOG_EXT_IDX ).c_str(), "rb" );
+            if( p_file != NULL )
+            {
+                s_index idx;
+                while( fread( &idx, sizeof(idx), 1, p_file ) == 1 )
+                    seg.index.push_back( idx );
+                fclose( p_file );
+
+                seg.size = (uint64_t)st.st_size;
+                loaded = true;
+            }
+        }
+
+        /* the last segment is continued and needs the exact state */
+        if( loaded == false )
+            rebuild( seg );
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* rebuild()
+*/
+int16_t DeviceDataLog::rebuild( s_segment& seg )
+{
+    std::string file = path( seg.num, DEVICEDATALOG_EXT_LOG );
+    struct stat st;
+    uint64_t offset = sizeof(s_segHeader);
+
+    seg.index.clear();
+    seg.size = 0;
+
+    int fd = open( file.c_str(), O_RDWR );
+    if( fd < 0 )
+        return -1;
+
+    if( (fstat( fd, &st ) != 0) || ((size_t)st.st_size < sizeof(s_segHeader)) )
+    {
+        close( fd );
+        return -1;
+    }
+
+    void* p = mmap( NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0 );
+    if( p == MAP_FAILED )
+    {
+        close( fd );
+        return -1;
+    }
+
+    const uint8_t* p_base = (const uint8_t*)p;
+    const s_segHeader* p_seg = (const s_segHeader*)p_base;
+
+    if( (p_seg->magic == DEVICEDATALOG_MAGIC) &&
+        (p_seg->version == DEVICEDATALOG_VERSION) )
+    {
+        /* read all the complete records */
+        while( (offset + sizeof(s_recHeader)) <= (uint64_t)st.st_size )
+        {
+            const s_recHeader* p_rec = (const s_recHeader*)(p_base + offset);
+
+            if( (p_rec->size < sizeof(s_recHeader)) ||
+                ((offset + p_rec->size) > (uint64_t)st.st_size) )
+                break;
+
+            if( seg.index.empty() || ((offset - m_lastIndex) >= m_interval) )
+            {
+                s_index idx = { p_rec->time, offset };
+                seg.index.push_back( idx );
+                m_lastIndex = offset;
+            }
+
+            m_lastTime = p_rec->time;
+            offset += p_rec->size;
+        }
+        seg.size = offset;
+    }
+    munmap( p, st.st_size );
+
+    /* cut off a record written partially */
+    if( (seg.size > 0) && (seg.size < (uint64_t)st.st_size) )
+    {
+        if( ftruncate( fd, seg.size ) != 0 )
+            seg.size = st.st_size;
+    }
+    close( fd );
+
+    return (seg.size > 0) ? 0 : -1;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* roll()
+*/
+int16_t DeviceDataLog::roll( void )
+{
+    s_segment seg;
+    s_segHeader hdr;
+
+    closeSegment();
+
+    seg.num = m_segments.empty() ? 0 : (m_segments.back().num + 1);
+    seg.size = sizeof(hdr);
+
+    m_fd = open( path( seg.num, DEVICEDATALOG_EXT_LOG ).c_str(),
+        O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644 );
+    if( m_fd < 0 )
+        return -1;
+
+    memset( &hdr, 0, sizeof(hdr) );
+    hdr.magic = DEVICEDATALOG_MAGIC;
+    hdr.version = DEVICEDATALOG_VERSION;
+
+    if( write( m_fd, &hdr, sizeof(hdr) ) != (ssize_t)sizeof(hdr) )
+    {
+        close( m_fd );
+        m_fd = -1;
+        return -1;
+    }
+
+    m_segments.push_back( seg );
+    m_lastIndex = 0;
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* closeSegment()
+*/
+void DeviceDataLog::closeSegment( void )
+{
+    if( m_fd < 0 )
+        return;
+
+    writeBuf();
+    close( m_fd );
+    m_fd = -1;
+
+    /* write the index of the segment */
+    const s_segment& seg = m_segments.back();
+    FILE* p_file = fopen( path( seg.num, DEVICEDATALOG_EXT_IDX ).c_str(), "wb" );
+    if( p_file != NULL )
+    {
+        if( seg.index.empty() == false )
+            fwrite( &seg.index[0], sizeof(s_index), seg.index.size(), p_file );
+        fclose( p_file );
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* writeBuf()
+*/
+int16_t DeviceDataLog::writeBuf( void )
+{
+    size_t done = 0;
+
+    if( m_fd < 0 )
+        return -1;
+
+    while( done < m_bufLen )
+    {
+        ssize_t len = write( m_fd, &m_buf[done], m_bufLen - done );
+        if( len <= 0 )
+            return -1;
+        done += len;
+    }
+    m_bufLen = 0;
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* scan()
+*/
+size_t DeviceDataLog::scan( const s_segment& seg, uint64_t from, uint64_t to,
+        const t_record& cb, uint32_t handle )
+{
+    size_t ret = 0;
+
+    int fd = open( path( seg.num, DEVICEDATALOG_EXT_LOG ).c_str(), O_RDONLY );
+    if( fd < 0 )
+        return 0;
+
+    void* p = mmap( NULL, seg.size, PROT_READ, MAP_SHARED, fd, 0 );
+    close( fd );
+    if( p == MAP_FAILED )
+        return 0;
+
+    const uint8_t* p_base = (const uint8_t*)p;
+
+    /* start at the last index entry before the range */
+    std::vector< s_index >::const_iterator it = std::lower_bound(
+        seg.index.begin(), seg.index.end(), from,
+        []( const s_index& idx, uint64_t time ) { return idx.time < time; } );
+    if( it != seg.index.begin() )
+        --it;
+    uint64_t offset = it->offset;
+
+    /* one value of each type is reused for all the records */
+    std::vector< DeviceDataValue > vals;
+    for( int t = 0; t < DEVICEDATAVALUE_TYPES; t++ )
+        vals.push_back( DeviceDataValue( (DeviceDataValue::e_type)t ) );
+
+    while( (offset + sizeof(s_recHeader)) <= seg.size )
+    {
+        const s_recHeader* p_rec = (const s_recHeader*)(p_base + offset);
+        const uint8_t* p_data = p_base + offset + sizeof(s_recHeader);
+
+        /* stop at a corrupt record instead of reading beyond the map */
+        if( (p_rec->size < sizeof(s_recHeader)) ||
+            ((offset + p_rec->size) > seg.size) ||
+            (p_rec->len > (p_rec->size - sizeof(s_recHeader))) ||
+            (DeviceDataValue::isNumeric( (DeviceDataValue::e_type)p_rec->type ) &&
+                (p_rec->len < sizeof(DeviceDataValue::u_val))) )
+            break;
+        offset += p_rec->size;
+
+        if( p_rec->time > to )
+            break;
+        if( (p_rec->time < from) || (p_rec->type >= DEVICEDATAVALUE_TYPES) ||
+            ((handle != UINT32_MAX) && (p_rec->handle != handle)) )
+            continue;
+
+        DeviceDataValue& val = vals[p_rec->type];
+        DeviceDataValue::u_val num;
+
+        switch( p_rec->type )
+        {
+            case DeviceDataValue::TYPE_INTEGER:
+                memcpy( &num, p_data, sizeof(num) );
+                val.setVal( num.i32 );
+                break;
+            case DeviceDataValue::TYPE_FLOAT:
+                memcpy( &num, p_data, sizeof(num) );
+                val.setVal( num.f );
+                break;
+            case DeviceDataValue::TYPE_INTEGER64:
+                memcpy( &num, p_data, sizeof(num) );
+                val.setVal( num.i64 );
+                break;
+            case DeviceDataValue::TYPE_DOUBLE:
+                memcpy( &num, p_data, sizeof(num) );
+                val.setVal( num.d );
+                break;
+            case DeviceDataValue::TYPE_STRING:
+                val.setVal( (const char*)p_data, p_rec->len );
+                break;
+            case DeviceDataValue::TYPE_OPAQUE:
+                val.setVal( p_data, p_rec->len );
+                break;
+        }
+
+        cb( p_rec->time, p_rec->handle, val );
+        ret++;
+    }
+
+    munmap( p, seg.size );
+    return ret;
+}
@@ -0,0 +1,345 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataLog.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Append-only binary log of device data values.
+ *
+ *          The log records the values of many device data elements as
+ *          compact binary records to a sequence of segment files. Each
+ *          segment has a sparse index of the record times so ranges of
+ *          time can be scanned without reading the whole log.
+ */
+
+
+#ifndef __DEVICEDATALOG_H__
+#define __DEVICEDATALOG_H__
+#ifndef __DECL_DEVICEDATALOG_H__
+#define __DECL_DEVICEDATALOG_H__ extern
+#endif /* #ifndef __DECL_DEVICEDATALOG_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <functional>
+#include "DeviceDataValue.h"
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** magic number at the beginning of a segment */
+#define DEVICEDATALOG_MAGIC                 0x31474f4c44444544ULL
+
+/** version of the segment layout */
+#define DEVICEDATALOG_VERSION               1
+
+/** default maximum size of a segment in bytes */
+#define DEVICEDATALOG_SEGMENT_SIZE          (64 * 1024 * 1024)
+
+/** default size of the write buffer in bytes */
+#define DEVICEDATALOG_BUF_SIZE              (64 * 1024)
+
+/** default distance of the index entries in bytes */
+#define DEVICEDATALOG_INDEX_INTERVAL        4096
+
+
+/*
+ * --- Class Definition ----------------------------------------------------- *
+ */
+
+/**
+ * \brief   DeviceDataLog Class.
+ *
+ *          Segments are named <prefix>.<number>.log and their indexes
+ *          <prefix>.<number>.idx. Records are buffered and written
+ *          sequentially. A segment is closed and a new one is started
+ *          once it reached its maximum size. Existing segments are
+ *          continued after a restart. Timestamps are given in us since
+ *          the epoch of the system clock and never decrease within
+ *          the log. Numbers are stored in the byte order of the host.
+ */
+class DeviceDataLog
+{
+
+public:
+
+    /**
+     * \brief   Handler called for the records of a scan.
+     *
+     *          Receives the timestamp, the handle of the element and the
+     *          value. The value is only valid during the call.
+     */
+    typedef std::function< void( uint64_t time, uint32_t handle,
+            const DeviceDataValue& val ) > t_record;
+
+    /** header of a segment */
+    struct s_segHeader
+    {
+        /** magic number */
+        uint64_t magic;
+        /** version of the layout */
+        uint32_t version;
+        /** reserved */
+        uint32_t reserved;
+    };
+
+    /** header of a record, followed by the value padded to 8 bytes */
+    struct s_recHeader
+    {
+        /** size of the record including the header */
+        uint32_t size;
+        /** handle of the element */
+        uint32_t handle;
+        /** timestamp in us since the epoch */
+        uint64_t time;
+        /** type of the value */
+        uint8_t type;
+        /** reserved */
+        uint8_t reserved[3];
+        /** length of a string or opaque value */
+        uint32_t len;
+    };
+
+    /** entry of the sparse index */
+    struct s_index
+    {
+        /** timestamp of the record */
+        uint64_t time;
+        /** offset of the record within the segment */
+        uint64_t offset;
+    };
+
+    /**
+     * \brief   Constructor to open or create a log.
+     *
+     * \param   prefix      Path and name prefix of the segments.
+     * \param   segSize     Maximum size of a segment in bytes.
+     * \param   bufSize     Size of the write buffer in bytes.
+     * \param   interval    Distance of the index entries in bytes.
+     */
+    DeviceDataLog( const std::string& prefix,
+            size_t segSize = DEVICEDATALOG_SEGMENT_SIZE,
+            size_t bufSize = DEVICEDATALOG_BUF_SIZE,
+            size_t interval = DEVICEDATALOG_INDEX_INTERVAL );
+
+    /**
+     * \brief   Default Destructor of the log.
+     *
+     *          Buffered records are written.
+     */
+    virtual ~DeviceDataLog( void );
+
+    /**
+     * \brief   Append a record.
+     *
+     * \param   handle  Handle of the element.
+     * \param   val     Value to record.
+     * \param   time    Timestamp in us since the epoch.
+     *
+     * \return  0 on success or -1 if the record could not be written.
+     */
+    int16_t append( uint32_t handle, const DeviceDataValue& val, uint64_t time );
+
+    /**
+     * \brief   Append a record taken now.
+     *
+     * \param   handle  Handle of the element.
+     * \param   val     Value to record.
+     *
+     * \return  0 on success or -1 if the record could not be written.
+     */
+    int16_t append( uint32_t handle, const DeviceDataValue& val ) {
+        return append( handle, val, now() );
+    }
+
+    /**
+     * \brief   Write the buffered records to the segment.
+     *
+     * \return  0 on success.
+     */
+    int16_t flush( void );
+
+    /**
+     * \brief   Scan the records within a time range.
+     *
+     *          The segments are mapped into memory for reading. Buffered
+     *          records are written before. The log is not locked while
+     *          the records are read, so the handler may append records.
+     *
+     * \param   from    Start of the range in us since the epoch (incl.).
+     * \param   to      End of the range in us since the epoch (incl.).
+     * \param   cb      Handler called for each record in ascending order.
+     * \param   handle  Handle of the element to scan or UINT32_MAX for
+     *                  all elements.
+     *
+     * \return  Number of records found.
+     */
+    size_t scan( uint64_t from, uint64_t to, const t_record& cb,
+            uint32_t handle = UINT32_MAX );
+
+    /**
+     * \brief   Get the number of segments.
+     *
+     * \return  Number of segments.
+     */
+    size_t getNumSegments( void );
+
+    /**
+     * \brief   Get the actual time.
+     *
+     * \return  Actual time in us since the epoch.
+     */
+    static uint64_t now( void );
+
+private:
+
+    /** segment of the log */
+    struct s_segment
+    {
+        /** number of the segment */
+        uint32_t num;
+        /** size of the segment */
+        uint64_t size;
+        /** sparse index */
+        std::vector< s_index > index;
+    };
+
+    /**
+     * \brief   Get the path of a segment file.
+     *
+     * \param   num     Number of the segment.
+     * \param   ext     Extension of the file.
+     *
+     * \return  The path.
+     */
+    std::string path( uint32_t num, const char* ext ) const;
+
+    /**
+     * \brief   Load the existing segments.
+     */
+    void load( void );
+
+    /**
+     * \brief   Build the index of a segment by reading it.
+     *
+     *          Used for segments that were not closed properly. Records
+     *          written partially are cut off.
+     *
+     * \param   seg     The segment.
+     *
+     * \return  0 on success.
+     */
+    int16_t rebuild( s_segment& seg );
+
+    /**
+     * \brief   Start a new segment.
+     *
+     * \return  0 on success.
+     */
+    int16_t roll( void );
+
+    /**
+     * \brief   Close the actual segment and write its index.
+     */
+    void closeSegment( void );
+
+    /**
+     * \brief   Write the buffered records.
+     *
+     * \return  0 on success.
+     */
+    int16_t writeBuf( void );
+
+    /**
+     * \brief   Scan the records of a segment.
+     *
+     * \param   seg     The segment.
+     * \param   from    Start of the range.
+     * \param   to      End of the range.
+     * \param   cb      Handler of the records.
+     * \param   handle  Handle of the element or UINT32_MAX.
+     *
+     * \return  Number of records found.
+     */
+    size_t scan( const s_segment& seg, uint64_t from, uint64_t to,
+            const t_record& cb, uint32_t handle );
+
+    /** round up to the alignment of the records */
+    static size_t align( size_t size ) {
+        return (size + 7) & ~(size_t)7;
+    }
+
+private:
+
+    /** path and name prefix of the segments */
+    std::string m_prefix;
+
+    /** maximum size of a segment */
+    size_t m_segSize;
+
+    /** distance of the index entries */
+    size_t m_interval;
+
+    /** segments, the last one is written */
+    std::vector< s_segment > m_segments;
+
+    /** file descriptor of the actual segment */
+    int m_fd;
+
+    /** write buffer */
+    std::vector< uint8_t > m_buf;
+
+    /** used size of the write buffer */
+    size_t m_bufLen;
+
+    /** offset of the last index entry */
+    uint64_t m_lastIndex;
+
+    /** timestamp of the last record */
+    uint64_t m_lastTime;
+
+    /** protects the log */
+    std::mutex m_mutex;
+};
+
+#endif /* #ifndef __DEVICEDATALOG_H__ */
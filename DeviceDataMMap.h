@@ -0,0 +1,265 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataMMap.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Description of the memory mapped device data element.
+ *
+ *          The memory mapped device data element keeps its value within
+ *          a record of a memory mapped store shared by many elements.
+ */
+#ifndef __DEVICEDATAMMAP_H__
+#define __DEVICEDATAMMAP_H__
+
+#ifndef __DECL_DEVICEDATAMMAP_H__
+#define __DECL_DEVICEDATAMMAP_H__ extern
+#endif /* #ifndef __DECL_DEVICEDATAMMAP_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <iostream>
+#include <atomic>
+#include "DeviceData.h"
+#include "DeviceDataMMapStore.h"
+#include "DeviceDataTimer.h"
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** interval the record of an observed element is checked in ms */
+#define DEVICEDATAMMAP_OBSERVE_MS           100
+
+
+/*
+ * --- Class Definition ----------------------------------------------------- *
+ */
+
+/**
+ * \brief   Memory Mapped Device Data Class.
+ *
+ *          Compared to DeviceDataFile a read is a copy from memory and a
+ *          write a copy to memory. No file is opened per element. While
+ *          the element is observed the sequence of its record is checked
+ *          periodically using the timer of the device data elements, so
+ *          writes of other processes are reported as well.
+ */
+class DeviceDataMMap
+        : public DeviceData
+        , private DeviceDataTimer::Entry
+{
+
+public:
+
+    /**
+     * \brief   Constructor with a specific default name and description.
+     *
+     *          The record of the element is taken from the store. If
+     *          the store has no record left all accesses fail.
+     *
+     * \param   name    Name of the device data element.
+     * \param   descr   Description of the device data element.
+     * \param   type    Type of the data value.
+     * \param   access  Access permissions.
+     * \param   p_store Store keeping the value.
+     */
+    DeviceDataMMap( std::string name, std::string descr, DeviceDataValue::e_type type,
+            int access, DeviceDataMMapStore* p_store )
+        : DeviceData( name, descr, type, access )
+        , mp_store( p_store )
+        , m_handle( DeviceDataMMapStore::HANDLE_INVALID )
+        , mp_timer( NULL )
+        , m_watched( false )
+        , m_seq( 0 ) {
+
+        if( mp_store != NULL )
+            m_handle = mp_store->alloc( name, type );
+    };
+
+    /**
+     * \brief   Default Destructor of the element.
+     *
+     *          The record is kept, so the value survives a restart.
+     *          Use DeviceDataMMapStore::free() to drop it.
+     */
+    virtual ~DeviceDataMMap( void ) {
+        /* no more checks of the record */
+        unobserveValNative();
+
+        /* deliver the queued notifications while the element is complete */
+        shutdown();
+    };
+
+    /**
+     * \brief   Get the handle of the record within the store.
+     *
+     * \return  The handle or HANDLE_INVALID if no record was available.
+     */
+    DeviceDataMMapStore::t_handle getHandle( void ) const {
+        return m_handle;
+    }
+
+    /**
+     * \brief   Get the name of the backend of the element.
+     *
+     * \return  The name of the backend.
+     */
+    virtual const char* getBackend( void ) const {
+        return "mmap";
+    }
+
+private:
+
+    /**
+     * \brief   Native read function to get the device data value.
+     *
+     * \return  0 on success.
+     */
+    virtual int16_t getValNative( DeviceDataValue* val ) {
+        if( m_handle == DeviceDataMMapStore::HANDLE_INVALID )
+            return -1;
+        return mp_store->read( m_handle, val );
+    }
+
+    /**
+     * \brief   Native write function to get the device data value.
+     *
+     * \return  0 on success.
+     */
+    virtual int16_t setValNative( const DeviceDataValue* val ) {
+        uint32_t seq;
+
+        if( m_handle == DeviceDataMMapStore::HANDLE_INVALID )
+            return -1;
+        if( mp_store->write( m_handle, val, &seq ) != 0 )
+            return -1;
+
+        /* the caller reports the value written, so the check of the
+         * record skips it */
+        m_seq = seq;
+        return 0;
+    }
+
+    /**
+     * \brief   Native function to observe the device data value.
+     *
+     *          Starts checking the record for new values.
+     *
+     * \return  0 on success or -1 if the element has no record.
+     */
+    virtual int8_t observeValNative( bool = true ) {
+        uint32_t seq;
+
+        if( m_handle == DeviceDataMMapStore::HANDLE_INVALID )
+            return -1;
+        if( m_watched )
+            return 0;
+
+        /* observed values are not read anymore, so start with the
+         * actual content of the record */
+        {
+            std::unique_lock< std::mutex > lock( lockValStorage() );
+            if( mp_store->read( m_handle, getValStorage(), &seq ) != 0 )
+                return -1;
+        }
+        m_seq = seq;
+
+        mp_timer = getTimer();
+        m_watched = true;
+        return (mp_timer->start( this, DEVICEDATAMMAP_OBSERVE_MS ) == 0) ? 0 : -1;
+    }
+
+    /**
+     * \brief   Native function to stop observing the device data value.
+     *
+     *          The record is not checked anymore.
+     *
+     * \return  0 on success.
+     */
+    virtual int8_t unobserveValNative( void ) {
+        if( m_watched == false )
+            return 0;
+
+        m_watched = false;
+        mp_timer->stop( this );
+
+        /* a check running in the meantime might have restarted the timer */
+        mp_timer->stop( this );
+        return 0;
+    }
+
+    /**
+     * \brief   Check the record for a new value.
+     *
+     *          Called from the timer thread while the element is observed.
+     */
+    virtual void expired( void ) {
+        /* the value read is converted to the type of the element */
+        DeviceDataValue val( getValType() );
+        uint32_t last = m_seq;
+        uint32_t seq = mp_store->getSeq( m_handle );
+
+        if( (seq != last) && ((seq & 1) == 0) &&
+            (mp_store->read( m_handle, &val, &seq ) == 0) &&
+            m_seq.compare_exchange_strong( last, seq ) )
+            valueChanged( &val );
+
+        if( m_watched )
+            mp_timer->start( this, DEVICEDATAMMAP_OBSERVE_MS );
+    }
+
+private:
+
+    /** store keeping the value */
+    DeviceDataMMapStore* mp_store;
+
+    /** handle of the record */
+    DeviceDataMMapStore::t_handle m_handle;
+
+    /** timer checking the record */
+    DeviceDataTimer* mp_timer;
+
+    /** the record is checked for new values */
+    std::atomic<bool> m_watched;
+
+    /** sequence of the record last reported */
+    std::atomic<uint32_t> m_seq;
+};
+
+#endif /* #ifndef __DEVICEDATAMMAP_H__ */
@@ -0,0 +1,404 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataMMapStore.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Memory mapped store of many device data values.
+ *
+ *          The store keeps the values of many device data elements in a
+ *          single file of fixed size records that is mapped into memory.
+ *          Other processes can map the same file to read or write the
+ *          values.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <thread>
+#include "DeviceDataMMapStore.h"
+
+
+/*
+ * --- Methods Definition ----------------------------------------------------- *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* DeviceDataMMapStore()
+*/
+DeviceDataMMapStore::DeviceDataMMapStore( const std::string& path,
+        uint32_t numRecords, uint32_t recordSize )
+    : m_fd( -1 )
+    , mp_base( NULL )
+    , m_size( 0 )
+    , m_numRecords( 0 )
+    , m_recordSize( 0 )
+{
+    m_fd = open( path.c_str(), O_RDWR | O_CREAT, 0644 );
+    if( m_fd < 0 )
+        return;
+
+    if( map( numRecords, recordSize ) != 0 )
+    {
+        close( m_fd );
+        m_fd = -1;
+        return;
+    }
+
+    /* index the records in use */
+    for( t_handle i = 0; i < m_numRecords; i++ )
+    {
+        s_record* p_rec = record( i );
+        if( p_rec->used )
+            m_index[std::string( p_rec->name )] = i;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* ~DeviceDataMMapStore()
+*/
+DeviceDataMMapStore::~DeviceDataMMapStore( void )
+{
+    if( mp_base != NULL )
+        munmap( mp_base, m_size );
+    if( m_fd >= 0 )
+        close( m_fd );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* alloc()
+*/
+DeviceDataMMapStore::t_handle DeviceDataMMapStore::alloc(
+        const std::string& name, DeviceDataValue::e_type type )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    if( (mp_base == NULL) || (name.length() >= DEVICEDATAMMAPSTORE_NAME_MAX) )
+        return HANDLE_INVALID;
+
+    std::unordered_map< std::string, t_handle >::iterator it = m_index.find( name );
+    if( it != m_index.end() )
+    {
+        /* use the existing record if the type matches */
+        if( record( it->second )->type != type )
+            return HANDLE_INVALID;
+        return it->second;
+    }
+
+    for( t_handle i = 0; i < m_numRecords; i++ )
+    {
+        s_record* p_rec = record( i );
+        if( p_rec->used )
+            continue;
+
+        p_rec->type = (uint8_t)type;
+        p_rec->len.store( 0, std::memory_order_relaxed );
+        memset( p_rec->name, 0, sizeof(p_rec->name) );
+        memcpy( p_rec->name, name.c_str(), name.length() );
+        memset( payload( p_rec ), 0, getPayloadSize() );
+        p_rec->seq.store( 0, std::memory_order_relaxed );
+
+        /* publish the record */
+        std::atomic_thread_fence( std::memory_order_release );
+        p_rec->used = 1;
+
+        m_index[name] = i;
+        return i;
+    }
+
+    return HANDLE_INVALID;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* free()
+*/
+void DeviceDataMMapStore::free( t_handle handle )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    if( (mp_base == NULL) || (handle >= m_numRecords) )
+        return;
+
+    s_record* p_rec = record( handle );
+    if( p_rec->used )
+    {
+        m_index.erase( std::string( p_rec->name ) );
+        p_rec->used = 0;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* find()
+*/
+DeviceDataMMapStore::t_handle DeviceDataMMapStore::find( const std::string& name )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    std::unordered_map< std::string, t_handle >::iterator it = m_index.find( name );
+    if( it == m_index.end() )
+        return HANDLE_INVALID;
+    return it->second;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* read()
+*/
+int16_t DeviceDataMMapStore::read( t_handle handle, DeviceDataValue* val,
+        uint32_t* p_seq ) const
+{
+    uint8_t buf[DEVICEDATAMMAPSTORE_RECORD_MAX];
+    DeviceDataValue::u_val num;
+    uint32_t len;
+    uint8_t type;
+    uint32_t seq;
+
+    if( (mp_base == NULL) || (handle >= m_numRecords) || (val == NULL) )
+        return -1;
+
+    s_record* p_rec = record( handle );
+
+    /* copy the record until no write happened in the meantime */
+    while( true )
+    {
+        seq = p_rec->seq.load( std::memory_order_acquire );
+        if( seq & 1 )
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        type = p_rec->type;
+        len = p_rec->len.load( std::memory_order_relaxed );
+        if( len > getPayloadSize() )
+            len = 0;
+
+        if( DeviceDataValue::isNumeric( (DeviceDataValue::e_type)type ) )
+            loadPayload( p_rec, &num, sizeof(num) );
+        else
+            loadPayload( p_rec, buf, len );
+
+        std::atomic_thread_fence( std::memory_order_acquire );
+        if( p_rec->seq.load( std::memory_order_relaxed ) == seq )
+            break;
+    }
+
+    if( p_seq != NULL )
+        *p_seq = seq;
+
+    switch( type )
+    {
+        case DeviceDataValue::TYPE_INTEGER:
+            return val->setVal( num.i32 );
+        case DeviceDataValue::TYPE_FLOAT:
+            return val->setVal( num.f );
+        case DeviceDataValue::TYPE_INTEGER64:
+            return val->setVal( num.i64 );
+        case DeviceDataValue::TYPE_DOUBLE:
+            return val->setVal( num.d );
+        case DeviceDataValue::TYPE_STRING:
+            return val->setVal( (const char*)buf, len );
+        case DeviceDataValue::TYPE_OPAQUE:
+            return val->setVal( (const uint8_t*)buf, len );
+        default:
+            return -1;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* write()
+*/
+int16_t DeviceDataMMapStore::write( t_handle handle, const DeviceDataValue* val,
+        uint32_t* p_seq )
+{
+    if( (mp_base == NULL) || (handle >= m_numRecords) || (val == NULL) )
+        return -1;
+
+    s_record* p_rec = record( handle );
+    DeviceDataValue conv( (DeviceDataValue::e_type)p_rec->type );
+
+    /* the record keeps its type, readers rely on it */
+    if( val->getType() != p_rec->type )
+    {
+        if( conv.convert( *val ) != 0 )
+            return -3;
+        val = &conv;
+    }
+
+    if( (DeviceDataValue::isNumeric( (DeviceDataValue::e_type)val->getType() ) == false) &&
+        (val->getLen() > getPayloadSize()) )
+        return -2;
+
+    /* lock the record by making the sequence odd. This also works
+     * against writers of other processes. */
+    uint32_t seq = p_rec->seq.load( std::memory_order_relaxed );
+    while( (seq & 1) || (p_rec->seq.compare_exchange_weak( seq, seq + 1,
+            std::memory_order_acquire ) == false) )
+    {
+        if( seq & 1 )
+        {
+            std::this_thread::yield();
+            seq = p_rec->seq.load( std::memory_order_relaxed );
+        }
+    }
+    std::atomic_thread_fence( std::memory_order_release );
+
+    if( DeviceDataValue::isNumeric( (DeviceDataValue::e_type)val->getType() ) )
+    {
+        DeviceDataValue::u_val num = val->getVal();
+        storePayload( p_rec, &num, sizeof(num) );
+        p_rec->len.store( 0, std::memory_order_relaxed );
+    }
+    else
+    {
+        storePayload( p_rec, val->getOpaque(), val->getLen() );
+        p_rec->len.store( val->getLen(), std::memory_order_relaxed );
+    }
+
+    /* unlock and publish the new value */
+    p_rec->seq.store( seq + 2, std::memory_order_release );
+
+    if( p_seq != NULL )
+        *p_seq = seq + 2;
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* loadPayload()
+*/
+void DeviceDataMMapStore::loadPayload( s_record* p_rec, void* p_dst, size_t len )
+{
+    /* the payload is aligned and its size a multiple of the word size */
+    const std::atomic<uint32_t>* p_word = (const std::atomic<uint32_t>*)payload( p_rec );
+    uint8_t* p = (uint8_t*)p_dst;
+    uint32_t word;
+
+    for( size_t i = 0; i < len; i += sizeof(word) )
+    {
+        word = p_word[i / sizeof(word)].load( std::memory_order_relaxed );
+        memcpy( p + i, &word, std::min( sizeof(word), len - i ) );
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* storePayload()
+*/
+void DeviceDataMMapStore::storePayload( s_record* p_rec, const void* p_src, size_t len )
+{
+    std::atomic<uint32_t>* p_word = (std::atomic<uint32_t>*)payload( p_rec );
+    const uint8_t* p = (const uint8_t*)p_src;
+    uint32_t word;
+
+    for( size_t i = 0; i < len; i += sizeof(word) )
+    {
+        word = 0;
+        memcpy( &word, p + i, std::min( sizeof(word), len - i ) );
+        p_word[i / sizeof(word)].store( word, std::memory_order_relaxed );
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* map()
+*/
+int16_t DeviceDataMMapStore::map( uint32_t numRecords, uint32_t recordSize )
+{
+    struct stat st;
+    s_header hdr;
+
+    if( fstat( m_fd, &st ) != 0 )
+        return -1;
+
+    if( st.st_size == 0 )
+    {
+        /* create a new store */
+        if( (recordSize < (sizeof(s_record) + sizeof(DeviceDataValue::u_val))) ||
+            (recordSize > DEVICEDATAMMAPSTORE_RECORD_MAX) || (numRecords == 0) )
+            return -1;
+
+        /* keep the sequence counters aligned */
+        recordSize = (recordSize + 7) & ~7U;
+
+        memset( &hdr, 0, sizeof(hdr) );
+        hdr.magic = DEVICEDATAMMAPSTORE_MAGIC;
+        hdr.version = DEVICEDATAMMAPSTORE_VERSION;
+        hdr.recordSize = recordSize;
+        hdr.numRecords = numRecords;
+
+        if( ftruncate( m_fd, sizeof(hdr) + (off_t)numRecords * recordSize ) != 0 )
+            return -1;
+        if( pwrite( m_fd, &hdr, sizeof(hdr), 0 ) != (ssize_t)sizeof(hdr) )
+            return -1;
+    }
+    else
+    {
+        /* use the layout of the existing store */
+        if( pread( m_fd, &hdr, sizeof(hdr), 0 ) != (ssize_t)sizeof(hdr) )
+            return -1;
+        if( (hdr.magic != DEVICEDATAMMAPSTORE_MAGIC) ||
+            (hdr.version != DEVICEDATAMMAPSTORE_VERSION) ||
+            (hdr.recordSize < (sizeof(s_record) + sizeof(DeviceDataValue::u_val))) ||
+            (hdr.recordSize > DEVICEDATAMMAPSTORE_RECORD_MAX) ||
+            ((hdr.recordSize & 7) != 0) ||
+            ((off_t)(sizeof(hdr) + (off_t)hdr.numRecords * hdr.recordSize) > st.st_size) )
+            return -1;
+    }
+
+    m_numRecords = hdr.numRecords;
+    m_recordSize = hdr.recordSize;
+    m_size = sizeof(hdr) + (size_t)m_numRecords * m_recordSize;
+
+    void* p = mmap( NULL, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0 );
+    if( p == MAP_FAILED )
+        return -1;
+
+    mp_base = (uint8_t*)p;
+    return 0;
+}
@@ -0,0 +1,354 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataMMapStore.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Memory mapped store of many device data values.
+ *
+ *          The store keeps the values of many device data elements in a
+ *          single file of fixed size records that is mapped into memory.
+ *          Other processes can map the same file to read or write the
+ *          values.
+ */
+
+
+#ifndef __DEVICEDATAMMAPSTORE_H__
+#define __DEVICEDATAMMAPSTORE_H__
+#ifndef __DECL_DEVICEDATAMMAPSTORE_H__
+#define __DECL_DEVICEDATAMMAPSTORE_H__ extern
+#endif /* #ifndef __DECL_DEVICEDATAMMAPSTORE_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <string>
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include "DeviceDataValue.h"
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** magic number at the beginning of a store */
+#define DEVICEDATAMMAPSTORE_MAGIC           0x50414d4d44444544ULL
+
+/** version of the file layout */
+#define DEVICEDATAMMAPSTORE_VERSION         1
+
+/** default size of a record in bytes */
+#define DEVICEDATAMMAPSTORE_RECORD_SIZE     128
+
+/** maximum size of a record in bytes */
+#define DEVICEDATAMMAPSTORE_RECORD_MAX      4096
+
+/** maximum length of the name of a record including termination */
+#define DEVICEDATAMMAPSTORE_NAME_MAX        48
+
+
+/*
+ * --- Class Definition ----------------------------------------------------- *
+ */
+
+/**
+ * \brief   DeviceDataMMapStore Class.
+ *
+ *          The file starts with a header followed by the records. Each
+ *          record holds the name, the type and the value of a single
+ *          device data element and is identified by its index. Records
+ *          are updated using a sequence lock within the record so readers
+ *          never see partially written values, even from other processes.
+ *          Numbers are stored in the byte order of the host.
+ */
+class DeviceDataMMapStore
+{
+
+public:
+
+    /** handle of a record */
+    typedef uint32_t t_handle;
+
+    /** invalid handle */
+    static const t_handle HANDLE_INVALID = 0xFFFFFFFF;
+
+    /** header of the file */
+    struct s_header
+    {
+        /** magic number */
+        uint64_t magic;
+        /** version of the layout */
+        uint32_t version;
+        /** size of a record */
+        uint32_t recordSize;
+        /** number of records */
+        uint32_t numRecords;
+        /** reserved */
+        uint8_t reserved[44];
+    };
+
+    /** header of a record */
+    struct s_record
+    {
+        /** sequence counter, odd while the record is written */
+        std::atomic<uint32_t> seq;
+        /** record is in use */
+        uint8_t used;
+        /** type of the value */
+        uint8_t type;
+        /** reserved */
+        uint16_t reserved;
+        /** length of a string or opaque value */
+        std::atomic<uint32_t> len;
+        /** reserved */
+        uint32_t reserved2;
+        /** name of the element */
+        char name[DEVICEDATAMMAPSTORE_NAME_MAX];
+    };
+
+    /**
+     * \brief   Constructor to open or create a store.
+     *
+     *          An existing store is opened using its own layout. Otherwise
+     *          a new one is created using the given layout.
+     *
+     * \param   path        Path of the file.
+     * \param   numRecords  Number of records of a new store.
+     * \param   recordSize  Size of the records of a new store in bytes.
+     */
+    DeviceDataMMapStore( const std::string& path, uint32_t numRecords,
+            uint32_t recordSize = DEVICEDATAMMAPSTORE_RECORD_SIZE );
+
+    /**
+     * \brief   Default Destructor of the store.
+     *
+     *          The file is kept.
+     */
+    virtual ~DeviceDataMMapStore( void );
+
+    /**
+     * \brief   Check if the store was opened.
+     *
+     * \return  true if the store can be used.
+     */
+    bool isOpen( void ) const {
+        return mp_base != NULL;
+    }
+
+    /**
+     * \brief   Get a record for an element.
+     *
+     *          An existing record of the same name is used again, so the
+     *          values survive restarts. Otherwise a free record is taken.
+     *          Records shall only be allocated by a single process while
+     *          all processes can access the values.
+     *
+     * \param   name    Name of the element.
+     * \param   type    Type of the value.
+     *
+     * \return  Handle of the record or HANDLE_INVALID if no record is
+     *          free or the existing record has a different type.
+     */
+    t_handle alloc( const std::string& name, DeviceDataValue::e_type type );
+
+    /**
+     * \brief   Release a record.
+     *
+     * \param   handle  Handle of the record.
+     */
+    void free( t_handle handle );
+
+    /**
+     * \brief   Find the record of an element.
+     *
+     * \param   name    Name of the element.
+     *
+     * \return  Handle of the record or HANDLE_INVALID.
+     */
+    t_handle find( const std::string& name );
+
+    /**
+     * \brief   Read the value of a record.
+     *
+     *          The value read is converted to the type of val.
+     *
+     * \param   handle  Handle of the record.
+     * \param   val     Value to store the result to.
+     * \param   p_seq   Set to the sequence of the value read. Can be NULL.
+     *
+     * \return  0 on success or -1 if the handle is invalid.
+     */
+    int16_t read( t_handle handle, DeviceDataValue* val,
+            uint32_t* p_seq = NULL ) const;
+
+    /**
+     * \brief   Write the value of a record.
+     *
+     *          The value is converted to the type of the record.
+     *
+     * \param   handle  Handle of the record.
+     * \param   val     Value to write.
+     * \param   p_seq   Set to the sequence of the value written. Can be NULL.
+     *
+     * \return  0 on success, -1 if the handle is invalid, -2 if the
+     *          value does not fit into the record or -3 if the value
+     *          can not be converted to the type of the record.
+     */
+    int16_t write( t_handle handle, const DeviceDataValue* val,
+            uint32_t* p_seq = NULL );
+
+    /**
+     * \brief   Get the sequence of a record.
+     *
+     *          The sequence changes with every write, so comparing it is
+     *          a cheap check for a new value.
+     *
+     * \param   handle  Handle of the record.
+     *
+     * \return  The sequence, odd while the record is written.
+     */
+    uint32_t getSeq( t_handle handle ) const {
+        if( (mp_base == NULL) || (handle >= m_numRecords) )
+            return 0;
+        return record( handle )->seq.load( std::memory_order_acquire );
+    }
+
+    /**
+     * \brief   Get the number of records.
+     *
+     * \return  Number of records.
+     */
+    uint32_t getNumRecords( void ) const {
+        return m_numRecords;
+    }
+
+    /**
+     * \brief   Get the maximum size of string or opaque values.
+     *
+     * \return  Size in bytes.
+     */
+    uint32_t getPayloadSize( void ) const {
+        return m_recordSize - (uint32_t)sizeof(s_record);
+    }
+
+private:
+
+    /**
+     * \brief   Get a record.
+     *
+     * \param   handle  Handle of the record.
+     *
+     * \return  The record.
+     */
+    s_record* record( t_handle handle ) const {
+        return (s_record*)(mp_base + sizeof(s_header) +
+            (size_t)handle * m_recordSize);
+    }
+
+    /**
+     * \brief   Get the payload of a record.
+     *
+     * \param   p_rec   The record.
+     *
+     * \return  The payload.
+     */
+    static uint8_t* payload( s_record* p_rec ) {
+        return (uint8_t*)(p_rec + 1);
+    }
+
+    /**
+     * \brief   Copy from the payload of a record.
+     *
+     *          The payload is read word by word using atomic accesses, so
+     *          a copy overlapping a write is well defined. Such a copy is
+     *          discarded by the reader because the sequence changed.
+     *
+     * \param   p_rec   The record.
+     * \param   p_dst   Buffer to copy to.
+     * \param   len     Number of bytes to copy.
+     */
+    static void loadPayload( s_record* p_rec, void* p_dst, size_t len );
+
+    /**
+     * \brief   Copy to the payload of a record.
+     *
+     *          The counterpart of loadPayload(). The last word is filled
+     *          up with zeros.
+     *
+     * \param   p_rec   The record.
+     * \param   p_src   Data to copy.
+     * \param   len     Number of bytes to copy.
+     */
+    static void storePayload( s_record* p_rec, const void* p_src, size_t len );
+
+    /**
+     * \brief   Map the file.
+     *
+     * \param   numRecords  Number of records of a new store.
+     * \param   recordSize  Size of the records of a new store in bytes.
+     *
+     * \return  0 on success.
+     */
+    int16_t map( uint32_t numRecords, uint32_t recordSize );
+
+private:
+
+    /** file descriptor */
+    int m_fd;
+
+    /** mapped file */
+    uint8_t* mp_base;
+
+    /** size of the mapping */
+    size_t m_size;
+
+    /** number of records */
+    uint32_t m_numRecords;
+
+    /** size of a record */
+    uint32_t m_recordSize;
+
+    /** records in use by name */
+    std::unordered_map< std::string, t_handle > m_index;
+
+    /** protects the allocation of records */
+    std::mutex m_mutex;
+};
+
+#endif /* #ifndef __DEVICEDATAMMAPSTORE_H__ */
@@ -0,0 +1,568 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataMetrics.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Metrics of the accesses to device data elements.
+ *
+ *          The device data elements count their accesses, the latencies
+ *          and results of the native functions and the time needed to
+ *          notify their observers. The metrics are aggregated per scope,
+ *          i.e. per backend and device. Each thread counts to its own
+ *          counters, so counting needs neither locks nor atomic
+ *          read-modify-write operations. The counters of all the threads
+ *          are summed up when a snapshot is taken.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include "DeviceDataMetrics.h"
+#include <string.h>
+#include <mutex>
+#include <unordered_map>
+
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** backend reported for the overflow scope */
+#define DEVICEDATAMETRICS_OVERFLOW          "<overflow>"
+
+
+/*
+ * --- Local Class Definition ----------------------------------------------- *
+ */
+
+/** latency histogram of a single thread */
+struct s_histCnt
+{
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> sum;
+    std::atomic<uint64_t> max;
+    std::atomic<uint64_t> buckets[DEVICEDATAMETRICS_HIST_BUCKETS];
+};
+
+/** counters of a scope of a single thread */
+struct s_counters
+{
+    std::atomic<uint64_t> ops[DeviceDataMetrics::OP_MAX];
+    s_histCnt native[DeviceDataMetrics::NATIVE_MAX];
+    std::atomic<uint64_t> ret[DeviceDataMetrics::NATIVE_MAX][DEVICEDATAMETRICS_RET_BUCKETS];
+    s_histCnt fanout;
+    std::atomic<uint64_t> notified;
+    std::atomic<uint64_t> maxObservers;
+};
+
+/**
+ * \brief   Counters of a single thread.
+ *
+ *          Only the owning thread writes the counters. Other threads
+ *          only read them while taking a snapshot. The counters are
+ *          allocated in chunks of scopes when used the first time.
+ */
+class DeviceDataMetricsShard
+{
+
+public:
+
+    /**
+     * \brief   Default Constructor of the counters.
+     */
+    DeviceDataMetricsShard( void )
+        : m_used( true ) {
+        for( size_t i = 0; i < NUM_CHUNKS; i++ )
+            m_chunks[i] = NULL;
+    };
+
+    /**
+     * \brief   Get the counters of a scope for writing.
+     *
+     * \param   scope   Scope of the counters.
+     *
+     * \return  The counters.
+     */
+    s_counters* get( DeviceDataMetrics::t_scope scope ) {
+        std::atomic<s_counters*>& chunk = m_chunks[scope / DEVICEDATAMETRICS_CHUNK];
+        s_counters* p_chunk = chunk.load( std::memory_order_relaxed );
+
+        if( p_chunk == NULL )
+        {
+            /* value initialized, so all counters are 0 */
+            p_chunk = new s_counters[DEVICEDATAMETRICS_CHUNK]();
+            chunk.store( p_chunk, std::memory_order_release );
+        }
+        return &p_chunk[scope % DEVICEDATAMETRICS_CHUNK];
+    }
+
+    /**
+     * \brief   Get the counters of a scope for reading.
+     *
+     * \param   scope   Scope of the counters.
+     *
+     * \return  The counters or NULL if the scope was not used yet.
+     */
+    const s_counters* peek( DeviceDataMetrics::t_scope scope ) const {
+        s_counters* p_chunk = m_chunks[scope / DEVICEDATAMETRICS_CHUNK].load(
+            std::memory_order_acquire );
+
+        if( p_chunk == NULL )
+            return NULL;
+        return &p_chunk[scope % DEVICEDATAMETRICS_CHUNK];
+    }
+
+    /** a thread owns the counters */
+    bool m_used;
+
+private:
+
+    /** number of chunks */
+    static const size_t NUM_CHUNKS =
+        DEVICEDATAMETRICS_MAX_SCOPES / DEVICEDATAMETRICS_CHUNK;
+
+    /** chunks of the counters */
+    std::atomic<s_counters*> m_chunks[NUM_CHUNKS];
+};
+
+/**
+ * \brief   Registry of the scopes and the counters of all threads.
+ *
+ *          The registry is never deleted since threads might still count
+ *          while the static objects are destroyed.
+ */
+struct s_registry
+{
+    /** protects the registry */
+    std::mutex mutex;
+    /** scopes by backend and device */
+    std::unordered_map< std::string, DeviceDataMetrics::t_scope > index;
+    /** backends and devices of the scopes */
+    std::vector< std::pair< std::string, std::string > > scopes;
+    /** counters of all threads, including those that ended */
+    std::vector< DeviceDataMetricsShard* > shards;
+};
+
+/**
+ * \brief   Counters of the actual thread.
+ *
+ *          When the thread ends the counters are handed over to the
+ *          next new thread. The counts are kept.
+ */
+class DeviceDataMetricsHolder
+{
+
+public:
+
+    DeviceDataMetricsHolder( void )
+        : mp_shard( NULL ) {};
+
+    ~DeviceDataMetricsHolder( void );
+
+    /** counters of the thread */
+    DeviceDataMetricsShard* mp_shard;
+};
+
+
+/*
+ * --- Local Variables ------------------------------------------------------ *
+ */
+
+/** counters of the actual thread. The plain pointer is used for counting
+ *  since accessing it needs no initialization check. */
+static thread_local DeviceDataMetricsShard* gtp_shard = NULL;
+
+/** hands over the counters when the actual thread ends */
+static thread_local DeviceDataMetricsHolder gt_holder;
+
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* registry()
+*/
+static s_registry* registry( void )
+{
+    static s_registry* p_registry = new s_registry();
+    return p_registry;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* ~DeviceDataMetricsHolder()
+*/
+DeviceDataMetricsHolder::~DeviceDataMetricsHolder( void )
+{
+    if( mp_shard != NULL )
+    {
+        std::lock_guard< std::mutex > lock( registry()->mutex );
+        mp_shard->m_used = false;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* counters()
+*/
+static s_counters* counters( DeviceDataMetrics::t_scope scope )
+{
+    DeviceDataMetricsShard* p_shard = gtp_shard;
+
+    if( p_shard == NULL )
+    {
+        s_registry* p_reg = registry();
+        std::lock_guard< std::mutex > lock( p_reg->mutex );
+
+        /* take over the counters of an ended thread */
+        for( size_t i = 0; i < p_reg->shards.size(); i++ )
+        {
+            if( p_reg->shards[i]->m_used == false )
+            {
+                p_shard = p_reg->shards[i];
+                p_shard->m_used = true;
+                break;
+            }
+        }
+
+        if( p_shard == NULL )
+        {
+            p_shard = new DeviceDataMetricsShard();
+            p_reg->shards.push_back( p_shard );
+        }
+        gt_holder.mp_shard = p_shard;
+        gtp_shard = p_shard;
+    }
+
+    if( scope >= DEVICEDATAMETRICS_MAX_SCOPES )
+        scope = DeviceDataMetrics::SCOPE_OVERFLOW;
+    return p_shard->get( scope );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* add()
+*/
+static inline void add( std::atomic<uint64_t>& cnt, uint64_t val )
+{
+    /* only the owning thread writes, so no read-modify-write is needed */
+    cnt.store( cnt.load( std::memory_order_relaxed ) + val,
+        std::memory_order_relaxed );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* addMax()
+*/
+static inline void addMax( std::atomic<uint64_t>& cnt, uint64_t val )
+{
+    if( val > cnt.load( std::memory_order_relaxed ) )
+        cnt.store( val, std::memory_order_relaxed );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* addHist()
+*/
+static void addHist( s_histCnt& hist, uint64_t ns )
+{
+    uint64_t us = ns / 1000;
+    size_t bucket = 0;
+
+    /* bucket i counts latencies below 2^i us */
+    while( (us != 0) && (bucket < (DEVICEDATAMETRICS_HIST_BUCKETS - 1)) )
+    {
+        us >>= 1;
+        bucket++;
+    }
+
+    add( hist.count, 1 );
+    add( hist.sum, ns );
+    addMax( hist.max, ns );
+    add( hist.buckets[bucket], 1 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* retBucket()
+*/
+static inline size_t retBucket( int16_t ret )
+{
+    /* bucket i counts the return code -i */
+    if( (ret <= 0) && (-ret < (DEVICEDATAMETRICS_RET_BUCKETS - 1)) )
+        return (size_t)-ret;
+    return DEVICEDATAMETRICS_RET_BUCKETS - 1;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* sumHist()
+*/
+static void sumHist( DeviceDataMetrics::s_hist& sum, const s_histCnt& hist )
+{
+    sum.count += hist.count.load( std::memory_order_relaxed );
+    sum.sum += hist.sum.load( std::memory_order_relaxed );
+    if( hist.max.load( std::memory_order_relaxed ) > sum.max )
+        sum.max = hist.max.load( std::memory_order_relaxed );
+    for( size_t i = 0; i < DEVICEDATAMETRICS_HIST_BUCKETS; i++ )
+        sum.buckets[i] += hist.buckets[i].load( std::memory_order_relaxed );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* mergeHist()
+*/
+static void mergeHist( DeviceDataMetrics::s_hist& sum,
+        const DeviceDataMetrics::s_hist& hist )
+{
+    sum.count += hist.count;
+    sum.sum += hist.sum;
+    if( hist.max > sum.max )
+        sum.max = hist.max;
+    for( size_t i = 0; i < DEVICEDATAMETRICS_HIST_BUCKETS; i++ )
+        sum.buckets[i] += hist.buckets[i];
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* merge()
+*/
+static void merge( DeviceDataMetrics::s_metrics& sum,
+        const DeviceDataMetrics::s_metrics& metrics )
+{
+    for( size_t i = 0; i < DeviceDataMetrics::OP_MAX; i++ )
+        sum.ops[i] += metrics.ops[i];
+
+    for( size_t n = 0; n < DeviceDataMetrics::NATIVE_MAX; n++ )
+    {
+        mergeHist( sum.native[n], metrics.native[n] );
+        for( size_t i = 0; i < DEVICEDATAMETRICS_RET_BUCKETS; i++ )
+            sum.ret[n][i] += metrics.ret[n][i];
+    }
+
+    mergeHist( sum.fanout, metrics.fanout );
+    sum.notified += metrics.notified;
+    if( metrics.maxObservers > sum.maxObservers )
+        sum.maxObservers = metrics.maxObservers;
+}
+
+
+/*
+ * --- Methods Definition ----------------------------------------------------- *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* getScope()
+*/
+DeviceDataMetrics::t_scope DeviceDataMetrics::getScope( const std::string& backend,
+        const std::string& device )
+{
+    s_registry* p_reg = registry();
+    std::lock_guard< std::mutex > lock( p_reg->mutex );
+    std::string key = backend + '\0' + device;
+
+    if( p_reg->scopes.empty() )
+    {
+        /* scope 0 collects everything not assigned to a scope */
+        p_reg->scopes.push_back( std::make_pair( std::string(), std::string() ) );
+        /* the overflow scope is not found by its name */
+        p_reg->scopes.push_back( std::make_pair(
+            std::string( DEVICEDATAMETRICS_OVERFLOW ), std::string() ) );
+    }
+
+    std::unordered_map< std::string, t_scope >::const_iterator it =
+            p_reg->index.find( key );
+    if( it != p_reg->index.end() )
+        return it->second;
+
+    if( p_reg->scopes.size() >= DEVICEDATAMETRICS_MAX_SCOPES )
+        return SCOPE_OVERFLOW;
+
+    t_scope scope = (t_scope)p_reg->scopes.size();
+    p_reg->scopes.push_back( std::make_pair( backend, device ) );
+    p_reg->index[key] = scope;
+    return scope;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* count()
+*/
+void DeviceDataMetrics::count( t_scope scope, e_op op )
+{
+    add( counters( scope )->ops[op], 1 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* native()
+*/
+void DeviceDataMetrics::native( t_scope scope, e_native native, uint64_t ns )
+{
+    addHist( counters( scope )->native[native], ns );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* native()
+*/
+void DeviceDataMetrics::native( t_scope scope, e_native native, int16_t ret,
+        uint64_t ns )
+{
+    s_counters* p_cnt = counters( scope );
+
+    addHist( p_cnt->native[native], ns );
+    add( p_cnt->ret[native][retBucket( ret )], 1 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* result()
+*/
+void DeviceDataMetrics::result( t_scope scope, e_native native, int16_t ret )
+{
+    add( counters( scope )->ret[native][retBucket( ret )], 1 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* fanout()
+*/
+void DeviceDataMetrics::fanout( t_scope scope, uint32_t num, uint64_t ns )
+{
+    s_counters* p_cnt = counters( scope );
+
+    addHist( p_cnt->fanout, ns );
+    add( p_cnt->notified, num );
+    addMax( p_cnt->maxObservers, num );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* getSnapshot()
+*/
+void DeviceDataMetrics::getSnapshot( std::vector<s_metrics>& metrics,
+        e_group group )
+{
+    s_registry* p_reg = registry();
+    std::lock_guard< std::mutex > lock( p_reg->mutex );
+    std::unordered_map< std::string, size_t > groups;
+
+    metrics.clear();
+
+    for( t_scope scope = 0; scope < p_reg->scopes.size(); scope++ )
+    {
+        s_metrics sum;
+        bool used = false;
+
+        memset( &sum.ops, 0, sizeof(sum.ops) );
+        memset( &sum.native, 0, sizeof(sum.native) );
+        memset( &sum.ret, 0, sizeof(sum.ret) );
+        memset( &sum.fanout, 0, sizeof(sum.fanout) );
+        sum.notified = 0;
+        sum.maxObservers = 0;
+        sum.overflow = (scope == SCOPE_OVERFLOW);
+
+        /* sum up the counters of all threads */
+        for( size_t s = 0; s < p_reg->shards.size(); s++ )
+        {
+            const s_counters* p_cnt = p_reg->shards[s]->peek( scope );
+            if( p_cnt == NULL )
+                continue;
+
+            for( size_t i = 0; i < OP_MAX; i++ )
+                sum.ops[i] += p_cnt->ops[i].load( std::memory_order_relaxed );
+
+            for( size_t n = 0; n < NATIVE_MAX; n++ )
+            {
+                sumHist( sum.native[n], p_cnt->native[n] );
+                for( size_t i = 0; i < DEVICEDATAMETRICS_RET_BUCKETS; i++ )
+                    sum.ret[n][i] += p_cnt->ret[n][i].load( std::memory_order_relaxed );
+            }
+
+            sumHist( sum.fanout, p_cnt->fanout );
+            sum.notified += p_cnt->notified.load( std::memory_order_relaxed );
+            if( p_cnt->maxObservers.load( std::memory_order_relaxed ) > sum.maxObservers )
+                sum.maxObservers = p_cnt->maxObservers.load( std::memory_order_relaxed );
+        }
+
+        for( size_t i = 0; i < OP_MAX; i++ )
+            used |= (sum.ops[i] != 0);
+        for( size_t n = 0; n < NATIVE_MAX; n++ )
+        {
+            used |= (sum.native[n].count != 0);
+            for( size_t i = 0; i < DEVICEDATAMETRICS_RET_BUCKETS; i++ )
+                used |= (sum.ret[n][i] != 0);
+        }
+        used |= (sum.fanout.count != 0);
+        if( used == false )
+            continue;
+
+        if( (group != GROUP_DEVICE) || sum.overflow )
+            sum.backend = p_reg->scopes[scope].first;
+        if( group != GROUP_BACKEND )
+            sum.device = p_reg->scopes[scope].second;
+
+        /* merge the scopes of the same group */
+        std::string key = (sum.overflow ? "1" : "0") + sum.backend + '\0' +
+            sum.device;
+        std::unordered_map< std::string, size_t >::const_iterator it =
+                groups.find( key );
+        if( it != groups.end() )
+            merge( metrics[it->second], sum );
+        else
+        {
+            groups[key] = metrics.size();
+            metrics.push_back( sum );
+        }
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* getNumShards()
+*/
+size_t DeviceDataMetrics::getNumShards( void )
+{
+    s_registry* p_reg = registry();
+    std::lock_guard< std::mutex > lock( p_reg->mutex );
+    return p_reg->shards.size();
+}
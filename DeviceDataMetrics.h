@@ -0,0 +1,342 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataMetrics.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Metrics of the accesses to device data elements.
+ *
+ *          The device data elements count their accesses, the latencies
+ *          and results of the native functions and the time needed to
+ *          notify their observers. The metrics are aggregated per scope,
+ *          i.e. per backend and device. Each thread counts to its own
+ *          counters, so counting needs neither locks nor atomic
+ *          read-modify-write operations. The counters of all the threads
+ *          are summed up when a snapshot is taken.
+ *
+ *          The instrumentation of the device data elements is only
+ *          compiled if DEVICEDATA_METRICS is defined.
+ */
+
+
+#ifndef __DEVICEDATAMETRICS_H__
+#define __DEVICEDATAMETRICS_H__
+#ifndef __DECL_DEVICEDATAMETRICS_H__
+#define __DECL_DEVICEDATAMETRICS_H__ extern
+#endif /* #ifndef __DECL_DEVICEDATAMETRICS_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <chrono>
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** maximum number of scopes, further scopes are counted to the
+ *  overflow scope */
+#define DEVICEDATAMETRICS_MAX_SCOPES        4096
+
+/** number of scopes allocated at once per thread */
+#define DEVICEDATAMETRICS_CHUNK             64
+
+/** number of buckets of the latency histograms */
+#define DEVICEDATAMETRICS_HIST_BUCKETS      16
+
+/** number of buckets of the return codes */
+#define DEVICEDATAMETRICS_RET_BUCKETS       8
+
+#if defined(DEVICEDATA_METRICS)
+
+/** declare the start time of a measurement */
+#define DEVICEDATA_METRICS_START( t ) \
+    uint64_t t = DeviceDataMetrics::now()
+
+/** count an access */
+#define DEVICEDATA_METRICS_COUNT( scope, op ) \
+    DeviceDataMetrics::count( scope, op )
+
+/** record the latency and result of a native access started at t */
+#define DEVICEDATA_METRICS_NATIVE( scope, kind, ret, t ) \
+    DeviceDataMetrics::native( scope, kind, ret, DeviceDataMetrics::now() - (t) )
+
+/** record the latency of a batched native request started at t */
+#define DEVICEDATA_METRICS_LATENCY( scope, kind, t ) \
+    DeviceDataMetrics::native( scope, kind, DeviceDataMetrics::now() - (t) )
+
+/** record the result of a native access of a batch */
+#define DEVICEDATA_METRICS_RESULT( scope, kind, ret ) \
+    DeviceDataMetrics::result( scope, kind, ret )
+
+/** record a notification of num observers started at t */
+#define DEVICEDATA_METRICS_FANOUT( scope, num, t ) \
+    DeviceDataMetrics::fanout( scope, num, DeviceDataMetrics::now() - (t) )
+
+#else
+
+#define DEVICEDATA_METRICS_START( t )                       do {} while( 0 )
+#define DEVICEDATA_METRICS_COUNT( scope, op )               do {} while( 0 )
+#define DEVICEDATA_METRICS_NATIVE( scope, kind, ret, t )  do {} while( 0 )
+#define DEVICEDATA_METRICS_LATENCY( scope, kind, t )      do {} while( 0 )
+#define DEVICEDATA_METRICS_RESULT( scope, kind, ret )     do {} while( 0 )
+#define DEVICEDATA_METRICS_FANOUT( scope, num, t )          do {} while( 0 )
+
+#endif /* #if defined(DEVICEDATA_METRICS) */
+
+
+/*
+ * --- Class Definition ----------------------------------------------------- *
+ */
+
+/**
+ * \brief   DeviceDataMetrics Class.
+ *
+ *          The latency histograms use buckets of powers of two in us.
+ *          Bucket 0 counts latencies below 1 us, bucket i latencies
+ *          below 2^i us and the last bucket all the longer ones. Batched
+ *          native requests are measured once for the whole batch while
+ *          their results are counted per element.
+ */
+class DeviceDataMetrics
+{
+
+public:
+
+    /** handle of a scope */
+    typedef uint32_t t_scope;
+
+    /** scope that was not resolved yet */
+    static const t_scope SCOPE_UNSET = 0xFFFFFFFF;
+
+    /** scope counting the scopes beyond DEVICEDATAMETRICS_MAX_SCOPES */
+    static const t_scope SCOPE_OVERFLOW = 1;
+
+    /** counted accesses */
+    enum e_op
+    {
+        /** read of the value */
+        OP_GETVAL,
+        /** write of the value */
+        OP_SETVAL,
+        /** registration of an observer */
+        OP_OBSERVE,
+        /** number of counted accesses */
+        OP_MAX
+    };
+
+    /** native functions */
+    enum e_native
+    {
+        /** native read */
+        NATIVE_READ,
+        /** native write */
+        NATIVE_WRITE,
+        /** number of native functions */
+        NATIVE_MAX
+    };
+
+    /** grouping of a snapshot */
+    enum e_group
+    {
+        /** per backend and device */
+        GROUP_SCOPE,
+        /** per backend */
+        GROUP_BACKEND,
+        /** per device */
+        GROUP_DEVICE
+    };
+
+    /** latency histogram */
+    struct s_hist
+    {
+        /** number of measurements */
+        uint64_t count;
+        /** sum of the latencies in ns */
+        uint64_t sum;
+        /** maximum latency in ns */
+        uint64_t max;
+        /** number of measurements per bucket */
+        uint64_t buckets[DEVICEDATAMETRICS_HIST_BUCKETS];
+    };
+
+    /** metrics of a scope */
+    struct s_metrics
+    {
+        /** backend or empty if grouped per device */
+        std::string backend;
+        /** device or empty if grouped per backend */
+        std::string device;
+        /** counts of the scopes beyond DEVICEDATAMETRICS_MAX_SCOPES whose
+         *  backend and device are not known */
+        bool overflow;
+        /** number of accesses, see e_op */
+        uint64_t ops[OP_MAX];
+        /** latencies of the native functions, see e_native */
+        s_hist native[NATIVE_MAX];
+        /** results of the native functions. Bucket 0 counts 0, bucket
+         *  i the return code -i and the last bucket all other codes. */
+        uint64_t ret[NATIVE_MAX][DEVICEDATAMETRICS_RET_BUCKETS];
+        /** time needed to notify the observers */
+        s_hist fanout;
+        /** number of observers notified */
+        uint64_t notified;
+        /** maximum number of observers notified by a single change */
+        uint64_t maxObservers;
+    };
+
+    /**
+     * \brief   Scope of a device data element.
+     *
+     *          The scope is resolved on first use since the backend of an
+     *          element is not known during its construction.
+     */
+    class Scope
+    {
+
+    public:
+
+        /**
+         * \brief   Default Constructor of an unresolved scope.
+         */
+        Scope( void )
+            : m_scope( SCOPE_UNSET ) {};
+
+        /** handle of the scope */
+        std::atomic<t_scope> m_scope;
+    };
+
+    /**
+     * \brief   Get the scope of a backend and device.
+     *
+     *          The scope is created if it does not exist yet.
+     *
+     * \param   backend Name of the backend.
+     * \param   device  Name of the device.
+     *
+     * \return  Handle of the scope or SCOPE_OVERFLOW if no scope is left.
+     */
+    static t_scope getScope( const std::string& backend, const std::string& device );
+
+    /**
+     * \brief   Count an access.
+     *
+     * \param   scope   Scope to count to.
+     * \param   op      Access to count.
+     */
+    static void count( t_scope scope, e_op op );
+
+    /**
+     * \brief   Record the latency of a native request.
+     *
+     * \param   scope   Scope to count to.
+     * \param   native  Native function.
+     * \param   ns      Latency in ns.
+     */
+    static void native( t_scope scope, e_native native, uint64_t ns );
+
+    /**
+     * \brief   Record the latency and result of a native function.
+     *
+     * \param   scope   Scope to count to.
+     * \param   native  Native function.
+     * \param   ret     Return code of the native function.
+     * \param   ns      Latency in ns.
+     */
+    static void native( t_scope scope, e_native native, int16_t ret, uint64_t ns );
+
+    /**
+     * \brief   Record the result of a native function.
+     *
+     * \param   scope   Scope to count to.
+     * \param   native  Native function.
+     * \param   ret     Return code of the native function.
+     */
+    static void result( t_scope scope, e_native native, int16_t ret );
+
+    /**
+     * \brief   Record the notification of the observers.
+     *
+     * \param   scope   Scope to count to.
+     * \param   num     Number of observers notified.
+     * \param   ns      Time needed in ns.
+     */
+    static void fanout( t_scope scope, uint32_t num, uint64_t ns );
+
+    /**
+     * \brief   Take a snapshot of the metrics.
+     *
+     *          The counters are read while other threads continue counting,
+     *          so the values of a snapshot are not exactly consistent with
+     *          each other. Scopes without any access are left out. The
+     *          overflow scope is never merged with other scopes.
+     *
+     * \param   metrics Filled with the metrics.
+     * \param   group   Grouping of the metrics.
+     */
+    static void getSnapshot( std::vector<s_metrics>& metrics,
+            e_group group = GROUP_SCOPE );
+
+    /**
+     * \brief   Get the number of sets of thread counters.
+     *
+     *          The counters of an ended thread are taken over by the next
+     *          thread, so this is the maximum number of threads that
+     *          counted at the same time.
+     *
+     * \return  Number of sets of counters.
+     */
+    static size_t getNumShards( void );
+
+    /**
+     * \brief   Get the actual time for measurements.
+     *
+     * \return  Time in ns.
+     */
+    static uint64_t now( void ) {
+        return (uint64_t)std::chrono::duration_cast< std::chrono::nanoseconds >(
+            std::chrono::steady_clock::now().time_since_epoch() ).count();
+    }
+};
+
+#endif /* #ifndef __DEVICEDATAMETRICS_H__ */
+
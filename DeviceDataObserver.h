@@ -95,6 +95,25 @@ public:
     virtual int8_t notify( const DeviceDataValue* p_val,
         const DeviceData* p_data, void* p_param ) = 0;
 
+    /**
+     * \brief   Notify about coalesced changes.
+     *
+     *          Observers registered with a minimum notification interval
+     *          receive the latest value once the interval expired. The
+     *          default implementation calls notify().
+     *
+     * \param   p_val       Latest value.
+     * \param   p_data      DeviceDataObject the change was reported from
+     * \param   p_param     User parameter.
+     * \param   suppressed  Number of changes that were not delivered
+     *                      since the last notification.
+     *
+     */
+    virtual int8_t notifyCoalesced( const DeviceDataValue* p_val,
+        const DeviceData* p_data, void* p_param, uint32_t ) {
+        return notify( p_val, p_data, p_param );
+    }
+
 
 };
 
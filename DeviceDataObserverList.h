@@ -0,0 +1,251 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataObserverList.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Copy-on-write list of device data observers.
+ *
+ *          Observers can be registered or removed from any thread while
+ *          notifications iterate over an immutable snapshot of the list
+ *          without taking a lock or allocating memory.
+ */
+
+
+#ifndef __DEVICEDATAOBSERVERLIST_H__
+#define __DEVICEDATAOBSERVERLIST_H__
+#ifndef __DECL_DEVICEDATAOBSERVERLIST_H__
+#define __DECL_DEVICEDATAOBSERVERLIST_H__ extern
+#endif /* #ifndef __DECL_DEVICEDATAOBSERVERLIST_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <vector>
+#include <atomic>
+#include <mutex>
+
+/*
+ * --- Class Definition ----------------------------------------------------- *
+ */
+
+/**
+ * \brief   DeviceDataObserverList Class.
+ *
+ *          Each modification creates a new copy of the list which is then
+ *          published atomically. Readers announce themselves using a reader
+ *          counter before they load the list. Replaced lists are kept until
+ *          a writer finds no reader active anymore, so a reader can never
+ *          access a list that was already freed.
+ */
+template < typename T >
+class DeviceDataObserverList
+{
+
+public:
+
+    /** type of the immutable list */
+    typedef std::vector< T > t_list;
+
+    /**
+     * \brief   Snapshot of the list.
+     *
+     *          The snapshot keeps the list it was created from alive for
+     *          its lifetime. It shall only be used for a short period since
+     *          replaced lists can not be freed as long as any snapshot
+     *          exists.
+     */
+    class Snapshot
+    {
+
+    public:
+
+        /**
+         * \brief   Create a snapshot of a list.
+         *
+         * \param   list    List to create the snapshot of.
+         */
+        Snapshot( const DeviceDataObserverList& list )
+            : m_list( list ) {
+            m_list.m_readers.fetch_add( 1 );
+            mp_list = m_list.mp_list.load();
+        }
+
+        /**
+         * \brief   Release the snapshot.
+         */
+        ~Snapshot( void ) {
+            m_list.m_readers.fetch_sub( 1 );
+        }
+
+        /** begin of the elements */
+        typename t_list::const_iterator begin( void ) const { return mp_list->begin(); }
+
+        /** end of the elements */
+        typename t_list::const_iterator end( void ) const { return mp_list->end(); }
+
+        /** number of elements */
+        size_t size( void ) const { return mp_list->size(); }
+
+    private:
+
+        /** non copyable */
+        Snapshot( const Snapshot& );
+        Snapshot& operator=( const Snapshot& );
+
+        /** list the snapshot belongs to */
+        const DeviceDataObserverList& m_list;
+
+        /** the immutable list */
+        const t_list* mp_list;
+    };
+
+    /**
+     * \brief   Create an empty list.
+     */
+    DeviceDataObserverList( void )
+        : mp_list( new t_list() )
+        , m_readers( 0 ) {};
+
+    /**
+     * \brief   Destructor of the list.
+     *
+     *          The list must not be accessed anymore when it is destroyed.
+     */
+    ~DeviceDataObserverList( void ) {
+        delete mp_list.load();
+        for( size_t i = 0; i < m_retired.size(); i++ )
+            delete m_retired[i];
+    }
+
+    /**
+     * \brief   Add an element to the list.
+     *
+     * \param   elem    Element to add.
+     */
+    void add( const T& elem ) {
+        std::lock_guard< std::mutex > lock( m_mutex );
+
+        t_list* p_list = new t_list( *mp_list.load() );
+        p_list->push_back( elem );
+        publish( p_list );
+    }
+
+    /**
+     * \brief   Remove all elements matching a predicate.
+     *
+     * \param   pred    Predicate returning true for elements to remove.
+     *
+     * \return  Number of removed elements.
+     */
+    template < typename PRED >
+    size_t remove( PRED pred ) {
+        std::lock_guard< std::mutex > lock( m_mutex );
+
+        const t_list* p_cur = mp_list.load();
+        t_list* p_list = new t_list();
+        p_list->reserve( p_cur->size() );
+
+        for( size_t i = 0; i < p_cur->size(); i++ )
+        {
+            if( pred( (*p_cur)[i] ) == false )
+                p_list->push_back( (*p_cur)[i] );
+        }
+
+        size_t num = p_cur->size() - p_list->size();
+        if( num > 0 )
+            publish( p_list );
+        else
+            delete p_list;
+        return num;
+    }
+
+    /**
+     * \brief   Get the number of elements.
+     *
+     * \return  Number of elements within the list.
+     */
+    size_t size( void ) const {
+        Snapshot snap( *this );
+        return snap.size();
+    }
+
+private:
+
+    /** non copyable */
+    DeviceDataObserverList( const DeviceDataObserverList& );
+    DeviceDataObserverList& operator=( const DeviceDataObserverList& );
+
+    /**
+     * \brief   Publish a new list.
+     *
+     *          Must be called with the writer lock held.
+     *
+     * \param   p_list  The new list.
+     */
+    void publish( const t_list* p_list ) {
+        /* replace the list and keep the old one until no
+         * reader can access it anymore */
+        m_retired.push_back( mp_list.exchange( p_list ) );
+
+        if( m_readers.load() == 0 )
+        {
+            /* Nobody is reading at the moment. Readers starting
+             * from now on can only see the new list. */
+            for( size_t i = 0; i < m_retired.size(); i++ )
+                delete m_retired[i];
+            m_retired.clear();
+        }
+    }
+
+private:
+
+    /** the actual list */
+    std::atomic< const t_list* > mp_list;
+
+    /** number of active readers */
+    mutable std::atomic< uint32_t > m_readers;
+
+    /** replaced lists that might still be in use */
+    std::vector< const t_list* > m_retired;
+
+    /** lock serializing the writers */
+    std::mutex m_mutex;
+};
+
+#endif /* #ifndef __DEVICEDATAOBSERVERLIST_H__ */
@@ -0,0 +1,382 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataPoller.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Central polling of device data elements.
+ *
+ *          Values that can not be observed are read periodically by the
+ *          poller and reported to their observers like observed values.
+ *          The elements of the same device using the same interval are
+ *          polled within the same tick and read using a single call to
+ *          DeviceData::pollVals().
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include "DeviceDataPoller.h"
+#include "DeviceData.h"
+#include "Device.h"
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** number of worker threads of the executor created by the poller */
+#define DEVICEDATAPOLLER_EXECUTOR_THREADS       2
+
+
+/*
+ * --- Methods Definition ----------------------------------------------------- *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* DeviceDataPoller()
+*/
+DeviceDataPoller::DeviceDataPoller( DeviceDataTimer* p_timer,
+        DeviceDataExecutor* p_exec )
+    : mp_timer( p_timer )
+    , mp_exec( p_exec )
+    , mp_ownExec( NULL )
+    , m_handle( HANDLE_INVALID )
+    , m_queued( 0 )
+    , m_polls( 0 )
+    , m_reads( 0 )
+    , m_failed( 0 )
+{
+    if( mp_timer == NULL )
+        mp_timer = DeviceData::getTimer();
+
+    if( mp_exec == NULL )
+    {
+        mp_ownExec = new DeviceDataExecutor( DEVICEDATAPOLLER_EXECUTOR_THREADS );
+        mp_exec = mp_ownExec;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* ~DeviceDataPoller()
+*/
+DeviceDataPoller::~DeviceDataPoller( void )
+{
+    std::vector< Group* > groups;
+
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        std::unordered_map< s_key, Group*, s_keyHash >::iterator it;
+
+        for( it = m_groups.begin(); it != m_groups.end(); ++it )
+        {
+            Group* p_group = it->second;
+
+            p_group->m_active = false;
+            for( size_t i = 0; i < p_group->m_data.size(); i++ )
+                p_group->m_data[i]->m_polled--;
+            groups.push_back( p_group );
+        }
+        m_groups.clear();
+        m_regs.clear();
+    }
+
+    /* stopping waits for a running expiry, so no more polls are handed
+     * to the executor */
+    for( size_t i = 0; i < groups.size(); i++ )
+        mp_timer->stop( groups[i] );
+
+    /* the polls handed to the executor leave the inactive groups to be
+     * deleted here. Detached groups are deleted by their polls. */
+    {
+        std::unique_lock< std::mutex > lock( m_mutex );
+        while( m_queued > 0 )
+            m_polled.wait( lock );
+    }
+
+    for( size_t i = 0; i < groups.size(); i++ )
+        delete groups[i];
+
+    delete mp_ownExec;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* add()
+*/
+DeviceDataPoller::t_handle DeviceDataPoller::add( DeviceData* p_data,
+        std::chrono::milliseconds interval, const Device* p_dev )
+{
+    if( (p_data == NULL) || (p_data->getReadable() == false) ||
+        (interval.count() <= 0) )
+        return HANDLE_INVALID;
+
+    /* elements with the same interval in ticks share the same tick */
+    uint32_t tick = mp_timer->getTick();
+    uint32_t ticks = (uint32_t)((interval.count() + tick - 1) / tick);
+    s_key key = { p_dev, ticks };
+
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    Group*& p_group = m_groups[key];
+    bool created = false;
+    if( p_group == NULL )
+    {
+        p_group = new Group( this, p_dev, ticks );
+        created = true;
+    }
+
+    if( ++m_handle == HANDLE_INVALID )
+        ++m_handle;
+
+    s_reg reg = { p_group, p_group->m_data.size() };
+    m_regs[m_handle] = reg;
+    p_group->m_data.push_back( p_data );
+    p_group->m_handles.push_back( m_handle );
+    p_data->m_polled++;
+
+    if( created )
+        mp_timer->start( p_group, ticks * tick );
+    return m_handle;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* addDevice()
+*/
+size_t DeviceDataPoller::addDevice( const Device* p_dev,
+        std::chrono::milliseconds interval, std::vector<t_handle>* p_handles )
+{
+    size_t num = 0;
+
+    if( p_dev == NULL )
+        return 0;
+
+    const std::vector<DeviceData*>& data = p_dev->getDataList();
+    for( size_t i = 0; i < data.size(); i++ )
+    {
+        /* observable elements report their changes on their own */
+        if( (data[i] == NULL) || data[i]->getObserveable() ||
+            (data[i]->getReadable() == false) )
+            continue;
+
+        t_handle handle = add( data[i], interval, p_dev );
+        if( handle == HANDLE_INVALID )
+            continue;
+
+        if( p_handles != NULL )
+            p_handles->push_back( handle );
+        num++;
+    }
+    return num;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* remove()
+*/
+int16_t DeviceDataPoller::remove( t_handle handle )
+{
+    std::unique_lock< std::mutex > lock( m_mutex );
+    std::unordered_map< t_handle, s_reg >::iterator it = m_regs.find( handle );
+
+    if( it == m_regs.end() )
+        return -1;
+
+    Group* p_group = it->second.p_group;
+    size_t idx = it->second.idx;
+    size_t last = p_group->m_data.size() - 1;
+
+    p_group->m_data[idx]->m_polled--;
+
+    /* move the last element to the free position */
+    if( idx != last )
+    {
+        p_group->m_data[idx] = p_group->m_data[last];
+        p_group->m_handles[idx] = p_group->m_handles[last];
+        m_regs[p_group->m_handles[idx]].idx = idx;
+    }
+    p_group->m_data.pop_back();
+    p_group->m_handles.pop_back();
+    m_regs.erase( it );
+
+    if( p_group->m_queued &&
+        (p_group->m_pollThread == std::this_thread::get_id()) )
+    {
+        /* called from the poll itself, which deletes an empty group */
+        if( p_group->m_data.empty() )
+        {
+            s_key key = { p_group->mp_dev, p_group->m_ticks };
+            p_group->m_active = false;
+            p_group->m_detached = true;
+            m_groups.erase( key );
+        }
+        return 0;
+    }
+
+    /* wait for a running poll to finish. A poll not yet started reads
+     * the remaining elements only. */
+    while( p_group->m_queued && (p_group->m_pollThread != std::thread::id()) )
+        m_polled.wait( lock );
+
+    if( p_group->m_data.empty() )
+    {
+        s_key key = { p_group->mp_dev, p_group->m_ticks };
+        p_group->m_active = false;
+        m_groups.erase( key );
+
+        /* the poll handed to the executor deletes the group */
+        if( p_group->m_queued )
+        {
+            p_group->m_detached = true;
+            return 0;
+        }
+        lock.unlock();
+
+        mp_timer->stop( p_group );
+        delete p_group;
+    }
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* getStats()
+*/
+void DeviceDataPoller::getStats( s_stats& stats )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    stats.polled = (uint32_t)m_regs.size();
+    stats.groups = (uint32_t)m_groups.size();
+    stats.polls = m_polls;
+    stats.reads = m_reads;
+    stats.failed = m_failed;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* schedule()
+*/
+void DeviceDataPoller::schedule( Group* p_group )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+    std::chrono::steady_clock::time_point start =
+        std::chrono::steady_clock::now();
+
+    /* the group was removed while the timer expired */
+    if( p_group->m_active == false )
+        return;
+
+    p_group->m_queued = true;
+    m_queued++;
+    if( mp_exec->post( [this, p_group, start]( void ) {
+            poll( p_group, start ); } ) != 0 )
+    {
+        /* the executor is stopping */
+        p_group->m_queued = false;
+        m_queued--;
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* poll()
+*/
+void DeviceDataPoller::poll( Group* p_group,
+        std::chrono::steady_clock::time_point start )
+{
+    std::unique_lock< std::mutex > lock( m_mutex );
+
+    /* the group was removed before the poll started */
+    if( p_group->m_active == false )
+    {
+        finish( lock, p_group );
+        return;
+    }
+
+    std::vector< DeviceData* > data( p_group->m_data );
+    p_group->m_pollThread = std::this_thread::get_id();
+    lock.unlock();
+
+    /* read the elements and notify their observers */
+    int16_t ret = DeviceData::pollVals( data );
+
+    lock.lock();
+    m_polls++;
+    m_reads += data.size();
+    if( ret != 0 )
+        m_failed++;
+
+    /* a group stopped in the meantime is not polled anymore */
+    if( p_group->m_active )
+    {
+        /* keep the group aligned to its interval as far as possible */
+        uint32_t interval = p_group->m_ticks * mp_timer->getTick();
+        uint32_t elapsed = (uint32_t)std::chrono::duration_cast<
+            std::chrono::milliseconds >( std::chrono::steady_clock::now() - start ).count();
+
+        mp_timer->start( p_group, (elapsed < interval) ? (interval - elapsed) : 0 );
+    }
+
+    finish( lock, p_group );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* finish()
+*/
+void DeviceDataPoller::finish( std::unique_lock< std::mutex >& lock,
+        Group* p_group )
+{
+    DeviceDataTimer* p_timer = mp_timer;
+    bool detached = p_group->m_detached;
+
+    p_group->m_queued = false;
+    p_group->m_pollThread = std::thread::id();
+    m_queued--;
+    m_polled.notify_all();
+    lock.unlock();
+
+    /* the poller might be deleted as soon as the lock was released */
+    if( detached )
+    {
+        p_timer->stop( p_group );
+        delete p_group;
+    }
+}
@@ -0,0 +1,351 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataPoller.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Central polling of device data elements.
+ *
+ *          Values that can not be observed are read periodically by the
+ *          poller and reported to their observers like observed values.
+ *          The elements of the same device using the same interval are
+ *          polled within the same tick and read using a single call to
+ *          DeviceData::pollVals().
+ */
+
+
+#ifndef __DEVICEDATAPOLLER_H__
+#define __DEVICEDATAPOLLER_H__
+#ifndef __DECL_DEVICEDATAPOLLER_H__
+#define __DECL_DEVICEDATAPOLLER_H__ extern
+#endif /* #ifndef __DECL_DEVICEDATAPOLLER_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <unordered_map>
+#include "DeviceDataTimer.h"
+#include "DeviceDataExecutor.h"
+
+/*
+ * --- Forward Declaration ----------------------------------------------------- *
+ */
+class Device;
+class DeviceData;
+
+/*
+ * --- Class Definition ----------------------------------------------------- *
+ */
+
+/**
+ * \brief   DeviceDataPoller Class.
+ *
+ *          Each group of elements (same device and same interval) uses a
+ *          single entry of the shared timer, so adding and removing
+ *          elements takes constant time independent of the number of
+ *          polled elements. The timer only hands an expired group to an
+ *          executor, which reads the elements and restarts the timer of
+ *          the group afterwards. This way slow backends neither delay
+ *          other groups nor the other users of the timer.
+ */
+class DeviceDataPoller
+{
+
+public:
+
+    /** handle of a poll registration */
+    typedef uint32_t t_handle;
+
+    /** invalid handle */
+    static const t_handle HANDLE_INVALID = 0;
+
+    /** statistics of the poller */
+    struct s_stats
+    {
+        /** number of polled elements */
+        uint32_t polled;
+        /** number of groups polled within the same tick */
+        uint32_t groups;
+        /** number of group polls */
+        uint64_t polls;
+        /** number of elements read */
+        uint64_t reads;
+        /** number of group polls with at least one failed read */
+        uint64_t failed;
+    };
+
+    /**
+     * \brief   Constructor to create a poller.
+     *
+     * \param   p_timer Timer to use or NULL to use the timer returned
+     *                  by DeviceData::getTimer().
+     * \param   p_exec  Executor reading the elements or NULL to create
+     *                  an executor of the poller. An executor given must
+     *                  exist as long as the poller.
+     */
+    DeviceDataPoller( DeviceDataTimer* p_timer = NULL,
+            DeviceDataExecutor* p_exec = NULL );
+
+    /**
+     * \brief   Default Destructor of the poller.
+     *
+     *          All the elements are removed. Polls handed to the executor
+     *          are waited for.
+     */
+    virtual ~DeviceDataPoller( void );
+
+    /**
+     * \brief   Poll a device data element.
+     *
+     *          The interval is rounded up to the resolution of the timer.
+     *          The first poll happens one interval after the group of the
+     *          element was created.
+     *
+     * \param   p_data      Element to poll.
+     * \param   interval    Interval between two reads.
+     * \param   p_dev       Device the element belongs to. Elements of the
+     *                      same device and interval are read together.
+     *
+     * \return  Handle of the registration or HANDLE_INVALID if the
+     *          element is not readable or the interval is 0.
+     */
+    t_handle add( DeviceData* p_data, std::chrono::milliseconds interval,
+            const Device* p_dev = NULL );
+
+    /**
+     * \brief   Poll all the readable elements of a device that can not
+     *          be observed.
+     *
+     * \param   p_dev       Device to poll.
+     * \param   interval    Interval between two reads.
+     * \param   p_handles   Filled with the handles of the registrations.
+     *                      Can be NULL.
+     *
+     * \return  Number of polled elements.
+     */
+    size_t addDevice( const Device* p_dev, std::chrono::milliseconds interval,
+            std::vector<t_handle>* p_handles = NULL );
+
+    /**
+     * \brief   Stop polling an element.
+     *
+     *          If the group of the element is being polled in the meantime
+     *          the function waits until the poll finished, except if called
+     *          from an observer notified by the poll.
+     *
+     * \param   handle  Handle returned when the element was added.
+     *
+     * \return  0 on success or -1 if the handle is unknown.
+     */
+    int16_t remove( t_handle handle );
+
+    /**
+     * \brief   Get the statistics of the poller.
+     *
+     * \param   stats   Statistics to fill.
+     */
+    void getStats( s_stats& stats );
+
+private:
+
+    /**
+     * \brief   Elements polled within the same tick.
+     */
+    class Group
+            : public DeviceDataTimer::Entry
+    {
+
+    public:
+
+        /**
+         * \brief   Constructor of a group.
+         *
+         * \param   p_poller    Poller the group belongs to.
+         * \param   p_dev       Device of the elements.
+         * \param   ticks       Interval in ticks of the timer.
+         */
+        Group( DeviceDataPoller* p_poller, const Device* p_dev, uint32_t ticks )
+            : mp_poller( p_poller )
+            , mp_dev( p_dev )
+            , m_ticks( ticks )
+            , m_active( true )
+            , m_detached( false )
+            , m_queued( false ) {};
+
+        /** poller the group belongs to */
+        DeviceDataPoller* mp_poller;
+
+        /** device of the elements */
+        const Device* mp_dev;
+
+        /** interval in ticks */
+        uint32_t m_ticks;
+
+        /** the group is still polled */
+        bool m_active;
+
+        /** the group was removed during its own poll or before the poll
+         *  handed to the executor started, which deletes it */
+        bool m_detached;
+
+        /** a poll was handed to the executor and did not finish yet */
+        bool m_queued;
+
+        /** thread running the poll or the default id before it started */
+        std::thread::id m_pollThread;
+
+        /** polled elements */
+        std::vector< DeviceData* > m_data;
+
+        /** handles of the polled elements */
+        std::vector< t_handle > m_handles;
+
+    private:
+
+        /**
+         * \brief   Hand the group to the executor when the interval expired.
+         */
+        virtual void expired( void ) {
+            mp_poller->schedule( this );
+        }
+    };
+
+    /** key of a group */
+    struct s_key
+    {
+        /** device of the elements */
+        const Device* p_dev;
+        /** interval in ticks */
+        uint32_t ticks;
+
+        bool operator==( const s_key& key ) const {
+            return (p_dev == key.p_dev) && (ticks == key.ticks);
+        }
+    };
+
+    /** hash of the key of a group */
+    struct s_keyHash
+    {
+        size_t operator()( const s_key& key ) const {
+            return std::hash< const Device* >()( key.p_dev ) ^
+                ((size_t)key.ticks * 0x9E3779B9u);
+        }
+    };
+
+    /** position of a registration */
+    struct s_reg
+    {
+        /** group of the element */
+        Group* p_group;
+        /** index of the element within the group */
+        size_t idx;
+    };
+
+    /**
+     * \brief   Hand the poll of a group to the executor.
+     *
+     *          Called from the timer thread.
+     *
+     * \param   p_group Group to poll.
+     */
+    void schedule( Group* p_group );
+
+    /**
+     * \brief   Read the elements of a group.
+     *
+     *          Called from the executor. The timer of the group is
+     *          restarted afterwards.
+     *
+     * \param   p_group Group to poll.
+     * \param   start   Time the interval of the group expired.
+     */
+    void poll( Group* p_group, std::chrono::steady_clock::time_point start );
+
+    /**
+     * \brief   Finish a poll handed to the executor.
+     *
+     *          Deletes the group if it was detached.
+     *
+     * \param   lock    Lock of the poller, released on return.
+     * \param   p_group Group polled.
+     */
+    void finish( std::unique_lock< std::mutex >& lock, Group* p_group );
+
+private:
+
+    /** timer */
+    DeviceDataTimer* mp_timer;
+
+    /** executor reading the elements */
+    DeviceDataExecutor* mp_exec;
+
+    /** executor created by the poller or NULL */
+    DeviceDataExecutor* mp_ownExec;
+
+    /** groups by device and interval */
+    std::unordered_map< s_key, Group*, s_keyHash > m_groups;
+
+    /** registrations by their handles */
+    std::unordered_map< t_handle, s_reg > m_regs;
+
+    /** last handle assigned */
+    t_handle m_handle;
+
+    /** number of polls handed to the executor and not finished yet */
+    uint32_t m_queued;
+
+    /** protects the groups */
+    std::mutex m_mutex;
+
+    /** signals the end of a poll */
+    std::condition_variable m_polled;
+
+    /** statistics */
+    uint64_t m_polls;
+    uint64_t m_reads;
+    uint64_t m_failed;
+};
+
+#endif /* #ifndef __DEVICEDATAPOLLER_H__ */
+
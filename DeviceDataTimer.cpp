@@ -0,0 +1,264 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataTimer.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Shared timer of the device data elements.
+ *
+ *          A single thread serves all the timers using a hashed timing
+ *          wheel. Starting and stopping a timer takes constant time and
+ *          needs no memory allocation since the timer entries are
+ *          part of the objects using them.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include "DeviceDataTimer.h"
+
+
+/*
+ * --- Methods Definition ----------------------------------------------------- *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* DeviceDataTimer()
+*/
+DeviceDataTimer::DeviceDataTimer( uint32_t tickMs, uint32_t numSlots )
+    : m_tickMs( tickMs )
+    , m_mask( 0 )
+    , m_tick( 0 )
+    , m_armed( 0 )
+    , mp_firing( NULL )
+    , m_start( std::chrono::steady_clock::now() )
+    , m_stop( false )
+{
+    uint32_t size = 1;
+
+    if( m_tickMs == 0 )
+        m_tickMs = 1;
+
+    /* the number of slots must be a power of two */
+    while( size < numSlots )
+        size <<= 1;
+    m_mask = size - 1;
+
+    /* initialize the empty lists */
+    m_slots.resize( size );
+    for( uint32_t i = 0; i < size; i++ )
+    {
+        m_slots[i].p_next = &m_slots[i];
+        m_slots[i].p_prev = &m_slots[i];
+        m_slots[i].p_entry = NULL;
+    }
+    m_due.p_next = &m_due;
+    m_due.p_prev = &m_due;
+    m_due.p_entry = NULL;
+
+    m_thread = std::thread( &DeviceDataTimer::run, this );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* ~DeviceDataTimer()
+*/
+DeviceDataTimer::~DeviceDataTimer( void )
+{
+    {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        m_stop = true;
+    }
+    m_cond.notify_all();
+    m_thread.join();
+
+    /* detach the remaining entries */
+    for( size_t i = 0; i < m_slots.size(); i++ )
+    {
+        while( m_slots[i].p_next != &m_slots[i] )
+            unlink( m_slots[i].p_next );
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* start()
+*/
+int16_t DeviceDataTimer::start( Entry* p_entry, uint32_t delay )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+
+    if( m_stop )
+        return -1;
+
+    if( p_entry->m_link.p_next != NULL )
+        unlink( &p_entry->m_link );
+    else
+        m_armed++;
+
+    if( m_armed == 1 )
+        /* the wheel was idle, continue from the actual time */
+        m_tick = now();
+
+    /* round up to the resolution, the actual tick is over already */
+    uint64_t ticks = ((uint64_t)delay + m_tickMs - 1) / m_tickMs;
+    if( ticks == 0 )
+        ticks = 1;
+
+    p_entry->m_rounds = (uint32_t)((ticks - 1) / m_slots.size());
+    link( &m_slots[(m_tick + ticks) & m_mask], &p_entry->m_link );
+
+    if( m_armed == 1 )
+        m_cond.notify_one();
+    return 0;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* stop()
+*/
+void DeviceDataTimer::stop( Entry* p_entry )
+{
+    std::unique_lock< std::mutex > lock( m_mutex );
+
+    if( p_entry->m_link.p_next != NULL )
+    {
+        unlink( &p_entry->m_link );
+        m_armed--;
+    }
+
+    /* wait for a running expiry function to return */
+    if( std::this_thread::get_id() != m_thread.get_id() )
+    {
+        while( mp_firing == p_entry )
+            m_fired.wait( lock );
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* getArmed()
+*/
+uint32_t DeviceDataTimer::getArmed( void )
+{
+    std::lock_guard< std::mutex > lock( m_mutex );
+    return m_armed;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* run()
+*/
+void DeviceDataTimer::run( void )
+{
+    std::unique_lock< std::mutex > lock( m_mutex );
+
+    while( m_stop == false )
+    {
+        if( m_armed == 0 )
+        {
+            /* nothing to do until a timer is started */
+            m_cond.wait( lock );
+            continue;
+        }
+
+        std::chrono::steady_clock::time_point next = m_start +
+            std::chrono::milliseconds( (m_tick + 1) * m_tickMs );
+
+        if( std::chrono::steady_clock::now() < next )
+        {
+            m_cond.wait_until( lock, next );
+            continue;
+        }
+
+        m_tick++;
+        expire( lock, (uint32_t)(m_tick & m_mask) );
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* expire()
+*/
+void DeviceDataTimer::expire( std::unique_lock< std::mutex >& lock, uint32_t slot )
+{
+    s_link* p_head = &m_slots[slot];
+    s_link* p_link = p_head->p_next;
+
+    /* collect the expired entries of the slot */
+    while( p_link != p_head )
+    {
+        s_link* p_next = p_link->p_next;
+
+        if( p_link->p_entry->m_rounds > 0 )
+            p_link->p_entry->m_rounds--;
+        else
+        {
+            unlink( p_link );
+            link( &m_due, p_link );
+        }
+        p_link = p_next;
+    }
+
+    /* call the expiry functions without holding the lock. The entries
+     * might be stopped or restarted in the meantime. */
+    while( m_due.p_next != &m_due )
+    {
+        Entry* p_entry = m_due.p_next->p_entry;
+
+        unlink( &p_entry->m_link );
+        m_armed--;
+        mp_firing = p_entry;
+
+        lock.unlock();
+        p_entry->expired();
+        lock.lock();
+
+        mp_firing = NULL;
+        m_fired.notify_all();
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* now()
+*/
+uint64_t DeviceDataTimer::now( void ) const
+{
+    return (uint64_t)std::chrono::duration_cast< std::chrono::milliseconds >(
+        std::chrono::steady_clock::now() - m_start ).count() / m_tickMs;
+}
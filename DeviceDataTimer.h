@@ -0,0 +1,290 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataTimer.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Shared timer of the device data elements.
+ *
+ *          A single thread serves all the timers using a hashed timing
+ *          wheel. Starting and stopping a timer takes constant time and
+ *          needs no memory allocation since the timer entries are
+ *          part of the objects using them.
+ */
+
+
+#ifndef __DEVICEDATATIMER_H__
+#define __DEVICEDATATIMER_H__
+#ifndef __DECL_DEVICEDATATIMER_H__
+#define __DECL_DEVICEDATATIMER_H__ extern
+#endif /* #ifndef __DECL_DEVICEDATATIMER_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <vector>
+#include <chrono>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** default resolution of the timer in ms */
+#define DEVICEDATATIMER_TICK_MS             10
+
+/** default number of slots of the timing wheel */
+#define DEVICEDATATIMER_SLOTS               512
+
+
+/*
+ * --- Class Definition ----------------------------------------------------- *
+ */
+
+/**
+ * \brief   DeviceDataTimer Class.
+ *
+ *          Timers are rounded up to the resolution of the timer. The
+ *          expiry functions are called from the timer thread one after
+ *          the other and shall return quickly.
+ */
+class DeviceDataTimer
+{
+
+public:
+
+    class Entry;
+
+    /** link of the lists of the timing wheel */
+    struct s_link
+    {
+        /** next element */
+        s_link* p_next;
+        /** previous element */
+        s_link* p_prev;
+        /** entry the link belongs to or NULL for list heads */
+        Entry* p_entry;
+    };
+
+    /**
+     * \brief   Timer entry.
+     *
+     *          Classes using the timer derive from the entry and
+     *          implement expired().
+     */
+    class Entry
+    {
+
+        friend class DeviceDataTimer;
+
+    public:
+
+        /**
+         * \brief   Default Constructor of a timer entry.
+         */
+        Entry( void )
+            : m_rounds( 0 ) {
+            m_link.p_next = NULL;
+            m_link.p_prev = NULL;
+            m_link.p_entry = this;
+        };
+
+        /**
+         * \brief   Default Destructor of a timer entry.
+         *
+         *          The entry must be stopped before it is destroyed.
+         */
+        virtual ~Entry( void ) {};
+
+    private:
+
+        /**
+         * \brief   Called from the timer thread when the timer expired.
+         */
+        virtual void expired( void ) = 0;
+
+    private:
+
+        /** link within the timing wheel */
+        s_link m_link;
+
+        /** remaining rotations of the wheel before the timer expires */
+        uint32_t m_rounds;
+    };
+
+
+    /**
+     * \brief   Constructor to create a timer.
+     *
+     * \param   tickMs      Resolution of the timer in ms.
+     * \param   numSlots    Number of slots of the timing wheel. It is
+     *                      rounded up to the next power of two.
+     */
+    DeviceDataTimer( uint32_t tickMs = DEVICEDATATIMER_TICK_MS,
+            uint32_t numSlots = DEVICEDATATIMER_SLOTS );
+
+    /**
+     * \brief   Default Destructor of the timer.
+     *
+     *          Stops the timer thread. Timers not yet expired are dropped.
+     */
+    virtual ~DeviceDataTimer( void );
+
+    /**
+     * \brief   Start a timer.
+     *
+     *          A running timer is restarted with the new delay.
+     *
+     * \param   p_entry     Timer entry.
+     * \param   delay       Delay in ms.
+     *
+     * \return  0 on success or -1 if the timer is stopping.
+     */
+    int16_t start( Entry* p_entry, uint32_t delay );
+
+    /**
+     * \brief   Stop a timer.
+     *
+     *          If the expiry function of the entry is running in the
+     *          meantime the function waits until it returned, except if
+     *          called from the expiry function itself.
+     *
+     * \param   p_entry     Timer entry.
+     */
+    void stop( Entry* p_entry );
+
+    /**
+     * \brief   Get the resolution of the timer.
+     *
+     * \return  Resolution in ms.
+     */
+    uint32_t getTick( void ) const {
+        return m_tickMs;
+    }
+
+    /**
+     * \brief   Get the number of running timers.
+     *
+     * \return  Number of running timers.
+     */
+    uint32_t getArmed( void );
+
+private:
+
+    /**
+     * \brief   Timer thread function.
+     */
+    void run( void );
+
+    /**
+     * \brief   Process the expired timers of a slot.
+     *
+     * \param   lock        Lock of the timer which is released while
+     *                      calling the expiry functions.
+     * \param   slot        Slot to process.
+     */
+    void expire( std::unique_lock< std::mutex >& lock, uint32_t slot );
+
+    /**
+     * \brief   Get the number of ticks since the timer was started.
+     *
+     * \return  Actual tick.
+     */
+    uint64_t now( void ) const;
+
+    /** insert an element at the end of a list */
+    static void link( s_link* p_head, s_link* p_link ) {
+        p_link->p_next = p_head;
+        p_link->p_prev = p_head->p_prev;
+        p_head->p_prev->p_next = p_link;
+        p_head->p_prev = p_link;
+    }
+
+    /** remove an element from its list */
+    static void unlink( s_link* p_link ) {
+        p_link->p_prev->p_next = p_link->p_next;
+        p_link->p_next->p_prev = p_link->p_prev;
+        p_link->p_next = NULL;
+        p_link->p_prev = NULL;
+    }
+
+private:
+
+    /** resolution in ms */
+    uint32_t m_tickMs;
+
+    /** mask to get the slot from a tick */
+    uint32_t m_mask;
+
+    /** list heads of the slots */
+    std::vector< s_link > m_slots;
+
+    /** expired entries of the slot being processed */
+    s_link m_due;
+
+    /** last tick processed */
+    uint64_t m_tick;
+
+    /** number of running timers */
+    uint32_t m_armed;
+
+    /** entry whose expiry function is running */
+    Entry* mp_firing;
+
+    /** start time of the timer */
+    std::chrono::steady_clock::time_point m_start;
+
+    /** lock of the wheel */
+    std::mutex m_mutex;
+
+    /** signals changes to the timer thread */
+    std::condition_variable m_cond;
+
+    /** signals the end of an expiry function */
+    std::condition_variable m_fired;
+
+    /** timer is stopping */
+    bool m_stop;
+
+    /** timer thread */
+    std::thread m_thread;
+};
+
+#endif /* #ifndef __DEVICEDATATIMER_H__ */
@@ -0,0 +1,368 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataTraits.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Compile time description of the device data value types.
+ *
+ *          The traits map a C++ type to the according type of a device
+ *          data value and access the value without checking its type at
+ *          runtime. The value handed over must be of the type given by
+ *          the traits.
+ */
+
+
+#ifndef __DEVICEDATATRAITS_H__
+#define __DEVICEDATATRAITS_H__
+#ifndef __DECL_DEVICEDATATRAITS_H__
+#define __DECL_DEVICEDATATRAITS_H__ extern
+#endif /* #ifndef __DECL_DEVICEDATATRAITS_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <type_traits>
+#include "DeviceDataValue.h"
+
+
+/*
+ * --- Class Definition ----------------------------------------------------- *
+ */
+
+/**
+ * \brief   Base of the device data traits.
+ *
+ *          Provides the traits with access to the storage of the values.
+ */
+class DeviceDataTraitsBase
+{
+protected:
+
+    /**
+     * \brief   Get the numeric storage of a value.
+     *
+     * \param   v       The value.
+     *
+     * \return  The numeric storage.
+     */
+    static DeviceDataValue::u_val& num( DeviceDataValue& v ) {
+        return v.m_data.num;
+    }
+
+    /**
+     * \brief   Get the numeric storage of a value.
+     *
+     * \param   v       The value.
+     *
+     * \return  The numeric storage.
+     */
+    static const DeviceDataValue::u_val& num( const DeviceDataValue& v ) {
+        return v.m_data.num;
+    }
+
+    /**
+     * \brief   Store a string or opaque payload.
+     *
+     *          Strings are terminated, opaque payloads are not.
+     *
+     * \param   v       The value.
+     * \param   p       Payload to store.
+     * \param   len     Length of the payload.
+     */
+    static void store( DeviceDataValue& v, const void* p, size_t len ) {
+        if( v.m_type == DeviceDataValue::TYPE_STRING )
+            v.setStr( (const char*)p, len );
+        else
+        {
+            memcpy( v.reserve( len ), p, len );
+            v.m_len = (uint32_t)len;
+        }
+    }
+
+    /**
+     * \brief   Compare the string or opaque payloads of two values.
+     *
+     * \param   a       First value.
+     * \param   b       Second value.
+     *
+     * \return  true if both payloads are equal.
+     */
+    static bool equalData( const DeviceDataValue& a, const DeviceDataValue& b ) {
+        return (a.m_len == b.m_len) &&
+            (memcmp( a.data(), b.data(), a.m_len ) == 0);
+    }
+};
+
+
+/**
+ * \brief   Traits of the numeric types.
+ *
+ *          T is the C++ type, TYPE the value type and MEMBER the member
+ *          of the numeric storage the value is kept in.
+ */
+template < typename T, DeviceDataValue::e_type TYPE_, T DeviceDataValue::u_val::* MEMBER >
+class DeviceDataTraitsNum
+        : public DeviceDataTraitsBase
+{
+public:
+
+    /** type of the device data value */
+    static constexpr DeviceDataValue::e_type TYPE = TYPE_;
+
+    /** get the value, values of other types are converted */
+    static void get( const DeviceDataValue& v, T& val ) {
+        if( v.getType() == TYPE )
+            val = num( v ).*MEMBER;
+        else
+            val = v.getNum< T >();
+    }
+
+    /** set the value */
+    static void set( DeviceDataValue& v, const T& val ) {
+        num( v ).*MEMBER = val;
+    }
+
+    /** compare two values */
+    static bool equal( const DeviceDataValue& a, const DeviceDataValue& b ) {
+        if( (a.getType() != TYPE) || (b.getType() != TYPE) )
+            return a == b;
+        return (num( a ).*MEMBER) == (num( b ).*MEMBER);
+    }
+
+    /** write the value as text, returns the number of characters */
+    static size_t toChars( const DeviceDataValue& v, char* buf, size_t size ) {
+        if( v.getType() != TYPE )
+            return v.toChars( buf, size );
+        return DeviceDataValueConv::toChars( buf, size, num( v ).*MEMBER );
+    }
+
+    /** parse the value from text, returns 0 on success */
+    static int16_t fromChars( DeviceDataValue& v, const char* str, size_t len ) {
+        typename std::conditional< std::is_integral< T >::value,
+            int64_t, double >::type parsed;
+
+        if( v.getType() != TYPE )
+            return v.setVal( str, len );
+        if( DeviceDataValueConv::fromChars( str, str + len, parsed ) != 0 )
+            return -1;
+        num( v ).*MEMBER = (T)parsed;
+        return 0;
+    }
+};
+
+
+/**
+ * \brief   Device data traits.
+ *
+ *          Specialized for int32_t, int64_t, float, double, bool,
+ *          std::string and std::vector<uint8_t>.
+ */
+template < typename T >
+class DeviceDataTraits;
+
+/** integer traits */
+template < >
+class DeviceDataTraits< int32_t >
+        : public DeviceDataTraitsNum< int32_t, DeviceDataValue::TYPE_INTEGER,
+            &DeviceDataValue::u_val::i32 > {};
+
+/** 64 bit integer traits */
+template < >
+class DeviceDataTraits< int64_t >
+        : public DeviceDataTraitsNum< int64_t, DeviceDataValue::TYPE_INTEGER64,
+            &DeviceDataValue::u_val::i64 > {};
+
+/** float traits */
+template < >
+class DeviceDataTraits< float >
+        : public DeviceDataTraitsNum< float, DeviceDataValue::TYPE_FLOAT,
+            &DeviceDataValue::u_val::f > {};
+
+/** double traits */
+template < >
+class DeviceDataTraits< double >
+        : public DeviceDataTraitsNum< double, DeviceDataValue::TYPE_DOUBLE,
+            &DeviceDataValue::u_val::d > {};
+
+/**
+ * \brief   Boolean traits.
+ *
+ *          Booleans are stored as integer 0 or 1.
+ */
+template < >
+class DeviceDataTraits< bool >
+        : public DeviceDataTraitsBase
+{
+public:
+
+    /** type of the device data value */
+    static constexpr DeviceDataValue::e_type TYPE = DeviceDataValue::TYPE_INTEGER;
+
+    /** get the value, values of other types are converted */
+    static void get( const DeviceDataValue& v, bool& val ) {
+        if( v.getType() == TYPE )
+            val = (num( v ).i32 != 0);
+        else
+            val = (v.getNum< double >() != 0);
+    }
+
+    /** set the value */
+    static void set( DeviceDataValue& v, const bool& val ) {
+        num( v ).i32 = val ? 1 : 0;
+    }
+
+    /** compare two values */
+    static bool equal( const DeviceDataValue& a, const DeviceDataValue& b ) {
+        if( (a.getType() != TYPE) || (b.getType() != TYPE) )
+            return a == b;
+        return (num( a ).i32 != 0) == (num( b ).i32 != 0);
+    }
+
+    /** write the value as text, returns the number of characters */
+    static size_t toChars( const DeviceDataValue& v, char* buf, size_t size ) {
+        if( v.getType() != TYPE )
+            return v.toChars( buf, size );
+        if( size < 1 )
+            return 0;
+        buf[0] = (num( v ).i32 != 0) ? '1' : '0';
+        return 1;
+    }
+
+    /** parse the value from text, returns 0 on success */
+    static int16_t fromChars( DeviceDataValue& v, const char* str, size_t len ) {
+        int64_t parsed;
+        if( v.getType() != TYPE )
+            return v.setVal( str, len );
+        if( DeviceDataValueConv::fromChars( str, str + len, parsed ) != 0 )
+            return -1;
+        num( v ).i32 = (parsed != 0) ? 1 : 0;
+        return 0;
+    }
+};
+
+/**
+ * \brief   String traits.
+ */
+template < >
+class DeviceDataTraits< std::string >
+        : public DeviceDataTraitsBase
+{
+public:
+
+    /** type of the device data value */
+    static constexpr DeviceDataValue::e_type TYPE = DeviceDataValue::TYPE_STRING;
+
+    /** get the value */
+    static void get( const DeviceDataValue& v, std::string& val ) {
+        val.assign( (const char*)v.getOpaque(), v.getLen() );
+    }
+
+    /** set the value */
+    static void set( DeviceDataValue& v, const std::string& val ) {
+        store( v, val.data(), val.size() );
+    }
+
+    /** compare two values */
+    static bool equal( const DeviceDataValue& a, const DeviceDataValue& b ) {
+        return equalData( a, b );
+    }
+
+    /** write the value as text, returns the number of characters */
+    static size_t toChars( const DeviceDataValue& v, char* buf, size_t size ) {
+        if( v.getLen() > size )
+            return 0;
+        memcpy( buf, v.getOpaque(), v.getLen() );
+        return v.getLen();
+    }
+
+    /** parse the value from text, CR and LF stop the string */
+    static int16_t fromChars( DeviceDataValue& v, const char* str, size_t len ) {
+        size_t l = 0;
+        while( (l < len) && (str[l] != '\r') && (str[l] != '\n') &&
+            (str[l] != '\0') )
+            l++;
+        store( v, str, l );
+        return 0;
+    }
+};
+
+/**
+ * \brief   Opaque traits.
+ *
+ *          Opaque values have no text representation.
+ */
+template < >
+class DeviceDataTraits< std::vector< uint8_t > >
+        : public DeviceDataTraitsBase
+{
+public:
+
+    /** type of the device data value */
+    static constexpr DeviceDataValue::e_type TYPE = DeviceDataValue::TYPE_OPAQUE;
+
+    /** get the value */
+    static void get( const DeviceDataValue& v, std::vector< uint8_t >& val ) {
+        val.assign( v.getOpaque(), v.getOpaque() + v.getLen() );
+    }
+
+    /** set the value */
+    static void set( DeviceDataValue& v, const std::vector< uint8_t >& val ) {
+        store( v, val.data(), val.size() );
+    }
+
+    /** compare two values */
+    static bool equal( const DeviceDataValue& a, const DeviceDataValue& b ) {
+        return equalData( a, b );
+    }
+
+    /** write the value as text, not supported */
+    static size_t toChars( const DeviceDataValue&, char*, size_t ) {
+        return 0;
+    }
+
+    /** parse the value from text, not supported */
+    static int16_t fromChars( DeviceDataValue&, const char*, size_t ) {
+        return -1;
+    }
+};
+
+#endif /* #ifndef __DEVICEDATATRAITS_H__ */
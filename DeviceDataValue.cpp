@@ -0,0 +1,160 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataValue.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Description of a single device data value element.
+ *
+ *          A device data value element holds the actual data with a specific
+ *          type such as integer float or string.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include "DeviceDataValue.h"
+#include <mutex>
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** size of the smallest pool buffers */
+#define DEVICEDATAVALUE_POOL_MINSIZE        32
+
+/** number of pool size classes, each doubling the size */
+#define DEVICEDATAVALUE_POOL_CLASSES        8
+
+/** maximum number of free buffers kept per size class */
+#define DEVICEDATAVALUE_POOL_MAXFREE        1024
+
+/*
+ * --- Local Variables ------------------------------------------------------ *
+ */
+
+/** free buffers of a size class */
+struct s_poolClass
+{
+    /** lock of the class */
+    std::mutex mutex;
+    /** list of free buffers linked using their first bytes */
+    uint8_t* p_free;
+    /** number of free buffers */
+    uint32_t num;
+};
+
+/** the size classes of the pool */
+static s_poolClass g_pool[DEVICEDATAVALUE_POOL_CLASSES];
+
+/** conversion matrix of the value types */
+constexpr bool DeviceDataValue::m_convMatrix[DEVICEDATAVALUE_TYPES][DEVICEDATAVALUE_TYPES];
+
+
+/*
+ * --- Methods Definition ----------------------------------------------------- *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* poolAlloc()
+*/
+uint8_t* DeviceDataValue::poolAlloc( size_t size, uint32_t& cap )
+{
+    uint32_t classSize = DEVICEDATAVALUE_POOL_MINSIZE;
+
+    for( int i = 0; i < DEVICEDATAVALUE_POOL_CLASSES; i++ )
+    {
+        if( size <= classSize )
+        {
+            s_poolClass& c = g_pool[i];
+            uint8_t* p = NULL;
+
+            {
+                std::lock_guard< std::mutex > lock( c.mutex );
+                if( c.p_free != NULL )
+                {
+                    /* take a buffer from the free list */
+                    p = c.p_free;
+                    memcpy( &c.p_free, p, sizeof(uint8_t*) );
+                    c.num--;
+                }
+            }
+
+            if( p == NULL )
+                p = new uint8_t[classSize];
+
+            cap = classSize;
+            return p;
+        }
+        classSize <<= 1;
+    }
+
+    /* too large for the pool */
+    cap = (uint32_t)size;
+    return new uint8_t[size];
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* poolFree()
+*/
+void DeviceDataValue::poolFree( uint8_t* p, uint32_t cap )
+{
+    uint32_t classSize = DEVICEDATAVALUE_POOL_MINSIZE;
+
+    for( int i = 0; i < DEVICEDATAVALUE_POOL_CLASSES; i++ )
+    {
+        if( cap == classSize )
+        {
+            s_poolClass& c = g_pool[i];
+            std::lock_guard< std::mutex > lock( c.mutex );
+
+            if( c.num < DEVICEDATAVALUE_POOL_MAXFREE )
+            {
+                /* put the buffer to the free list */
+                memcpy( p, &c.p_free, sizeof(uint8_t*) );
+                c.p_free = p;
+                c.num++;
+                return;
+            }
+            break;
+        }
+        classSize <<= 1;
+    }
+
+    delete[] p;
+}
@@ -60,20 +60,44 @@
 #include <iostream>
 #include <string>
 #include <arpa/inet.h>
+#include "DeviceDataValueConv.h"
 
 /*
  * --- DEFINES -------------------------------------------------------------- *
  */
 
-/** maximum length of the value as a string */
-#define DEVICEDATAVALUE_STRMAX            50
-#define DEVICEDATAVALUE_OPAQUEMAX         50
+/** maximum length of string (incl. termination) and opaque values
+ * that are stored inline without additional memory */
+#define DEVICEDATAVALUE_INLINEMAX         16
+
+/** maximum length of a number given as string */
+#define DEVICEDATAVALUE_NUMSTRMAX         64
+
+/** number of value types */
+#define DEVICEDATAVALUE_TYPES             6
+
+/*
+ * --- Forward Declaration ----------------------------------------------------- *
+ */
+class DeviceDataTraitsBase;
 
 /*
  * --- Class Definition ----------------------------------------------------- *
  */
+
+/**
+ * \brief   DeviceDataValue Class.
+ *
+ *          Numeric values as well as short strings and opaque values are
+ *          stored inline. Longer strings and opaque values are stored in
+ *          buffers taken from a pool of size classes. A buffer is kept as
+ *          long as following values fit into it.
+ */
 class DeviceDataValue
 {
+
+    friend class DeviceDataTraitsBase;
+
 public:
 
     /** Enumeration for the different types of the value */
@@ -86,26 +110,24 @@ public:
         /** string type */
         TYPE_STRING,
         /** Opaque type */
-        TYPE_OPAQUE
+        TYPE_OPAQUE,
+        /** 64 bit integer type */
+        TYPE_INTEGER64,
+        /** double type */
+        TYPE_DOUBLE
     };
 
-    /** union of the value */
+    /** union of numeric values */
     union u_val
     {
         /** value as integer */
         int32_t i32;
         /** value as float */
         float f;
-        /** value as string */
-        char cStr[DEVICEDATAVALUE_STRMAX];
-
-        union
-        {
-          /** value */
-          uint8_t val[DEVICEDATAVALUE_OPAQUEMAX];
-          /** length */
-          uint16_t len;
-        } u_opaque;
+        /** value as 64 bit integer */
+        int64_t i64;
+        /** value as double */
+        double d;
     };
 
     /** overloaded comparison operator */
@@ -118,28 +140,31 @@ public:
         switch( cmp1.m_type )
         {
             case TYPE_INTEGER:
-                if( cmp1.m_val.i32 != cmp2.m_val.i32 )
+                if( cmp1.m_data.num.i32 != cmp2.m_data.num.i32 )
                     return false;
                 break;
 
             case TYPE_FLOAT:
-                if( cmp1.m_val.f != cmp2.m_val.f )
+                if( cmp1.m_data.num.f != cmp2.m_data.num.f )
                     return false;
                 break;
 
-            case TYPE_STRING:
-                if( strlen(cmp1.m_val.cStr) != strlen(cmp2.m_val.cStr) )
+            case TYPE_INTEGER64:
+                if( cmp1.m_data.num.i64 != cmp2.m_data.num.i64 )
                     return false;
-                if(strcmp(cmp1.m_val.cStr, cmp2.m_val.cStr) != 0)
+                break;
+
+            case TYPE_DOUBLE:
+                if( cmp1.m_data.num.d != cmp2.m_data.num.d )
                     return false;
                 break;
 
+            case TYPE_STRING:
             case TYPE_OPAQUE:
-                if( cmp1.m_val.u_opaque.len != cmp2.m_val.u_opaque.len )
+                if( cmp1.m_len != cmp2.m_len )
+                    return false;
+                if( memcmp( cmp1.data(), cmp2.data(), cmp1.m_len ) != 0)
                     return false;
-                if( memcmp( cmp1.m_val.u_opaque.val, cmp2.m_val.u_opaque.val,
-                    cmp1.m_val.u_opaque.len ) != 0)
-                  return false;
                 break;
 
             default:
@@ -155,22 +180,110 @@ public:
         return ! (cmp1 == cmp2);
     }
 
+    /**
+     * \brief   Check if a value type can be converted into another one.
+     *
+     *          The conversion matrix is available at compile time.
+     *          Numbers and strings can be converted into each other. Opaque
+     *          values can be converted into strings and into numbers of the
+     *          according size in network byte order. Nothing but opaque
+     *          values can be converted into opaque values.
+     *
+     * \param   from    Source type.
+     * \param   to      Destination type.
+     *
+     * \return  true if the conversion is supported.
+     */
+    static constexpr bool isConvertible( e_type from, e_type to ) {
+        return m_convMatrix[from][to];
+    }
+
+    /**
+     * \brief   Check if a type is numeric.
+     *
+     * \param   type    Type to check.
+     *
+     * \return  true for numeric types.
+     */
+    static constexpr bool isNumeric( e_type type ) {
+        return (type != TYPE_STRING) && (type != TYPE_OPAQUE);
+    }
+
     /**
      * \brief   Constructor with a specific default type.
      *
      * \param   type    Type of the value.
      */
     DeviceDataValue( DeviceDataValue::e_type type )
-        : m_type( type ) {
+        : m_type( type )
+        , m_heap( false )
+        , m_len( 0 ) {
 
         /* reset members */
-        memset( &m_val, 0, sizeof(m_val) );
+        memset( &m_data, 0, sizeof(m_data) );
     };
 
+    /**
+     * \brief   Copy constructor.
+     *
+     * \param   val     Value to copy.
+     */
+    DeviceDataValue( const DeviceDataValue& val )
+        : m_type( val.m_type )
+        , m_heap( false )
+        , m_len( 0 ) {
+
+        memset( &m_data, 0, sizeof(m_data) );
+        assign( val );
+    }
+
+    /**
+     * \brief   Move constructor.
+     *
+     * \param   val     Value to move.
+     */
+    DeviceDataValue( DeviceDataValue&& val )
+        : m_type( val.m_type )
+        , m_heap( val.m_heap )
+        , m_len( val.m_len )
+        , m_data( val.m_data ) {
+
+        /* the buffer belongs to this value now */
+        val.m_heap = false;
+        val.m_len = 0;
+    }
+
     /**
      * \brief   Default destructor.
      */
-    virtual ~DeviceDataValue( void ) {};
+    ~DeviceDataValue( void ) {
+        release();
+    };
+
+    /** assignment operator */
+    DeviceDataValue& operator=( const DeviceDataValue& val ) {
+        if( this != &val )
+        {
+            m_type = val.m_type;
+            assign( val );
+        }
+        return *this;
+    }
+
+    /** move assignment operator */
+    DeviceDataValue& operator=( DeviceDataValue&& val ) {
+        if( this != &val )
+        {
+            release();
+            m_type = val.m_type;
+            m_heap = val.m_heap;
+            m_len = val.m_len;
+            m_data = val.m_data;
+            val.m_heap = false;
+            val.m_len = 0;
+        }
+        return *this;
+    }
 
     /**
      * \brief    Get the type of the value,
@@ -180,78 +293,148 @@ public:
     int16_t getType( void ) const {return m_type;}
 
     /**
-     * \brief    Get the actual value,
+     * \brief    Get the actual numeric value,
      *
      *     \return The actual value
      */
-    u_val getVal( void ) const {return m_val;}
+    u_val getVal( void ) const {return m_data.num;}
+
+    /**
+     * \brief    Get the actual numeric value converted to a specific type.
+     *
+     *     \return The actual value or 0 if the value is not numeric.
+     */
+    template < typename T >
+    T getNum( void ) const {
+        switch( m_type )
+        {
+            case TYPE_INTEGER:
+                return (T)m_data.num.i32;
+            case TYPE_FLOAT:
+                return (T)m_data.num.f;
+            case TYPE_INTEGER64:
+                return (T)m_data.num.i64;
+            case TYPE_DOUBLE:
+                return (T)m_data.num.d;
+            default:
+                return (T)0;
+        }
+    }
+
+    /**
+     * \brief    Get the actual value as string.
+     *
+     *     \return The zero terminated string or an empty string if the
+     *             value is not of type string.
+     */
+    const char* getStr( void ) const {
+        if( m_type != TYPE_STRING )
+            return "";
+        return (const char*)data();
+    }
+
+    /**
+     * \brief    Get the actual value as opaque.
+     *
+     *     \return The data of a string or opaque value.
+     */
+    const uint8_t* getOpaque( void ) const {return data();}
+
+    /**
+     * \brief    Get the length of a string or opaque value.
+     *
+     *     \return Length of the value in bytes excluding the termination
+     *             of strings.
+     */
+    uint32_t getLen( void ) const {return m_len;}
+
+    /**
+     * \brief    Write the value as text.
+     *
+     *             Numbers are written using their shortest lossless
+     *             representation. No termination is written.
+     *
+     *     \param    buf        Buffer to write to.
+     *     \param    size       Size of the buffer.
+     *
+     *     \return Number of characters written or 0 if the buffer is too
+     *             small or the value is opaque.
+     */
+    size_t toChars( char* buf, size_t size ) const {
+        switch( m_type )
+        {
+            case TYPE_INTEGER:
+                return DeviceDataValueConv::toChars( buf, size, (int64_t)m_data.num.i32 );
+            case TYPE_FLOAT:
+                return DeviceDataValueConv::toChars( buf, size, m_data.num.f );
+            case TYPE_INTEGER64:
+                return DeviceDataValueConv::toChars( buf, size, m_data.num.i64 );
+            case TYPE_DOUBLE:
+                return DeviceDataValueConv::toChars( buf, size, m_data.num.d );
+            case TYPE_STRING:
+                if( m_len > size )
+                    return 0;
+                memcpy( buf, data(), m_len );
+                return m_len;
+            default:
+                return 0;
+        }
+    }
 
     /**
      * \brief    Set the value of the data value element as integer,
      *
      *             Sets the value of the data element as as integer. If
-     *             the types do not match the value will not be assigned.
+     *             the types do not match the value will be converted.
      *
      *     \param    val        Value to set.
      *
      *     \return 0 on success.
      */
     int16_t setVal( int32_t val ) {
-        if( m_type == TYPE_INTEGER )
-        {
-            m_val.i32 = val;
-            return 0;
-        }
-        else if( m_type == TYPE_FLOAT )
-        {
-            m_val.f = (float)val;
-            return 0;
-        }
-        else if( m_type == TYPE_STRING )
-        {
-          snprintf(m_val.cStr, DEVICEDATAVALUE_STRMAX,
-                  "%d", val );
-          return 0;
-        }
-        else if ( m_type == TYPE_OPAQUE )
-        {
-          return -1;
-        }
-        return -1;
+        return setNum( val );
+    }
+
+    /**
+     * \brief    Set the value of the data value element as 64 bit integer,
+     *
+     *             Sets the value of the data element as as 64 bit integer.
+     *             If the types do not match the value will be converted.
+     *
+     *     \param    val        Value to set.
+     *
+     *     \return 0 on success.
+     */
+    int16_t setVal( int64_t val ) {
+        return setNum( val );
     }
 
     /**
      * \brief    Set the value of the data value element as float,
      *
      *             Sets the value of the data element as as float. If
-     *             the types do not match the value will not be assigned.
+     *             the types do not match the value will be converted.
      *
      *     \param    val        Value to set.
      *
      *     \return 0 on success.
      */
     int16_t setVal( float val ) {
-        if( m_type == TYPE_FLOAT )
-        {
-            m_val.f = val;
-            return 0;
-        }
-        else if( m_type == TYPE_INTEGER )
-        {
-          m_val.i32 = (int32_t)val;
-          return 0;
-        }
-        else if( m_type == TYPE_STRING )
-        {
-          snprintf(m_val.cStr, DEVICEDATAVALUE_STRMAX,
-                  "%f", val );
-          return 0;
-        }
-        else if ( m_type == TYPE_OPAQUE )
-        {
-          return -1;
-        }
-        return -1;
+        return setNum( val );
+    }
+
+    /**
+     * \brief    Set the value of the data value element as double,
+     *
+     *             Sets the value of the data element as as double. If
+     *             the types do not match the value will be converted.
+     *
+     *     \param    val        Value to set.
+     *
+     *     \return 0 on success.
+     */
+    int16_t setVal( double val ) {
+        return setNum( val );
     }
 
     /**
@@ -259,124 +442,368 @@ public:
      *
      *             Sets the value of the data element as as string.
      *             CR and LF will be ignored and act as a stop
-     *             condition. If the types do not match the value will not
-     *             be assigned.
+     *             condition. Numeric values are parsed from the string.
      *
      *     \param    val        Value to set.
+     *     \param    len        Length of the string.
      *
      *     \return 0 on success.
      */
-    int16_t setVal( std::string val ) {
-        if( m_type == TYPE_STRING )
-        {
-            size_t l = snprintf(m_val.cStr, DEVICEDATAVALUE_STRMAX,
-                    "%s", val.c_str());
-            size_t pos = strcspn( m_val.cStr, "\r\n" );
-
-            /* remove trailing CR or LF if it exists */
-            if( pos  < l )
-                m_val.cStr[pos] = '\0';
-            return 0;
-        }
-        else if( m_type == TYPE_INTEGER )
-        {
-          sscanf( val.c_str(), "%d", &m_val.i32 );
-          return 0;
-        }
-        else if( m_type == TYPE_FLOAT )
-        {
-          sscanf( val.c_str(), "%f", &m_val.f );
-          return 0;
-        }
-        else if ( m_type == TYPE_OPAQUE )
+    int16_t setVal( const char* val, size_t len ) {
+        switch( m_type )
         {
-          return -1;
+            case TYPE_STRING:
+            {
+                /* remove trailing CR or LF if it exists */
+                size_t l = 0;
+                while( (l < len) && (val[l] != '\r') && (val[l] != '\n') &&
+                    (val[l] != '\0') )
+                    l++;
+
+                setStr( val, l );
+                return 0;
+            }
+
+            case TYPE_INTEGER:
+            case TYPE_INTEGER64:
+            {
+                int64_t i64;
+                if( DeviceDataValueConv::fromChars( val, val + len, i64 ) != 0 )
+                    return -1;
+                return setNum( i64 );
+            }
+
+            case TYPE_FLOAT:
+            case TYPE_DOUBLE:
+            {
+                double d;
+                if( DeviceDataValueConv::fromChars( val, val + len, d ) != 0 )
+                    return -1;
+                return setNum( d );
+            }
+
+            default:
+                return -1;
         }
-        return -1;
+    }
+
+    /**
+     * \brief    Set the value of the data value element as string,
+     *
+     *             Sets the value of the data element as as string.
+     *             CR and LF will be ignored and act as a stop
+     *             condition. Numeric values are parsed from the string.
+     *
+     *     \param    val        Value to set.
+     *
+     *     \return 0 on success.
+     */
+    int16_t setVal( const char* val ) {
+        return setVal( val, strlen( val ) );
+    }
+
+    /**
+     * \brief    Set the value of the data value element as string,
+     *
+     *             Sets the value of the data element as as string.
+     *             CR and LF will be ignored and act as a stop
+     *             condition. Numeric values are parsed from the string.
+     *
+     *     \param    val        Value to set.
+     *
+     *     \return 0 on success.
+     */
+    int16_t setVal( const std::string& val ) {
+        return setVal( val.c_str(), val.length() );
     }
 
 
     /**
      * \brief    Set the value of the data value element as opaque.
      *
-     *             Sets the value of the data element as as opaque.
+     *             Sets the value of the data element as as opaque. Numeric
+     *             values are decoded from network byte order if the length
+     *             matches the size of the number.
      *
      *     \param    val        Value to set.
      *     \param    len        Length of the Value to set.
      *
      *     \return 0 on success.
      */
-    int16_t setVal( uint8_t* val, uint16_t len ) {
-        if( m_type == TYPE_STRING )
+    int16_t setVal( const uint8_t* val, size_t len ) {
+        switch( m_type )
         {
-            if( len > (DEVICEDATAVALUE_STRMAX-1) )
-              return -1;
-            memcpy( &m_val.cStr, val, len );
-            m_val.cStr[len] = 0;
-            return 0;
+            case TYPE_STRING:
+                setStr( (const char*)val, len );
+                return 0;
+
+            case TYPE_OPAQUE:
+                memcpy( reserve( len ), val, len );
+                m_len = (uint32_t)len;
+                return 0;
+
+            case TYPE_INTEGER:
+            case TYPE_INTEGER64:
+                /* signed integers of any size */
+                if( (len == 1) || (len == 2) || (len == 4) || (len == 8) )
+                {
+                    int64_t i64 = (int8_t)val[0];
+                    for( size_t i = 1; i < len; i++ )
+                        i64 = (int64_t)(((uint64_t)i64 << 8) | val[i]);
+                    return setNum( i64 );
+                }
+                return -1;
+
+            case TYPE_FLOAT:
+            case TYPE_DOUBLE:
+                if( len == sizeof(float) )
+                {
+                    float f;
+                    uint32_t u32 = ntohl( readU32( val ) );
+                    memcpy( &f, &u32, sizeof(f) );
+                    return setNum( f );
+                }
+                else if( len == sizeof(double) )
+                {
+                    double d;
+                    uint64_t u64 = ((uint64_t)ntohl( readU32( val ) ) << 32) |
+                        ntohl( readU32( val + 4 ) );
+                    memcpy( &d, &u64, sizeof(d) );
+                    return setNum( d );
+                }
+                return -1;
+
+            default:
+                return -1;
         }
-        else if( m_type == TYPE_INTEGER )
+    }
+
+    /**
+     * \brief    Set the value from another value.
+     *
+     *             The value is converted to the type of this value
+     *             according to the conversion matrix.
+     *
+     *     \param    val        Value to convert.
+     *
+     *     \return 0 on success or -1 if the conversion is not supported.
+     */
+    int16_t convert( const DeviceDataValue& val ) {
+        if( isConvertible( (e_type)val.m_type, (e_type)m_type ) == false )
+            return -1;
+
+        switch( val.m_type )
         {
-          switch( len )
-          {
-            case 1:
-              m_val.i32 = (int8_t)val[0];
-              return 1;
-              break;
-
-            case 2:
-            {
-              int16_t value;
-              memcpy( &value, val, len );
-              value = htons( value );
+            case TYPE_INTEGER:
+                return setNum( val.m_data.num.i32 );
+            case TYPE_FLOAT:
+                return setNum( val.m_data.num.f );
+            case TYPE_INTEGER64:
+                return setNum( val.m_data.num.i64 );
+            case TYPE_DOUBLE:
+                return setNum( val.m_data.num.d );
+            case TYPE_STRING:
+                return setVal( (const char*)val.data(), val.m_len );
+            case TYPE_OPAQUE:
+                return setVal( val.data(), val.m_len );
+            default:
+                return -1;
+        }
+    }
 
-              m_val.i32 = value;
-              return 1;
-              break;
-            }
+private:
 
-            case 4:
-            {
-              int32_t value;
-              memcpy( &value, val, len );
-              value = htonl( value );
+    /**
+     * \brief    Set a numeric value.
+     *
+     *             The source type is resolved at compile time, only the
+     *             type of this value is checked at runtime.
+     *
+     *     \param    val        Value to set.
+     *
+     *     \return 0 on success.
+     */
+    template < typename T >
+    int16_t setNum( T val ) {
+        switch( m_type )
+        {
+            case TYPE_INTEGER:
+                m_data.num.i32 = (int32_t)val;
+                return 0;
 
-              m_val.i32 = value;
-              return 1;
-              break;
+            case TYPE_FLOAT:
+                m_data.num.f = (float)val;
+                return 0;
+
+            case TYPE_INTEGER64:
+                m_data.num.i64 = (int64_t)val;
+                return 0;
+
+            case TYPE_DOUBLE:
+                m_data.num.d = (double)val;
+                return 0;
+
+            case TYPE_STRING:
+            {
+                char buf[DEVICEDATAVALUE_NUMSTRMAX];
+                size_t l = DeviceDataValueConv::toChars( buf, sizeof(buf), val );
+                setStr( buf, l );
+                return 0;
             }
-          }
+
+            default:
+                return -1;
         }
-        else if( m_type == TYPE_FLOAT )
-        {
-          int32_t value;
-          if(len != sizeof(float))
-            return -1;
+    }
+
+    /**
+     * \brief    Read an unaligned 32 bit value.
+     *
+     *     \param    p          Data to read from.
+     *
+     *     \return The value as stored in memory.
+     */
+    static uint32_t readU32( const uint8_t* p ) {
+        uint32_t u32;
+        memcpy( &u32, p, sizeof(u32) );
+        return u32;
+    }
+
+    /**
+     * \brief    Get the buffer of a string or opaque value.
+     *
+     *     \return The buffer of the value.
+     */
+    const uint8_t* data( void ) const {
+        return m_heap ? m_data.heap.p : m_data.inl;
+    }
+
+    /**
+     * \brief    Provide a buffer of at least the given size.
+     *
+     *             The buffer in use is kept if it is large enough.
+     *             Otherwise the inline buffer or a buffer from the
+     *             pool is used.
+     *
+     *     \param    size       Required size in bytes.
+     *
+     *     \return The buffer.
+     */
+    uint8_t* reserve( size_t size ) {
+        if( m_heap && (size <= m_data.heap.cap) )
+            return m_data.heap.p;
+
+        release();
+        if( size <= DEVICEDATAVALUE_INLINEMAX )
+            return m_data.inl;
 
-          memcpy( &value, val, len );
-          value = htonl( value );
+        m_data.heap.p = poolAlloc( size, m_data.heap.cap );
+        m_heap = true;
+        return m_data.heap.p;
+    }
+
+    /**
+     * \brief    Release the buffer of the value.
+     */
+    void release( void ) {
+        if( m_heap )
+            poolFree( m_data.heap.p, m_data.heap.cap );
+        m_heap = false;
+    }
 
-          m_val.i32 = value;
-          return 1;
+    /**
+     * \brief    Store a string.
+     *
+     *     \param    str        The string.
+     *     \param    len        Length of the string without termination.
+     */
+    void setStr( const char* str, size_t len ) {
+        uint8_t* p = reserve( len + 1 );
+        memcpy( p, str, len );
+        p[len] = '\0';
+        m_len = (uint32_t)len;
+    }
 
+    /**
+     * \brief    Copy the content of another value.
+     *
+     *     \param    val        Value to copy.
+     */
+    void assign( const DeviceDataValue& val ) {
+        if( (m_type == TYPE_STRING) || (m_type == TYPE_OPAQUE) )
+        {
+            size_t size = val.m_len + ((m_type == TYPE_STRING) ? 1 : 0);
+            memcpy( reserve( size ), val.data(), size );
+            m_len = val.m_len;
         }
-        else if ( m_type == TYPE_OPAQUE )
+        else
         {
-          if( len > DEVICEDATAVALUE_OPAQUEMAX )
-            return -1;
-          memcpy( &m_val.u_opaque.val, val, len );
+            release();
+            m_data.num = val.m_data.num;
+            m_len = 0;
         }
-        return -1;
     }
 
+    /**
+     * \brief    Allocate a buffer from the pool.
+     *
+     *     \param    size       Required size in bytes.
+     *     \param    cap        Returns the actual size of the buffer.
+     *
+     *     \return The buffer.
+     */
+    static uint8_t* poolAlloc( size_t size, uint32_t& cap );
+
+    /**
+     * \brief    Return a buffer to the pool.
+     *
+     *     \param    p          The buffer.
+     *     \param    cap        Size of the buffer.
+     */
+    static void poolFree( uint8_t* p, uint32_t cap );
+
 private:
 
+    /** conversion matrix */
+    static constexpr bool m_convMatrix[DEVICEDATAVALUE_TYPES][DEVICEDATAVALUE_TYPES] =
+    {
+        /* to: INTEGER FLOAT  STRING OPAQUE INTEGER64 DOUBLE */
+        {      true,   true,  true,  false, true,     true  },  /* INTEGER */
+        {      true,   true,  true,  false, true,     true  },  /* FLOAT */
+        {      true,   true,  true,  false, true,     true  },  /* STRING */
+        {      true,   true,  true,  true,  true,     true  },  /* OPAQUE */
+        {      true,   true,  true,  false, true,     true  },  /* INTEGER64 */
+        {      true,   true,  true,  false, true,     true  }   /* DOUBLE */
+    };
+
+    /** storage of the value */
+    union u_store
+    {
+        /** numeric value */
+        u_val num;
+        /** inline string or opaque value */
+        uint8_t inl[DEVICEDATAVALUE_INLINEMAX];
+        /** string or opaque value from the pool */
+        struct
+        {
+            /** buffer */
+            uint8_t* p;
+            /** size of the buffer */
+            uint32_t cap;
+        } heap;
+    };
+
     /** type of the value */
-    e_type m_type;
+    uint8_t m_type;
+
+    /** value is stored in a pool buffer */
+    bool m_heap;
 
-    /** union of the value */
-    u_val m_val;
+    /** length of a string or opaque value */
+    uint32_t m_len;
+
+    /** storage of the value */
+    u_store m_data;
 };
 
 #endif /* #ifndef __DEVICEDATAVALUE_H__ */
-
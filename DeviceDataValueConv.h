@@ -0,0 +1,324 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataValueConv.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Conversion of device data values from and to text.
+ *
+ *          The conversions are locale independent and lossless. If the
+ *          standard library provides std::to_chars and std::from_chars
+ *          (C++17) they are used. Otherwise integers are converted by
+ *          own routines and floating point values fall back to the
+ *          printf/strtod family.
+ */
+
+
+#ifndef __DEVICEDATAVALUECONV_H__
+#define __DEVICEDATAVALUECONV_H__
+#ifndef __DECL_DEVICEDATAVALUECONV_H__
+#define __DECL_DEVICEDATAVALUECONV_H__ extern
+#endif /* #ifndef __DECL_DEVICEDATAVALUECONV_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#if (__cplusplus >= 201703L) && defined(__has_include)
+#if __has_include(<charconv>)
+#include <charconv>
+#endif /* #if __has_include(<charconv>) */
+#endif /* #if (__cplusplus >= 201703L) && defined(__has_include) */
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** std::to_chars/std::from_chars can be used for integers */
+#if defined(__cpp_lib_to_chars) || \
+    ((__cplusplus >= 201703L) && defined(__GLIBCXX__) && (_GLIBCXX_RELEASE >= 8))
+#define DEVICEDATAVALUECONV_CHARCONV_INT
+#endif
+
+/** std::to_chars/std::from_chars can be used for floating point values */
+#if defined(__cpp_lib_to_chars)
+#define DEVICEDATAVALUECONV_CHARCONV_FLOAT
+#endif
+
+/*
+ * --- Class Definition ----------------------------------------------------- *
+ */
+
+/**
+ * \brief   DeviceDataValueConv Class.
+ *
+ *          Provides the text conversions of numeric values. Formatting
+ *          writes no termination and returns the number of characters
+ *          written or 0 if the buffer was too small. Parsing skips
+ *          leading white spaces and a plus sign and stops at the first
+ *          character that does not belong to the number.
+ */
+class DeviceDataValueConv
+{
+
+public:
+
+    /**
+     * \brief   Format an integer.
+     *
+     * \param   buf     Buffer to write to.
+     * \param   size    Size of the buffer.
+     * \param   val     Value to format.
+     *
+     * \return  Number of characters written or 0 on error.
+     */
+    static size_t toChars( char* buf, size_t size, int64_t val ) {
+#if defined(DEVICEDATAVALUECONV_CHARCONV_INT)
+        std::to_chars_result res = std::to_chars( buf, buf + size, val );
+        return (res.ec == std::errc()) ? (size_t)(res.ptr - buf) : 0;
+#else
+        char tmp[20];
+        size_t len = 0;
+        uint64_t uval = (val < 0) ? (0 - (uint64_t)val) : (uint64_t)val;
+
+        /* generate the digits in reverse order */
+        do
+        {
+            tmp[len++] = (char)('0' + (uval % 10));
+            uval /= 10;
+        } while( uval != 0 );
+
+        size_t total = len + ((val < 0) ? 1 : 0);
+        if( total > size )
+            return 0;
+
+        char* p = buf;
+        if( val < 0 )
+            *p++ = '-';
+        while( len > 0 )
+            *p++ = tmp[--len];
+        return total;
+#endif
+    }
+
+    /**
+     * \brief   Format an integer.
+     *
+     * \param   buf     Buffer to write to.
+     * \param   size    Size of the buffer.
+     * \param   val     Value to format.
+     *
+     * \return  Number of characters written or 0 on error.
+     */
+    static size_t toChars( char* buf, size_t size, int32_t val ) {
+        return toChars( buf, size, (int64_t)val );
+    }
+
+    /**
+     * \brief   Format a float using the shortest lossless representation.
+     *
+     * \param   buf     Buffer to write to.
+     * \param   size    Size of the buffer.
+     * \param   val     Value to format.
+     *
+     * \return  Number of characters written or 0 on error.
+     */
+    static size_t toChars( char* buf, size_t size, float val ) {
+#if defined(DEVICEDATAVALUECONV_CHARCONV_FLOAT)
+        std::to_chars_result res = std::to_chars( buf, buf + size, val );
+        return (res.ec == std::errc()) ? (size_t)(res.ptr - buf) : 0;
+#else
+        return printChars( buf, size, val, 6, 9, true );
+#endif
+    }
+
+    /**
+     * \brief   Format a double using the shortest lossless representation.
+     *
+     * \param   buf     Buffer to write to.
+     * \param   size    Size of the buffer.
+     * \param   val     Value to format.
+     *
+     * \return  Number of characters written or 0 on error.
+     */
+    static size_t toChars( char* buf, size_t size, double val ) {
+#if defined(DEVICEDATAVALUECONV_CHARCONV_FLOAT)
+        std::to_chars_result res = std::to_chars( buf, buf + size, val );
+        return (res.ec == std::errc()) ? (size_t)(res.ptr - buf) : 0;
+#else
+        return printChars( buf, size, val, 15, 17, false );
+#endif
+    }
+
+    /**
+     * \brief   Parse an integer.
+     *
+     * \param   first   First character.
+     * \param   last    End of the characters.
+     * \param   val     Parsed value.
+     *
+     * \return  0 on success or -1 if no valid number was found.
+     */
+    static int16_t fromChars( const char* first, const char* last, int64_t& val ) {
+        first = skip( first, last );
+#if defined(DEVICEDATAVALUECONV_CHARCONV_INT)
+        std::from_chars_result res = std::from_chars( first, last, val );
+        return (res.ec == std::errc()) ? 0 : -1;
+#else
+        bool neg = false;
+        uint64_t uval = 0;
+        const char* p = first;
+
+        if( (p < last) && (*p == '-') )
+        {
+            neg = true;
+            p++;
+        }
+
+        const char* digits = p;
+        while( (p < last) && (*p >= '0') && (*p <= '9') )
+        {
+            uint64_t next = (uval * 10) + (uint64_t)(*p - '0');
+            if( (next / 10) != uval )
+                /* overflow */
+                return -1;
+            uval = next;
+            p++;
+        }
+
+        if( p == digits )
+            return -1;
+        if( uval > ((uint64_t)INT64_MAX + (neg ? 1 : 0)) )
+            return -1;
+
+        val = neg ? (int64_t)(0 - uval) : (int64_t)uval;
+        return 0;
+#endif
+    }
+
+    /**
+     * \brief   Parse a double.
+     *
+     * \param   first   First character.
+     * \param   last    End of the characters.
+     * \param   val     Parsed value.
+     *
+     * \return  0 on success or -1 if no valid number was found.
+     */
+    static int16_t fromChars( const char* first, const char* last, double& val ) {
+        first = skip( first, last );
+#if defined(DEVICEDATAVALUECONV_CHARCONV_FLOAT)
+        std::from_chars_result res = std::from_chars( first, last, val );
+        return (res.ec == std::errc()) ? 0 : -1;
+#else
+        /* strtod requires a terminated string */
+        char buf[64];
+        size_t len = (size_t)(last - first);
+        if( len >= sizeof(buf) )
+            len = sizeof(buf) - 1;
+        memcpy( buf, first, len );
+        buf[len] = '\0';
+
+        char* end;
+        double d = strtod( buf, &end );
+        if( end == buf )
+            return -1;
+        val = d;
+        return 0;
+#endif
+    }
+
+private:
+
+    /**
+     * \brief   Skip leading white spaces and a plus sign.
+     *
+     * \param   first   First character.
+     * \param   last    End of the characters.
+     *
+     * \return  First character of the number.
+     */
+    static const char* skip( const char* first, const char* last ) {
+        while( (first < last) && ((*first == ' ') || (*first == '\t')) )
+            first++;
+        if( ((first + 1) < last) && (*first == '+') && (first[1] != '-') )
+            first++;
+        return first;
+    }
+
+#if !defined(DEVICEDATAVALUECONV_CHARCONV_FLOAT)
+    /**
+     * \brief   Format a floating point value using snprintf.
+     *
+     *          The precision is increased until the value can be read
+     *          back without loss.
+     *
+     * \param   buf     Buffer to write to.
+     * \param   size    Size of the buffer.
+     * \param   val     Value to format.
+     * \param   minPrec Minimum precision to try.
+     * \param   maxPrec Maximum precision which is always lossless.
+     * \param   single  Value is a float.
+     *
+     * \return  Number of characters written or 0 on error.
+     */
+    static size_t printChars( char* buf, size_t size, double val,
+            int minPrec, int maxPrec, bool single ) {
+        char tmp[32];
+        int len = 0;
+
+        for( int prec = minPrec; prec <= maxPrec; prec++ )
+        {
+            len = snprintf( tmp, sizeof(tmp), "%.*g", prec, val );
+            if( single ? (strtof( tmp, NULL ) == (float)val) :
+                    (strtod( tmp, NULL ) == val) )
+                break;
+        }
+
+        if( (len <= 0) || ((size_t)len > size) )
+            return 0;
+        memcpy( buf, tmp, len );
+        return (size_t)len;
+    }
+#endif
+};
+
+#endif /* #ifndef __DEVICEDATAVALUECONV_H__ */
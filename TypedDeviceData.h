@@ -0,0 +1,221 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    TypedDeviceData.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Convenience wrapper of a device data element of a type known
+ *          at compile time.
+ *
+ *          The type of a device data element never changes after it was
+ *          created. Typed device data elements offer the value as the
+ *          according C++ type, so the callers do not need to check the
+ *          type of the DeviceDataValue. The accesses still use the generic
+ *          DeviceData functions and their DeviceDataValue. Only the
+ *          conversion between the value and the C++ type, the comparison
+ *          and the text conversion are resolved at compile time.
+ */
+
+
+#ifndef __TYPEDDEVICEDATA_H__
+#define __TYPEDDEVICEDATA_H__
+#ifndef __DECL_TYPEDDEVICEDATA_H__
+#define __DECL_TYPEDDEVICEDATA_H__ extern
+#endif /* #ifndef __DECL_TYPEDDEVICEDATA_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <string>
+#include <utility>
+#include "DeviceData.h"
+#include "DeviceDataTraits.h"
+
+
+/*
+ * --- Class Definition ----------------------------------------------------- *
+ */
+
+/**
+ * \brief   TypedDeviceData Class.
+ *
+ *          T is the C++ type of the value (see DeviceDataTraits) and
+ *          BACKEND the device data class accessing the value
+ *          (e.g. DeviceDataFile or DeviceDataLWM2M). Example:
+ *
+ *          TypedDeviceData< float, DeviceDataLWM2M > temp( "temp",
+ *              "Temperature", DeviceData::ACCESS_READ, p_res );
+ */
+template < typename T, class BACKEND >
+class TypedDeviceData
+        : public BACKEND
+{
+
+public:
+
+    /** C++ type of the value */
+    typedef T t_val;
+
+    /** traits of the value type */
+    typedef DeviceDataTraits< T > t_traits;
+
+
+    /**
+     * \brief   Constructor with a specific name and description.
+     *
+     *          The type of the value is given by T. All the additional
+     *          arguments are handed over to the backend.
+     *
+     * \param   name    Name of the device data element.
+     * \param   descr   Description of the device data element.
+     * \param   access  Access permissions.
+     * \param   args    Additional arguments of the backend.
+     */
+    template < typename... ARGS >
+    TypedDeviceData( std::string name, std::string descr, int access,
+            ARGS&&... args )
+        : BACKEND( name, descr, t_traits::TYPE, access,
+            std::forward< ARGS >( args )... ) {};
+
+    /**
+     * \brief   Default Destructor of the device data element.
+     *
+     *          Queued notifications are delivered before the typed
+     *          element is destroyed.
+     */
+    virtual ~TypedDeviceData( void ) {
+        this->shutdown();
+    };
+
+    /**
+     * \brief   Get the actual value.
+     *
+     *          The cached value is used according to the default maximum
+     *          age of the element.
+     *
+     * \param   val     Returns the actual value.
+     *
+     * \return  0 on success or -1 if the value could not be read.
+     */
+    int16_t get( T& val ) {
+        return get( val, this->getMaxAge() );
+    }
+
+    /**
+     * \brief   Get the actual value.
+     *
+     * \param   val     Returns the actual value.
+     * \param   maxAge  Maximum age of the cached value in ms.
+     *
+     * \return  0 on success or -1 if the value could not be read.
+     */
+    int16_t get( T& val, uint32_t maxAge ) {
+        const DeviceDataValue* p_val = this->getVal( maxAge );
+        if( p_val == NULL )
+            return -1;
+
+        t_traits::get( *p_val, val );
+        return 0;
+    }
+
+    /**
+     * \brief   Set the actual value.
+     *
+     * \param   val     Value to set.
+     *
+     * \return  See DeviceData::setVal().
+     */
+    int16_t set( const T& val ) {
+        DeviceDataValue v( t_traits::TYPE );
+        t_traits::set( v, val );
+        return this->setVal( &v );
+    }
+
+    /**
+     * \brief   Get a value of this element e.g. within a notification.
+     *
+     * \param   v       Value of this element.
+     *
+     * \return  The value.
+     */
+    static T valueOf( const DeviceDataValue& v ) {
+        T val;
+        t_traits::get( v, val );
+        return val;
+    }
+
+    /**
+     * \brief   Compare two values of this element.
+     *
+     * \param   a       First value.
+     * \param   b       Second value.
+     *
+     * \return  true if both values are equal.
+     */
+    static bool equal( const DeviceDataValue& a, const DeviceDataValue& b ) {
+        return t_traits::equal( a, b );
+    }
+
+    /**
+     * \brief   Write a value of this element as text.
+     *
+     * \param   v       Value of this element.
+     * \param   buf     Buffer to write to. No termination is written.
+     * \param   size    Size of the buffer.
+     *
+     * \return  Number of characters written or 0 on error.
+     */
+    static size_t toChars( const DeviceDataValue& v, char* buf, size_t size ) {
+        return t_traits::toChars( v, buf, size );
+    }
+
+    /**
+     * \brief   Parse a value of this element from text.
+     *
+     * \param   v       Value of this element to set.
+     * \param   str     Text to parse.
+     * \param   len     Length of the text.
+     *
+     * \return  0 on success or -1 if the text is invalid.
+     */
+    static int16_t fromChars( DeviceDataValue& v, const char* str, size_t len ) {
+        return t_traits::fromChars( v, str, len );
+    }
+};
+
+#endif /* #ifndef __TYPEDDEVICEDATA_H__ */
@@ -0,0 +1,336 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataBench.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Microbenchmarks of the device data hot paths.
+ *
+ *          Measures the device data values, the accesses of a device data
+ *          element using a backend doing no I/O, the notification of
+ *          1, 10 and 1000 observers and the accesses of a file backed
+ *          element. Using --json the results are printed as JSON to
+ *          compare runs by scripts.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include "DeviceData.h"
+#include "DeviceDataFile.h"
+#include "DeviceDataObserver.h"
+#include "DeviceDataValue.h"
+#include "DeviceDataTest.h"
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** number of iterations of in-memory measurements */
+#define BENCH_ITERATIONS            1000000
+
+/** number of iterations of the observer measurements */
+#define BENCH_ITERATIONS_FANOUT     100000
+
+/** number of iterations of the file measurements */
+#define BENCH_ITERATIONS_FILE       20000
+
+/*
+ * --- Local Class Definition ----------------------------------------------- *
+ */
+
+/**
+ * \brief   Observer counting the notifications.
+ */
+class BenchObserver
+        : public DeviceDataObserver
+{
+
+public:
+
+    BenchObserver( void )
+        : m_count( 0 ) {};
+
+    virtual int8_t notify( const DeviceDataValue*, const DeviceData*, void* ) {
+        m_count++;
+        return 0;
+    }
+
+    /** number of notifications */
+    uint64_t m_count;
+};
+
+/** result of a measurement */
+struct s_result
+{
+    /** name of the measurement */
+    std::string name;
+    /** number of iterations */
+    uint32_t iterations;
+    /** time per iteration in ns */
+    double nsPerOp;
+};
+
+/*
+ * --- Local Variables ------------------------------------------------------ *
+ */
+
+/** sink to keep the compiler from removing the operations */
+static volatile size_t g_sink;
+
+/** results of all measurements */
+static std::vector< s_result > g_results;
+
+/** print the results as JSON */
+static bool g_json = false;
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* bench()
+*/
+template < typename F >
+static void bench( const char* name, uint32_t iterations, F func )
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for( uint32_t i = 0; i < iterations; i++ )
+        g_sink = g_sink + func( i );
+
+    double ns = (double)std::chrono::duration_cast< std::chrono::nanoseconds >(
+            std::chrono::steady_clock::now() - start ).count();
+
+    s_result res = { name, iterations, ns / iterations };
+    g_results.push_back( res );
+
+    if( g_json == false )
+        printf( "%-36s %10.1f ns/op %10.3f Mop/s\n", name, ns / iterations,
+                (iterations * 1000.0) / ns );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* printJson()
+*/
+static void printJson( void )
+{
+#if defined(DEVICEDATA_METRICS)
+    const char* metrics = "true";
+#else
+    const char* metrics = "false";
+#endif /* #if defined(DEVICEDATA_METRICS) */
+
+    printf( "{\n  \"metrics\": %s,\n  \"results\": [\n", metrics );
+    for( size_t i = 0; i < g_results.size(); i++ )
+    {
+        printf( "    { \"name\": \"%s\", \"iterations\": %u, "
+                "\"ns_per_op\": %.2f, \"mops\": %.4f }%s\n",
+                g_results[i].name.c_str(), g_results[i].iterations,
+                g_results[i].nsPerOp, 1000.0 / g_results[i].nsPerOp,
+                (i + 1 < g_results.size()) ? "," : "" );
+    }
+    printf( "  ]\n}\n" );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* benchValue()
+*/
+static void benchValue( void )
+{
+    DeviceDataValue i32( DeviceDataValue::TYPE_INTEGER );
+    DeviceDataValue shortStr( DeviceDataValue::TYPE_STRING );
+    DeviceDataValue longStr( DeviceDataValue::TYPE_STRING );
+    DeviceDataValue dbl( DeviceDataValue::TYPE_DOUBLE );
+    char buf[DEVICEDATAVALUE_NUMSTRMAX];
+
+    i32.setVal( (int32_t)42 );
+    shortStr.setVal( "short" );
+    longStr.setVal( std::string( 256, 'x' ) );
+
+    bench( "value.construct.integer", BENCH_ITERATIONS, [&]( uint32_t i ) {
+        DeviceDataValue v( DeviceDataValue::TYPE_INTEGER );
+        v.setVal( (int32_t)i );
+        return (size_t)v.getNum<int32_t>(); } );
+    bench( "value.copy.integer", BENCH_ITERATIONS, [&]( uint32_t ) {
+        DeviceDataValue v( i32 );
+        return (size_t)v.getLen(); } );
+    bench( "value.copy.string_short", BENCH_ITERATIONS, [&]( uint32_t ) {
+        DeviceDataValue v( shortStr );
+        return (size_t)v.getLen(); } );
+    bench( "value.copy.string_long", BENCH_ITERATIONS, [&]( uint32_t ) {
+        DeviceDataValue v( longStr );
+        return (size_t)v.getLen(); } );
+
+    bench( "value.convert.double_to_chars", BENCH_ITERATIONS, [&]( uint32_t i ) {
+        dbl.setVal( (double)i * 0.37 );
+        return dbl.toChars( buf, sizeof(buf) ); } );
+    bench( "value.convert.string_to_double", BENCH_ITERATIONS, [&]( uint32_t ) {
+        return (size_t)dbl.setVal( "12345.678", 9 ); } );
+
+    DeviceDataValue i32b( i32 );
+    DeviceDataValue longStrB( longStr );
+    bench( "value.compare.integer", BENCH_ITERATIONS, [&]( uint32_t ) {
+        return (size_t)(i32 == i32b); } );
+    bench( "value.compare.string_long", BENCH_ITERATIONS, [&]( uint32_t ) {
+        return (size_t)(longStr == longStrB); } );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* benchAccess()
+*/
+static void benchAccess( void )
+{
+    TestDeviceData data( "bench", DeviceData::ACCESS_READ | DeviceData::ACCESS_WRITE );
+    DeviceDataValue val( DeviceDataValue::TYPE_INTEGER );
+
+    bench( "data.getVal.native", BENCH_ITERATIONS, [&]( uint32_t ) {
+        return (size_t)data.getVal( 0 ); } );
+
+    data.getVal( 0 );
+    bench( "data.getVal.cached", BENCH_ITERATIONS, [&]( uint32_t ) {
+        return (size_t)data.getVal( 60000 ); } );
+
+    bench( "data.setVal", BENCH_ITERATIONS, [&]( uint32_t i ) {
+        val.setVal( (int32_t)i );
+        return (size_t)data.setVal( &val ); } );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* benchFanout()
+*/
+static void benchFanout( size_t num )
+{
+    TestDeviceData data( "fanout", DeviceData::ACCESS_READ |
+            DeviceData::ACCESS_WRITE | DeviceData::ACCESS_OBSERVE );
+    std::vector< BenchObserver > obs( num );
+    DeviceDataValue val( DeviceDataValue::TYPE_INTEGER );
+    char name[64];
+
+    for( size_t i = 0; i < num; i++ )
+        data.observeVal( &obs[i], NULL );
+
+    /* setVal() notifies all the observers using valueChanged() */
+    snprintf( name, sizeof(name), "data.valueChanged.observers_%u", (unsigned)num );
+    bench( name, BENCH_ITERATIONS_FANOUT, [&]( uint32_t i ) {
+        val.setVal( (int32_t)i );
+        return (size_t)data.setVal( &val ); } );
+
+    g_sink = g_sink + (size_t)obs[0].m_count;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* benchFile()
+*/
+static void benchFile( const std::string& dir )
+{
+    DeviceDataValue val( DeviceDataValue::TYPE_INTEGER );
+    int access = DeviceData::ACCESS_READ | DeviceData::ACCESS_WRITE;
+
+    {
+        DeviceDataFile file( dir + "/DeviceDataBench.val", "benchmark",
+                DeviceDataValue::TYPE_INTEGER, access );
+
+        bench( "file.getVal", BENCH_ITERATIONS_FILE, [&]( uint32_t ) {
+            return (size_t)file.getVal( 0 ); } );
+        bench( "file.setVal", BENCH_ITERATIONS_FILE, [&]( uint32_t i ) {
+            val.setVal( (int32_t)i );
+            return (size_t)file.setVal( &val ); } );
+    }
+
+    {
+        DeviceDataFile file( dir + "/DeviceDataBench.val", "benchmark",
+                DeviceDataValue::TYPE_INTEGER, access, true );
+
+        bench( "file.persistent.getVal", BENCH_ITERATIONS_FILE, [&]( uint32_t ) {
+            return (size_t)file.getVal( 0 ); } );
+        bench( "file.persistent.setVal", BENCH_ITERATIONS_FILE, [&]( uint32_t i ) {
+            val.setVal( (int32_t)i );
+            return (size_t)file.setVal( &val ); } );
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* main()
+*/
+int main( int argc, char** argv )
+{
+    std::string dir = "/tmp";
+    const char* p_tmp = getenv( "TMPDIR" );
+
+    if( p_tmp != NULL )
+        dir = p_tmp;
+
+    for( int i = 1; i < argc; i++ )
+    {
+        if( strcmp( argv[i], "--json" ) == 0 )
+            g_json = true;
+        else if( (strcmp( argv[i], "--dir" ) == 0) && (i + 1 < argc) )
+            dir = argv[++i];
+        else
+        {
+            fprintf( stderr, "usage: %s [--json] [--dir <directory>]\n", argv[0] );
+            return 1;
+        }
+    }
+
+    benchValue();
+    benchAccess();
+    benchFanout( 1 );
+    benchFanout( 10 );
+    benchFanout( 1000 );
+    benchFile( dir );
+
+    if( g_json )
+        printJson();
+    return 0;
+}
+
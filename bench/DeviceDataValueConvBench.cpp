@@ -0,0 +1,141 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataValueConvBench.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Microbenchmark of the device data value conversions.
+ *
+ *          Compares the throughput of the conversion engine with the
+ *          printf/scanf based conversions used before.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#include "DeviceDataValue.h"
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** number of conversions per measurement */
+#define BENCH_ITERATIONS            1000000
+
+/*
+ * --- Local Variables ------------------------------------------------------ *
+ */
+
+/** sink to keep the compiler from removing the conversions */
+static volatile size_t g_sink;
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* bench()
+*/
+template < typename F >
+static void bench( const char* name, F func )
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for( uint32_t i = 0; i < BENCH_ITERATIONS; i++ )
+        g_sink = g_sink + func( i );
+
+    double ns = (double)std::chrono::duration_cast< std::chrono::nanoseconds >(
+            std::chrono::steady_clock::now() - start ).count();
+
+    printf( "%-28s %8.1f ns/op %8.2f Mop/s\n", name, ns / BENCH_ITERATIONS,
+            (BENCH_ITERATIONS * 1000.0) / ns );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* main()
+*/
+int main( void )
+{
+    char buf[DEVICEDATAVALUE_NUMSTRMAX];
+
+    printf( "format:\n" );
+    bench( "  int32 snprintf(%d)", [&]( uint32_t i ) {
+        return (size_t)snprintf( buf, sizeof(buf), "%d", (int32_t)(i * 7919) ); } );
+    bench( "  int32 toChars", [&]( uint32_t i ) {
+        return DeviceDataValueConv::toChars( buf, sizeof(buf), (int32_t)(i * 7919) ); } );
+    bench( "  int64 snprintf(%lld)", [&]( uint32_t i ) {
+        return (size_t)snprintf( buf, sizeof(buf), "%lld", (long long)i * 1000003LL ); } );
+    bench( "  int64 toChars", [&]( uint32_t i ) {
+        return DeviceDataValueConv::toChars( buf, sizeof(buf), (int64_t)((int64_t)i * 1000003) ); } );
+    bench( "  float snprintf(%f)", [&]( uint32_t i ) {
+        return (size_t)snprintf( buf, sizeof(buf), "%f", (float)i * 0.37f ); } );
+    bench( "  float toChars", [&]( uint32_t i ) {
+        return DeviceDataValueConv::toChars( buf, sizeof(buf), (float)i * 0.37f ); } );
+    bench( "  double snprintf(%.17g)", [&]( uint32_t i ) {
+        return (size_t)snprintf( buf, sizeof(buf), "%.17g", (double)i * 0.37 ); } );
+    bench( "  double toChars", [&]( uint32_t i ) {
+        return DeviceDataValueConv::toChars( buf, sizeof(buf), (double)i * 0.37 ); } );
+
+    printf( "parse:\n" );
+    const char* intStr = "-1234567";
+    const char* fltStr = "12345.678";
+    bench( "  int32 sscanf(%d)", [&]( uint32_t ) {
+        int32_t v = 0; sscanf( intStr, "%d", &v ); return (size_t)v; } );
+    bench( "  int64 fromChars", [&]( uint32_t ) {
+        int64_t v = 0; DeviceDataValueConv::fromChars( intStr, intStr + 8, v );
+        return (size_t)v; } );
+    bench( "  float sscanf(%f)", [&]( uint32_t ) {
+        float v = 0; sscanf( fltStr, "%f", &v ); return (size_t)v; } );
+    bench( "  double fromChars", [&]( uint32_t ) {
+        double v = 0; DeviceDataValueConv::fromChars( fltStr, fltStr + 9, v );
+        return (size_t)v; } );
+
+    printf( "DeviceDataValue:\n" );
+    DeviceDataValue str( DeviceDataValue::TYPE_STRING );
+    DeviceDataValue dbl( DeviceDataValue::TYPE_DOUBLE );
+    bench( "  setVal(double) as string", [&]( uint32_t i ) {
+        return (size_t)str.setVal( (double)i * 0.37 ); } );
+    bench( "  setVal(string) as double", [&]( uint32_t ) {
+        return (size_t)dbl.setVal( fltStr, 9 ); } );
+
+    return 0;
+}
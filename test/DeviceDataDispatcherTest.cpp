@@ -0,0 +1,295 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataDispatcherTest.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Test of the ring buffer of the notification dispatcher.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "DeviceData.h"
+#include "DeviceDataDispatcher.h"
+#include "DeviceDataObserver.h"
+#include "DeviceDataTest.h"
+
+/*
+ * --- Local Class Definition ----------------------------------------------- *
+ */
+
+/**
+ * \brief   Observer recording the notified values.
+ *
+ *          While blocked the observer waits within the notification.
+ */
+class TestObserver
+        : public DeviceDataObserver
+{
+
+public:
+
+    TestObserver( void )
+        : m_blocked( false )
+        , m_waiting( false ) {};
+
+    virtual int8_t notify( const DeviceDataValue* val, const DeviceData*, void* ) {
+        std::unique_lock< std::mutex > lock( m_mutex );
+
+        m_vals.push_back( val->getVal().i32 );
+        m_waiting = m_blocked;
+        m_cond.notify_all();
+        while( m_blocked )
+            m_cond.wait( lock );
+        m_waiting = false;
+        return 0;
+    }
+
+    /** block the following notifications */
+    void block( void ) {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        m_blocked = true;
+    }
+
+    /** wait until a notification is blocked */
+    void waitBlocked( void ) {
+        std::unique_lock< std::mutex > lock( m_mutex );
+        while( m_waiting == false )
+            m_cond.wait( lock );
+    }
+
+    /** continue the blocked notification */
+    void release( void ) {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        m_blocked = false;
+        m_cond.notify_all();
+    }
+
+    /** get the notified values */
+    std::vector< int32_t > getVals( void ) {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        return m_vals;
+    }
+
+private:
+
+    std::mutex m_mutex;
+    std::condition_variable m_cond;
+    std::vector< int32_t > m_vals;
+    bool m_blocked;
+    bool m_waiting;
+};
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* setInt()
+*/
+static int16_t setInt( DeviceData& data, int32_t v )
+{
+    DeviceDataValue val( DeviceDataValue::TYPE_INTEGER );
+
+    val.setVal( v );
+    return data.setVal( &val );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testOrder()
+*/
+static void testOrder( void )
+{
+    DeviceDataDispatcher disp( 16 );
+    TestDeviceData data;
+    TestObserver obs;
+    DeviceDataDispatcher::s_stats stats;
+
+    data.setDispatcher( &disp );
+    TEST_CHECK( data.observeVal( &obs, NULL ) == 0 );
+
+    /* a single dispatcher thread keeps the order of the element */
+    for( int32_t i = 0; i < 1000; i++ )
+    {
+        while( true )
+        {
+            disp.getStats( stats );
+            if( stats.depth < 16 )
+                break;
+            std::this_thread::yield();
+        }
+        TEST_CHECK( setInt( data, i ) == 0 );
+    }
+    data.shutdown();
+
+    std::vector< int32_t > vals = obs.getVals();
+    TEST_CHECK( vals.size() == 1000 );
+    for( size_t i = 0; i < vals.size(); i++ )
+        TEST_CHECK( vals[i] == (int32_t)i );
+
+    disp.getStats( stats );
+    TEST_CHECK( stats.depth == 0 );
+    TEST_CHECK( stats.enqueued == 1000 );
+    TEST_CHECK( stats.delivered == 1000 );
+    TEST_CHECK( stats.dropped == 0 );
+    TEST_CHECK( stats.maxDepth <= 16 );
+    TEST_CHECK( stats.latencyMax * 1000 >= stats.latencySum );
+
+    disp.resetStats();
+    disp.getStats( stats );
+    TEST_CHECK( stats.enqueued == 0 );
+    TEST_CHECK( stats.delivered == 0 );
+    TEST_CHECK( stats.maxDepth == 0 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testFull()
+*/
+static void testFull( void )
+{
+    /* the size is rounded up to four slots */
+    DeviceDataDispatcher disp( 3 );
+    TestDeviceData data;
+    TestObserver obs;
+    DeviceDataDispatcher::s_stats stats;
+
+    data.setDispatcher( &disp );
+    TEST_CHECK( data.observeVal( &obs, NULL ) == 0 );
+
+    /* the dispatcher thread is blocked within the first notification */
+    obs.block();
+    TEST_CHECK( setInt( data, 0 ) == 0 );
+    obs.waitBlocked();
+
+    /* fill the queue, the notification of the last value is dropped */
+    for( int32_t i = 1; i <= 5; i++ )
+        TEST_CHECK( setInt( data, i ) == 0 );
+
+    disp.getStats( stats );
+    TEST_CHECK( stats.depth == 4 );
+    TEST_CHECK( stats.maxDepth == 4 );
+    TEST_CHECK( stats.enqueued == 5 );
+    TEST_CHECK( stats.dropped == 1 );
+
+    obs.release();
+    data.shutdown();
+
+    std::vector< int32_t > vals = obs.getVals();
+    TEST_CHECK( vals.size() == 5 );
+    for( size_t i = 0; i < vals.size(); i++ )
+        TEST_CHECK( vals[i] == (int32_t)i );
+
+    disp.getStats( stats );
+    TEST_CHECK( stats.delivered == 5 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testProducers()
+*/
+static void testProducers( void )
+{
+    std::vector< TestDeviceData* > data;
+    std::vector< TestObserver* > obs;
+    std::vector< std::thread > threads;
+    DeviceDataDispatcher::s_stats stats;
+
+    {
+        DeviceDataDispatcher disp( 64, 4 );
+
+        /* several producers and consumers, every notification is either
+         * delivered or counted as dropped */
+        for( int i = 0; i < 4; i++ )
+        {
+            data.push_back( new TestDeviceData() );
+            obs.push_back( new TestObserver() );
+            data[i]->setDispatcher( &disp );
+            TEST_CHECK( data[i]->observeVal( obs[i], NULL ) == 0 );
+        }
+
+        for( int i = 0; i < 4; i++ )
+        {
+            threads.push_back( std::thread( [&data, i]( void ) {
+                for( int32_t v = 0; v < 10000; v++ )
+                    setInt( *data[i], v );
+            } ) );
+        }
+        for( size_t i = 0; i < threads.size(); i++ )
+            threads[i].join();
+
+        for( size_t i = 0; i < data.size(); i++ )
+            data[i]->shutdown();
+
+        disp.getStats( stats );
+    }
+
+    size_t notified = 0;
+    for( size_t i = 0; i < obs.size(); i++ )
+    {
+        notified += obs[i]->getVals().size();
+        delete data[i];
+        delete obs[i];
+    }
+
+    TEST_CHECK( stats.depth == 0 );
+    TEST_CHECK( stats.enqueued + stats.dropped == 40000 );
+    TEST_CHECK( stats.delivered == stats.enqueued );
+    TEST_CHECK( notified == stats.delivered );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* main()
+*/
+int main( void )
+{
+    TEST_RUN( testOrder );
+    TEST_RUN( testFull );
+    TEST_RUN( testProducers );
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,208 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataHistoryTest.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Test of the ranges of the device data history.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include "DeviceDataHistory.h"
+#include "DeviceDataTest.h"
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* fill()
+*/
+static void fill( DeviceDataHistory& hist, int32_t num )
+{
+    DeviceDataValue val( DeviceDataValue::TYPE_INTEGER );
+
+    /* sample i has the value i and the timestamp 100 * i */
+    for( int32_t i = 0; i < num; i++ )
+    {
+        val.setVal( i );
+        hist.add( val, (uint64_t)i * 100 );
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* checkSamples()
+*/
+static bool checkSamples( const std::vector< DeviceDataHistory::s_sample >& samples,
+        int32_t first, int32_t num )
+{
+    if( samples.size() != (size_t)num )
+        return false;
+
+    for( int32_t i = 0; i < num; i++ )
+    {
+        if( (samples[i].val.getVal().i32 != first + i) ||
+            (samples[i].time != (uint64_t)(first + i) * 100) )
+            return false;
+    }
+    return true;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testRange()
+*/
+static void testRange( void )
+{
+    DeviceDataHistory hist( 8, DeviceDataValue::TYPE_INTEGER );
+    std::vector< DeviceDataHistory::s_sample > samples;
+
+    TEST_CHECK( hist.getCapacity() == 8 );
+    TEST_CHECK( hist.getRange( 0, UINT64_MAX, samples ) == 0 );
+
+    /* the ring buffer wrapped, samples 12 to 19 are left */
+    fill( hist, 20 );
+    TEST_CHECK( hist.getSize() == 8 );
+
+    TEST_CHECK( hist.getRange( 0, UINT64_MAX, samples ) == 8 );
+    TEST_CHECK( checkSamples( samples, 12, 8 ) );
+
+    /* both ends of the range are included */
+    TEST_CHECK( hist.getRange( 1300, 1600, samples ) == 4 );
+    TEST_CHECK( checkSamples( samples, 13, 4 ) );
+    TEST_CHECK( hist.getRange( 1301, 1599, samples ) == 2 );
+    TEST_CHECK( checkSamples( samples, 14, 2 ) );
+    TEST_CHECK( hist.getRange( 1500, 1500, samples ) == 1 );
+    TEST_CHECK( checkSamples( samples, 15, 1 ) );
+
+    /* the oldest samples of a limited range */
+    TEST_CHECK( hist.getRange( 0, UINT64_MAX, samples, 3 ) == 3 );
+    TEST_CHECK( checkSamples( samples, 12, 3 ) );
+
+    /* ranges outside of the history */
+    TEST_CHECK( hist.getRange( 0, 1199, samples ) == 0 );
+    TEST_CHECK( hist.getRange( 1901, 5000, samples ) == 0 );
+    TEST_CHECK( hist.getRange( 1600, 1300, samples ) == 0 );
+    TEST_CHECK( samples.empty() );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testLatestCopy()
+*/
+static void testLatestCopy( void )
+{
+    DeviceDataHistory hist( 8, DeviceDataValue::TYPE_INTEGER );
+    std::vector< DeviceDataHistory::s_sample > samples;
+
+    fill( hist, 11 );
+
+    TEST_CHECK( hist.getLatest( 3, samples ) == 3 );
+    TEST_CHECK( checkSamples( samples, 8, 3 ) );
+    TEST_CHECK( hist.getLatest( 100, samples ) == 8 );
+    TEST_CHECK( checkSamples( samples, 3, 8 ) );
+
+    /* the copy starts with the oldest sample */
+    std::vector< DeviceDataHistory::s_sample > buf( 10,
+        DeviceDataHistory::s_sample{ 0, DeviceDataValue( DeviceDataValue::TYPE_INTEGER ) } );
+    TEST_CHECK( hist.copy( &buf[0], buf.size() ) == 8 );
+    buf.erase( buf.begin() + 8, buf.end() );
+    TEST_CHECK( checkSamples( buf, 3, 8 ) );
+
+    buf.erase( buf.begin() + 5, buf.end() );
+    TEST_CHECK( hist.copy( &buf[0], buf.size() ) == 5 );
+    TEST_CHECK( checkSamples( buf, 3, 5 ) );
+
+    hist.clear();
+    TEST_CHECK( hist.getSize() == 0 );
+    TEST_CHECK( hist.getLatest( 3, samples ) == 0 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testOrder()
+*/
+static void testOrder( void )
+{
+    DeviceDataHistory hist( 4, DeviceDataValue::TYPE_STRING );
+    std::vector< DeviceDataHistory::s_sample > samples;
+    DeviceDataValue val( DeviceDataValue::TYPE_STRING );
+
+    /* an older timestamp is replaced by the latest one */
+    val.setVal( "first" );
+    hist.add( val, 1000 );
+    val.setVal( std::string( 40, 'x' ) );
+    hist.add( val, 500 );
+
+    TEST_CHECK( hist.getRange( 1000, 1000, samples ) == 2 );
+    TEST_CHECK( strcmp( samples[0].val.getStr(), "first" ) == 0 );
+    TEST_CHECK( samples[1].val.getLen() == 40 );
+    TEST_CHECK( samples[1].time == 1000 );
+
+    /* samples taken now are not older than the ones before */
+    uint64_t before = DeviceDataHistory::now();
+    hist.add( val );
+    TEST_CHECK( hist.getLatest( 1, samples ) == 1 );
+    TEST_CHECK( samples[0].time >= before );
+
+    /* a history keeps at least one sample */
+    DeviceDataHistory one( 0, DeviceDataValue::TYPE_INTEGER );
+    TEST_CHECK( one.getCapacity() == 1 );
+    fill( one, 3 );
+    TEST_CHECK( one.getRange( 0, UINT64_MAX, samples ) == 1 );
+    TEST_CHECK( checkSamples( samples, 2, 1 ) );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* main()
+*/
+int main( void )
+{
+    TEST_RUN( testRange );
+    TEST_RUN( testLatestCopy );
+    TEST_RUN( testOrder );
+
+    return TEST_RESULT();
+}
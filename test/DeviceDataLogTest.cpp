@@ -0,0 +1,328 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataLogTest.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Test of the ranges of the append-only log.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <string.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <string>
+#include <vector>
+#include "DeviceDataLog.h"
+#include "DeviceDataTest.h"
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** size of the segments, small to get several of them */
+#define TEST_SEG_SIZE               1024
+
+/** size of the write buffer */
+#define TEST_BUF_SIZE               256
+
+/** distance of the index entries */
+#define TEST_INTERVAL               128
+
+/** number of records of the test */
+#define TEST_RECORDS                200
+
+/*
+ * --- Local Variables ------------------------------------------------------ *
+ */
+
+/** directory of the segments */
+static std::string g_dir;
+
+/** name prefix of the segments */
+static std::string g_prefix;
+
+/*
+ * --- Local Type Definitions ----------------------------------------------- *
+ */
+
+/** a record found by a scan */
+struct s_found
+{
+    uint64_t time;
+    uint32_t handle;
+    int32_t val;
+};
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* scan()
+*/
+static std::vector< s_found > scan( DeviceDataLog& log, uint64_t from, uint64_t to,
+        uint32_t handle = UINT32_MAX )
+{
+    std::vector< s_found > found;
+
+    size_t num = log.scan( from, to, [&found]( uint64_t time, uint32_t h,
+            const DeviceDataValue& val ) {
+        s_found f = { time, h, val.getVal().i32 };
+        found.push_back( f );
+    }, handle );
+
+    TEST_CHECK( num == found.size() );
+    return found;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* checkRecords()
+*/
+static bool checkRecords( const std::vector< s_found >& found, int32_t first,
+        int32_t step )
+{
+    /* record i has the timestamp 1000 * (i + 1), the value i and the
+     * handle i % 2 */
+    for( size_t i = 0; i < found.size(); i++ )
+    {
+        int32_t v = first + (int32_t)i * step;
+        if( (found[i].val != v) || (found[i].handle != (uint32_t)(v % 2)) ||
+            (found[i].time != (uint64_t)(v + 1) * 1000) )
+            return false;
+    }
+    return true;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* segPath()
+*/
+static std::string segPath( uint32_t num )
+{
+    char buf[32];
+
+    snprintf( buf, sizeof(buf), ".%08u.log", num );
+    return g_prefix + buf;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testRange()
+*/
+static void testRange( void )
+{
+    DeviceDataLog log( g_prefix, TEST_SEG_SIZE, TEST_BUF_SIZE, TEST_INTERVAL );
+    DeviceDataValue val( DeviceDataValue::TYPE_INTEGER );
+
+    for( int32_t i = 0; i < TEST_RECORDS; i++ )
+    {
+        val.setVal( i );
+        TEST_CHECK( log.append( (uint32_t)(i % 2), val, (uint64_t)(i + 1) * 1000 ) == 0 );
+    }
+    TEST_CHECK( log.getNumSegments() > 1 );
+
+    /* buffered records are found as well */
+    std::vector< s_found > found = scan( log, 0, UINT64_MAX );
+    TEST_CHECK( found.size() == TEST_RECORDS );
+    TEST_CHECK( checkRecords( found, 0, 1 ) );
+
+    /* both ends of the range are included */
+    found = scan( log, 50000, 59000 );
+    TEST_CHECK( found.size() == 10 );
+    TEST_CHECK( checkRecords( found, 49, 1 ) );
+
+    found = scan( log, 50001, 50999 );
+    TEST_CHECK( found.empty() );
+
+    /* records of a single element */
+    found = scan( log, 0, UINT64_MAX, 1 );
+    TEST_CHECK( found.size() == TEST_RECORDS / 2 );
+    TEST_CHECK( checkRecords( found, 1, 2 ) );
+
+    found = scan( log, 0, 999 );
+    TEST_CHECK( found.empty() );
+    found = scan( log, (TEST_RECORDS + 1) * 1000, UINT64_MAX );
+    TEST_CHECK( found.empty() );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testReopen()
+*/
+static void testReopen( void )
+{
+    size_t numSegments;
+
+    {
+        /* the records of the last run are kept */
+        DeviceDataLog log( g_prefix, TEST_SEG_SIZE, TEST_BUF_SIZE, TEST_INTERVAL );
+        numSegments = log.getNumSegments();
+
+        std::vector< s_found > found = scan( log, 0, UINT64_MAX );
+        TEST_CHECK( found.size() == TEST_RECORDS );
+        TEST_CHECK( checkRecords( found, 0, 1 ) );
+
+        /* an older timestamp is replaced by the latest one */
+        DeviceDataValue val( DeviceDataValue::TYPE_INTEGER );
+        val.setVal( (int32_t)-1 );
+        TEST_CHECK( log.append( 7, val, 5 ) == 0 );
+
+        found = scan( log, TEST_RECORDS * 1000, UINT64_MAX );
+        TEST_CHECK( found.size() == 2 );
+        TEST_CHECK( (found[1].handle == 7) && (found[1].val == -1) );
+        TEST_CHECK( found[1].time == TEST_RECORDS * 1000 );
+    }
+
+    /* a record written partially is cut off */
+    std::string last = segPath( (uint32_t)numSegments - 1 );
+    FILE* p_file = fopen( last.c_str(), "r+b" );
+    TEST_CHECK( p_file != NULL );
+    if( p_file != NULL )
+    {
+        fseek( p_file, 0, SEEK_END );
+        long size = ftell( p_file );
+        fclose( p_file );
+        TEST_CHECK( truncate( last.c_str(), size - 5 ) == 0 );
+    }
+
+    DeviceDataLog log( g_prefix, TEST_SEG_SIZE, TEST_BUF_SIZE, TEST_INTERVAL );
+    TEST_CHECK( log.getNumSegments() == numSegments );
+
+    std::vector< s_found > found = scan( log, 0, UINT64_MAX );
+    TEST_CHECK( found.size() == TEST_RECORDS );
+    TEST_CHECK( checkRecords( found, 0, 1 ) );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testBroken()
+*/
+static void testBroken( void )
+{
+    size_t numSegments;
+
+    {
+        DeviceDataLog log( g_prefix, TEST_SEG_SIZE, TEST_BUF_SIZE, TEST_INTERVAL );
+        numSegments = log.getNumSegments();
+    }
+
+    /* a last segment with a broken header is not continued */
+    FILE* p_file = fopen( segPath( (uint32_t)numSegments - 1 ).c_str(), "r+b" );
+    TEST_CHECK( p_file != NULL );
+    if( p_file != NULL )
+    {
+        fwrite( "broken", 1, 6, p_file );
+        fclose( p_file );
+    }
+
+    DeviceDataLog log( g_prefix, TEST_SEG_SIZE, TEST_BUF_SIZE, TEST_INTERVAL );
+    TEST_CHECK( log.getNumSegments() == numSegments + 1 );
+
+    DeviceDataValue val( DeviceDataValue::TYPE_INTEGER );
+    val.setVal( (int32_t)TEST_RECORDS );
+    TEST_CHECK( log.append( TEST_RECORDS % 2, val, (TEST_RECORDS + 1) * 1000 ) == 0 );
+
+    std::vector< s_found > found = scan( log, 0, UINT64_MAX );
+    TEST_CHECK( found.empty() == false );
+    TEST_CHECK( checkRecords( std::vector< s_found >( 1, found.back() ),
+        TEST_RECORDS, 1 ) );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testAppendInScan()
+*/
+static void testAppendInScan( void )
+{
+    DeviceDataLog log( g_prefix, TEST_SEG_SIZE, TEST_BUF_SIZE, TEST_INTERVAL );
+    size_t before = scan( log, 0, UINT64_MAX ).size();
+
+    /* the handler may append while the log is scanned */
+    size_t found = log.scan( 0, UINT64_MAX,
+        [&]( uint64_t time, uint32_t handle, const DeviceDataValue& rec ) {
+            TEST_CHECK( log.append( handle, rec, time ) == 0 );
+        } );
+    TEST_CHECK( found == before );
+    TEST_CHECK( scan( log, 0, UINT64_MAX ).size() == 2 * before );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* removeDir()
+*/
+static void removeDir( const std::string& dir )
+{
+    DIR* p_dir = opendir( dir.c_str() );
+    struct dirent* p_ent;
+
+    if( p_dir == NULL )
+        return;
+
+    while( (p_ent = readdir( p_dir )) != NULL )
+    {
+        if( p_ent->d_name[0] != '.' )
+            unlink( (dir + "/" + p_ent->d_name).c_str() );
+    }
+    closedir( p_dir );
+    rmdir( dir.c_str() );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* main()
+*/
+int main( void )
+{
+    g_dir = testDir();
+    if( g_dir.empty() )
+        return EXIT_FAILURE;
+    g_prefix = g_dir + "/log";
+
+    TEST_RUN( testRange );
+    TEST_RUN( testReopen );
+    TEST_RUN( testBroken );
+    TEST_RUN( testAppendInScan );
+
+    removeDir( g_dir );
+
+    return TEST_RESULT();
+}
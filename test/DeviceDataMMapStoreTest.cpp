@@ -0,0 +1,398 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataMMapStoreTest.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Test of the memory mapped store and its sequence lock.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "DeviceDataMMap.h"
+#include "DeviceDataMMapStore.h"
+#include "DeviceDataObserver.h"
+#include "DeviceDataTest.h"
+
+/*
+ * --- Local Variables ------------------------------------------------------ *
+ */
+
+/** path of the store */
+static std::string g_path;
+
+/*
+ * --- Local Class Definition ----------------------------------------------- *
+ */
+
+/**
+ * \brief   Observer keeping the last notified value.
+ */
+class TestObserver
+        : public DeviceDataObserver
+{
+
+public:
+
+    TestObserver( void )
+        : m_count( 0 )
+        , m_last( 0 )
+        , m_val( DeviceDataValue::TYPE_INTEGER ) {};
+
+    virtual int8_t notify( const DeviceDataValue* val, const DeviceData*, void* ) {
+        {
+            std::lock_guard< std::mutex > lock( m_mutex );
+            m_val = *val;
+        }
+        m_last = val->getVal().i32;
+        m_count++;
+        return 0;
+    }
+
+    /** get a copy of the last notified value */
+    DeviceDataValue getLast( void ) {
+        std::lock_guard< std::mutex > lock( m_mutex );
+        return m_val;
+    }
+
+    /** number of notifications */
+    std::atomic<uint32_t> m_count;
+    /** last notified value as integer */
+    std::atomic<int32_t> m_last;
+
+private:
+
+    /** protects the last notified value */
+    std::mutex m_mutex;
+    /** last notified value */
+    DeviceDataValue m_val;
+};
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* testAlloc()
+*/
+static void testAlloc( void )
+{
+    DeviceDataMMapStore store( g_path, 3 );
+
+    TEST_CHECK( store.isOpen() );
+    TEST_CHECK( store.getNumRecords() == 3 );
+    TEST_CHECK( store.getPayloadSize() == DEVICEDATAMMAPSTORE_RECORD_SIZE -
+        sizeof(DeviceDataMMapStore::s_record) );
+
+    DeviceDataMMapStore::t_handle a = store.alloc( "a", DeviceDataValue::TYPE_INTEGER );
+    DeviceDataMMapStore::t_handle b = store.alloc( "b", DeviceDataValue::TYPE_STRING );
+    TEST_CHECK( a != DeviceDataMMapStore::HANDLE_INVALID );
+    TEST_CHECK( b != DeviceDataMMapStore::HANDLE_INVALID );
+    TEST_CHECK( a != b );
+
+    /* the record of a name is used again if the type matches */
+    TEST_CHECK( store.alloc( "a", DeviceDataValue::TYPE_INTEGER ) == a );
+    TEST_CHECK( store.alloc( "a", DeviceDataValue::TYPE_FLOAT ) ==
+        DeviceDataMMapStore::HANDLE_INVALID );
+    TEST_CHECK( store.find( "b" ) == b );
+    TEST_CHECK( store.find( "x" ) == DeviceDataMMapStore::HANDLE_INVALID );
+    TEST_CHECK( store.alloc( std::string( DEVICEDATAMMAPSTORE_NAME_MAX, 'n' ),
+        DeviceDataValue::TYPE_INTEGER ) == DeviceDataMMapStore::HANDLE_INVALID );
+
+    /* all records in use */
+    DeviceDataMMapStore::t_handle c = store.alloc( "c", DeviceDataValue::TYPE_DOUBLE );
+    TEST_CHECK( c != DeviceDataMMapStore::HANDLE_INVALID );
+    TEST_CHECK( store.alloc( "d", DeviceDataValue::TYPE_INTEGER ) ==
+        DeviceDataMMapStore::HANDLE_INVALID );
+
+    store.free( c );
+    TEST_CHECK( store.find( "c" ) == DeviceDataMMapStore::HANDLE_INVALID );
+    TEST_CHECK( store.alloc( "d", DeviceDataValue::TYPE_INTEGER ) == c );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testReadWrite()
+*/
+static void testReadWrite( void )
+{
+    DeviceDataValue num( DeviceDataValue::TYPE_INTEGER );
+    DeviceDataValue str( DeviceDataValue::TYPE_STRING );
+    uint32_t seqWrite = 0;
+    uint32_t seqRead = 1;
+
+    {
+        DeviceDataMMapStore store( g_path, 4 );
+        DeviceDataMMapStore::t_handle a = store.find( "a" );
+        DeviceDataMMapStore::t_handle b = store.find( "b" );
+
+        /* every write makes the sequence advance by two */
+        TEST_CHECK( store.getSeq( a ) == 0 );
+        num.setVal( (int32_t)-5 );
+        TEST_CHECK( store.write( a, &num, &seqWrite ) == 0 );
+        TEST_CHECK( seqWrite == 2 );
+        TEST_CHECK( store.getSeq( a ) == 2 );
+
+        num.setVal( (int32_t)0 );
+        TEST_CHECK( store.read( a, &num, &seqRead ) == 0 );
+        TEST_CHECK( num.getVal().i32 == -5 );
+        TEST_CHECK( seqRead == seqWrite );
+
+        str.setVal( "hello" );
+        TEST_CHECK( store.write( b, &str ) == 0 );
+        str.setVal( std::string( store.getPayloadSize() + 1, 'x' ) );
+        TEST_CHECK( store.write( b, &str ) == -2 );
+        TEST_CHECK( store.getSeq( b ) == 2 );
+
+        TEST_CHECK( store.write( store.getNumRecords(), &num ) == -1 );
+        TEST_CHECK( store.read( DeviceDataMMapStore::HANDLE_INVALID, &num ) == -1 );
+
+        /* values are converted to the type of the record */
+        str.setVal( "7" );
+        TEST_CHECK( store.write( a, &str ) == 0 );
+        TEST_CHECK( store.read( a, &num ) == 0 );
+        TEST_CHECK( num.getVal().i32 == 7 );
+        str.setVal( "x" );
+        TEST_CHECK( store.write( a, &str ) == -3 );
+        num.setVal( (int32_t)-5 );
+        TEST_CHECK( store.write( a, &num, &seqWrite ) == 0 );
+        TEST_CHECK( store.getSeq( a ) == 6 );
+    }
+
+    /* the layout and the values are kept when the store is opened again */
+    DeviceDataMMapStore store( g_path, 100, 256 );
+    TEST_CHECK( store.getNumRecords() == 3 );
+
+    DeviceDataMMapStore::t_handle a = store.alloc( "a", DeviceDataValue::TYPE_INTEGER );
+    TEST_CHECK( store.getSeq( a ) == 6 );
+    TEST_CHECK( store.read( a, &num ) == 0 );
+    TEST_CHECK( num.getVal().i32 == -5 );
+    TEST_CHECK( store.read( store.find( "b" ), &str ) == 0 );
+    TEST_CHECK( strcmp( str.getStr(), "hello" ) == 0 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testConcurrent()
+*/
+static void testConcurrent( void )
+{
+    DeviceDataMMapStore store( g_path, 4 );
+    DeviceDataMMapStore::t_handle b = store.find( "b" );
+    std::atomic<bool> stop( false );
+    std::atomic<uint32_t> bad( 0 );
+    std::vector< std::thread > threads;
+    DeviceDataValue init( DeviceDataValue::TYPE_STRING );
+
+    /* readers never see a partially written value. A value of length
+     * n consists of the character 'a' + n. */
+    init.setVal( "b" );
+    TEST_CHECK( store.write( b, &init ) == 0 );
+
+    for( int i = 0; i < 2; i++ )
+    {
+        threads.push_back( std::thread( [&]( void ) {
+            DeviceDataValue val( DeviceDataValue::TYPE_STRING );
+            uint32_t last = 0;
+            uint32_t seq;
+
+            while( stop == false )
+            {
+                if( store.read( b, &val, &seq ) != 0 )
+                    bad++;
+                if( (seq & 1) || (seq < last) )
+                    bad++;
+                last = seq;
+
+                const char* p = val.getStr();
+                for( uint32_t j = 0; j < val.getLen(); j++ )
+                {
+                    if( p[j] != (char)('a' + val.getLen()) )
+                        bad++;
+                }
+            }
+        } ) );
+    }
+
+    std::vector< std::thread > writers;
+    for( int i = 0; i < 2; i++ )
+    {
+        writers.push_back( std::thread( [&, i]( void ) {
+            DeviceDataValue val( DeviceDataValue::TYPE_STRING );
+
+            for( uint32_t n = 0; n < 20000; n++ )
+            {
+                uint32_t len = 1 + ((n * 7 + i) % 25);
+                val.setVal( std::string( len, (char)('a' + len) ) );
+                if( store.write( b, &val ) != 0 )
+                    bad++;
+            }
+        } ) );
+    }
+
+    for( size_t i = 0; i < writers.size(); i++ )
+        writers[i].join();
+    stop = true;
+    for( size_t i = 0; i < threads.size(); i++ )
+        threads[i].join();
+
+    TEST_CHECK( bad == 0 );
+
+    /* each write advanced the sequence, none was lost */
+    TEST_CHECK( store.getSeq( b ) == 4 + (2 * 2 * 20000) );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testObserve()
+*/
+static void testObserve( void )
+{
+    DeviceDataMMapStore store( g_path, 4 );
+    DeviceDataMMapStore other( g_path, 4 );
+    TestObserver obs;
+    DeviceDataValue val( DeviceDataValue::TYPE_INTEGER );
+
+    DeviceDataMMap data( "a", "test", DeviceDataValue::TYPE_INTEGER,
+        DeviceData::ACCESS_READ | DeviceData::ACCESS_WRITE |
+        DeviceData::ACCESS_OBSERVE, &store );
+    TEST_CHECK( data.getHandle() == store.find( "a" ) );
+    TEST_CHECK( data.observeVal( &obs, NULL ) == 0 );
+
+    /* a write through the element is reported once */
+    val.setVal( (int32_t)10 );
+    TEST_CHECK( data.setVal( &val ) == 0 );
+    std::this_thread::sleep_for( std::chrono::milliseconds(
+        3 * DEVICEDATAMMAP_OBSERVE_MS ) );
+    TEST_CHECK( obs.m_count == 1 );
+    TEST_CHECK( obs.m_last == 10 );
+
+    /* writes of other processes are found by checking the record */
+    val.setVal( (int32_t)11 );
+    TEST_CHECK( other.write( other.find( "a" ), &val ) == 0 );
+
+    for( int i = 0; (i < 100) && (obs.m_count < 2); i++ )
+        std::this_thread::sleep_for( std::chrono::milliseconds(
+            DEVICEDATAMMAP_OBSERVE_MS / 10 ) );
+    TEST_CHECK( obs.m_count == 2 );
+    TEST_CHECK( obs.m_last == 11 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testObserveTypes()
+*/
+static void testObserveTypes( void )
+{
+    std::string path = g_path + ".types";
+    DeviceDataMMapStore store( path, 4 );
+    TestObserver obsFlt;
+    TestObserver obsStr;
+    DeviceDataValue val( DeviceDataValue::TYPE_INTEGER );
+    DeviceDataValue str( DeviceDataValue::TYPE_STRING );
+
+    DeviceDataMMap flt( "f", "test", DeviceDataValue::TYPE_FLOAT,
+        DeviceData::ACCESS_READ | DeviceData::ACCESS_WRITE |
+        DeviceData::ACCESS_OBSERVE, &store );
+    DeviceDataMMap text( "s", "test", DeviceDataValue::TYPE_STRING,
+        DeviceData::ACCESS_READ | DeviceData::ACCESS_WRITE |
+        DeviceData::ACCESS_OBSERVE, &store );
+    TEST_CHECK( flt.observeVal( &obsFlt, NULL ) == 0 );
+    TEST_CHECK( text.observeVal( &obsStr, NULL ) == 0 );
+
+    /* the other process opens the store with the records allocated */
+    DeviceDataMMapStore other( path, 4 );
+
+    /* writes of other types are stored and reported in the type of
+     * the element */
+    val.setVal( (int32_t)3 );
+    TEST_CHECK( other.write( other.find( "f" ), &val ) == 0 );
+    str.setVal( "abc" );
+    TEST_CHECK( other.write( other.find( "s" ), &str ) == 0 );
+
+    for( int i = 0; (i < 100) && ((obsFlt.m_count < 1) || (obsStr.m_count < 1)); i++ )
+        std::this_thread::sleep_for( std::chrono::milliseconds(
+            DEVICEDATAMMAP_OBSERVE_MS / 10 ) );
+    TEST_CHECK( obsFlt.m_count == 1 );
+    TEST_CHECK( obsStr.m_count == 1 );
+
+    DeviceDataValue last = obsFlt.getLast();
+    TEST_CHECK( last.getType() == DeviceDataValue::TYPE_FLOAT );
+    TEST_CHECK( last.getVal().f == 3.0f );
+    last = obsStr.getLast();
+    TEST_CHECK( last.getType() == DeviceDataValue::TYPE_STRING );
+    TEST_CHECK( strcmp( last.getStr(), "abc" ) == 0 );
+
+    TEST_CHECK( flt.getVal()->getType() == DeviceDataValue::TYPE_FLOAT );
+    TEST_CHECK( flt.getVal()->getVal().f == 3.0f );
+
+    unlink( path.c_str() );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* main()
+*/
+int main( void )
+{
+    std::string dir = testDir();
+
+    if( dir.empty() )
+        return EXIT_FAILURE;
+    g_path = dir + "/store";
+
+    TEST_RUN( testAlloc );
+    TEST_RUN( testReadWrite );
+    TEST_RUN( testConcurrent );
+    TEST_RUN( testObserve );
+    TEST_RUN( testObserveTypes );
+
+    unlink( g_path.c_str() );
+    rmdir( dir.c_str() );
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,222 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataMetricsTest.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Test of the counters of the threads and the overflow scope.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <string>
+#include <thread>
+#include <vector>
+#include "DeviceDataMetrics.h"
+#include "DeviceDataTest.h"
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** number of threads counting at the same time */
+#define TEST_THREADS                4
+
+/** number of accesses counted by each thread */
+#define TEST_COUNTS                 1000
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* find()
+*/
+static const DeviceDataMetrics::s_metrics* find(
+        const std::vector< DeviceDataMetrics::s_metrics >& metrics,
+        const std::string& backend, const std::string& device, bool overflow = false )
+{
+    for( size_t i = 0; i < metrics.size(); i++ )
+    {
+        if( (metrics[i].backend == backend) && (metrics[i].device == device) &&
+            (metrics[i].overflow == overflow) )
+            return &metrics[i];
+    }
+    return NULL;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* countGet()
+*/
+static void countGet( DeviceDataMetrics::t_scope scope, uint32_t num )
+{
+    for( uint32_t i = 0; i < num; i++ )
+        DeviceDataMetrics::count( scope, DeviceDataMetrics::OP_GETVAL );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testSum()
+*/
+static void testSum( void )
+{
+    DeviceDataMetrics::t_scope scope = DeviceDataMetrics::getScope( "test", "sum" );
+    DeviceDataMetrics::t_scope other = DeviceDataMetrics::getScope( "test", "other" );
+    std::vector< DeviceDataMetrics::s_metrics > metrics;
+    std::vector< std::thread > threads;
+
+    TEST_CHECK( scope != DeviceDataMetrics::SCOPE_OVERFLOW );
+    TEST_CHECK( DeviceDataMetrics::getScope( "test", "sum" ) == scope );
+
+    /* the counters of all threads are summed up */
+    for( int i = 0; i < TEST_THREADS; i++ )
+        threads.push_back( std::thread( countGet, scope, TEST_COUNTS ) );
+    for( size_t i = 0; i < threads.size(); i++ )
+        threads[i].join();
+    std::thread( countGet, other, 10 ).join();
+
+    DeviceDataMetrics::getSnapshot( metrics );
+    const DeviceDataMetrics::s_metrics* p_sum = find( metrics, "test", "sum" );
+    TEST_CHECK( p_sum != NULL );
+    if( p_sum != NULL )
+    {
+        TEST_CHECK( p_sum->ops[DeviceDataMetrics::OP_GETVAL] ==
+            TEST_THREADS * TEST_COUNTS );
+        TEST_CHECK( p_sum->ops[DeviceDataMetrics::OP_SETVAL] == 0 );
+    }
+
+    /* the scopes of a backend are merged */
+    DeviceDataMetrics::getSnapshot( metrics, DeviceDataMetrics::GROUP_BACKEND );
+    p_sum = find( metrics, "test", "" );
+    TEST_CHECK( p_sum != NULL );
+    if( p_sum != NULL )
+        TEST_CHECK( p_sum->ops[DeviceDataMetrics::OP_GETVAL] ==
+            TEST_THREADS * TEST_COUNTS + 10 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testHandover()
+*/
+static void testHandover( void )
+{
+    DeviceDataMetrics::t_scope scope = DeviceDataMetrics::getScope( "test", "handover" );
+    std::vector< DeviceDataMetrics::s_metrics > metrics;
+    size_t shards = DeviceDataMetrics::getNumShards();
+
+    /* threads one after the other take over the counters of the ended
+     * ones and the counts are kept */
+    for( int i = 0; i < TEST_THREADS; i++ )
+        std::thread( countGet, scope, TEST_COUNTS ).join();
+    TEST_CHECK( DeviceDataMetrics::getNumShards() == shards );
+
+    DeviceDataMetrics::getSnapshot( metrics );
+    const DeviceDataMetrics::s_metrics* p_sum = find( metrics, "test", "handover" );
+    TEST_CHECK( p_sum != NULL );
+    if( p_sum != NULL )
+        TEST_CHECK( p_sum->ops[DeviceDataMetrics::OP_GETVAL] ==
+            TEST_THREADS * TEST_COUNTS );
+
+    /* the scopes counted before are still there */
+    p_sum = find( metrics, "test", "sum" );
+    TEST_CHECK( (p_sum != NULL) &&
+        (p_sum->ops[DeviceDataMetrics::OP_GETVAL] == TEST_THREADS * TEST_COUNTS) );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testOverflow()
+*/
+static void testOverflow( void )
+{
+    DeviceDataMetrics::t_scope scope = DeviceDataMetrics::getScope( "test", "sum" );
+    DeviceDataMetrics::t_scope overflow = 0;
+    std::vector< DeviceDataMetrics::s_metrics > metrics;
+
+    /* use up all the scopes */
+    for( int i = 0; i <= DEVICEDATAMETRICS_MAX_SCOPES; i++ )
+    {
+        overflow = DeviceDataMetrics::getScope( "fill", std::to_string( i ) );
+        if( overflow == DeviceDataMetrics::SCOPE_OVERFLOW )
+            break;
+    }
+    TEST_CHECK( overflow == DeviceDataMetrics::SCOPE_OVERFLOW );
+    TEST_CHECK( DeviceDataMetrics::getScope( "test", "sum" ) == scope );
+
+    countGet( overflow, 3 );
+    countGet( DeviceDataMetrics::getScope( "test", "late" ), 2 );
+
+    /* the overflow scope is reported on its own and not merged with the
+     * scopes of the same backend or device */
+    DeviceDataMetrics::getSnapshot( metrics );
+    size_t num = 0;
+    for( size_t i = 0; i < metrics.size(); i++ )
+    {
+        if( metrics[i].overflow )
+        {
+            num++;
+            TEST_CHECK( metrics[i].ops[DeviceDataMetrics::OP_GETVAL] == 5 );
+        }
+    }
+    TEST_CHECK( num == 1 );
+    TEST_CHECK( find( metrics, "", "" ) == NULL );
+    TEST_CHECK( find( metrics, "test", "late" ) == NULL );
+
+    DeviceDataMetrics::getSnapshot( metrics, DeviceDataMetrics::GROUP_DEVICE );
+    const DeviceDataMetrics::s_metrics* p_sum = find( metrics, "", "" );
+    TEST_CHECK( (p_sum == NULL) || (p_sum->overflow == false) );
+    num = 0;
+    for( size_t i = 0; i < metrics.size(); i++ )
+        num += metrics[i].overflow ? 1 : 0;
+    TEST_CHECK( num == 1 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* main()
+*/
+int main( void )
+{
+    TEST_RUN( testSum );
+    TEST_RUN( testHandover );
+    TEST_RUN( testOverflow );
+
+    return TEST_RESULT();
+}
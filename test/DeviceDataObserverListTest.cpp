@@ -0,0 +1,163 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataObserverListTest.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Test of the copy-on-write observer list.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+#include "DeviceDataObserverList.h"
+#include "DeviceDataTest.h"
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* testAddRemove()
+*/
+static void testAddRemove( void )
+{
+    DeviceDataObserverList< int > list;
+
+    TEST_CHECK( list.size() == 0 );
+
+    for( int i = 0; i < 10; i++ )
+        list.add( i );
+    TEST_CHECK( list.size() == 10 );
+
+    /* remove the odd elements, the order of the others is kept */
+    TEST_CHECK( list.remove( []( const int& v ) { return (v & 1) != 0; } ) == 5 );
+    TEST_CHECK( list.remove( []( const int& v ) { return v > 100; } ) == 0 );
+
+    DeviceDataObserverList< int >::Snapshot snap( list );
+    int expected = 0;
+    for( DeviceDataObserverList< int >::t_list::const_iterator it = snap.begin();
+            it != snap.end(); ++it )
+    {
+        TEST_CHECK( *it == expected );
+        expected += 2;
+    }
+    TEST_CHECK( snap.size() == 5 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testSnapshot()
+*/
+static void testSnapshot( void )
+{
+    DeviceDataObserverList< int > list;
+
+    list.add( 1 );
+    list.add( 2 );
+
+    /* a snapshot keeps its list while the list is modified */
+    DeviceDataObserverList< int >::Snapshot snap( list );
+    list.add( 3 );
+    list.remove( []( const int& v ) { return v == 1; } );
+
+    TEST_CHECK( snap.size() == 2 );
+    TEST_CHECK( *snap.begin() == 1 );
+    TEST_CHECK( list.size() == 2 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testConcurrent()
+*/
+static void testConcurrent( void )
+{
+    DeviceDataObserverList< int > list;
+    std::atomic<bool> stop( false );
+    std::atomic<uint32_t> bad( 0 );
+    std::vector< std::thread > readers;
+
+    /* every list published holds the elements 0 .. n-1 */
+    for( int i = 0; i < 4; i++ )
+    {
+        readers.push_back( std::thread( [&]( void ) {
+            while( stop == false )
+            {
+                DeviceDataObserverList< int >::Snapshot snap( list );
+                int expected = 0;
+                for( DeviceDataObserverList< int >::t_list::const_iterator it =
+                        snap.begin(); it != snap.end(); ++it )
+                {
+                    if( *it != expected++ )
+                        bad++;
+                }
+            }
+        } ) );
+    }
+
+    for( int round = 0; round < 200; round++ )
+    {
+        for( int i = 0; i < 20; i++ )
+            list.add( i );
+        list.remove( []( const int& ) { return true; } );
+    }
+
+    stop = true;
+    for( size_t i = 0; i < readers.size(); i++ )
+        readers[i].join();
+
+    TEST_CHECK( bad == 0 );
+    TEST_CHECK( list.size() == 0 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* main()
+*/
+int main( void )
+{
+    TEST_RUN( testAddRemove );
+    TEST_RUN( testSnapshot );
+    TEST_RUN( testConcurrent );
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,288 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataPollerTest.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Test of the grouping of the polled elements.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include "Device.h"
+#include "DeviceData.h"
+#include "DeviceDataObserver.h"
+#include "DeviceDataPoller.h"
+#include "DeviceDataTimer.h"
+#include "DeviceDataTest.h"
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** resolution of the timer of the test in ms */
+#define TEST_TICK_MS                5
+
+/** time the elements are polled in ms */
+#define TEST_POLL_MS                300
+
+/** time a blocking poll takes in ms */
+#define TEST_BLOCK_MS               200
+
+/*
+ * --- Local Class Definition ----------------------------------------------- *
+ */
+
+/**
+ * \brief   Observer stopping the poll of its element when notified.
+ */
+class TestObserver
+        : public DeviceDataObserver
+{
+
+public:
+
+    TestObserver( DeviceDataPoller* p_poller )
+        : m_handle( DeviceDataPoller::HANDLE_INVALID )
+        , m_count( 0 )
+        , m_removed( -1 )
+        , mp_poller( p_poller ) {};
+
+    virtual int8_t notify( const DeviceDataValue*, const DeviceData*, void* ) {
+        if( m_count++ == 0 )
+            m_removed = mp_poller->remove( m_handle );
+        return 0;
+    }
+
+    /** handle of the polled element */
+    DeviceDataPoller::t_handle m_handle;
+    /** number of notifications */
+    std::atomic<uint32_t> m_count;
+    /** result of the removal */
+    std::atomic<int16_t> m_removed;
+
+private:
+
+    DeviceDataPoller* mp_poller;
+};
+
+/**
+ * \brief   Observer blocking the poll of its element when notified.
+ */
+class BlockingObserver
+        : public DeviceDataObserver
+{
+
+public:
+
+    BlockingObserver( void )
+        : m_count( 0 ) {};
+
+    virtual int8_t notify( const DeviceDataValue*, const DeviceData*, void* ) {
+        if( m_count++ == 0 )
+            std::this_thread::sleep_for( std::chrono::milliseconds( TEST_BLOCK_MS ) );
+        return 0;
+    }
+
+    /** number of notifications */
+    std::atomic<uint32_t> m_count;
+};
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* testGroups()
+*/
+static void testGroups( void )
+{
+    DeviceDataTimer timer( TEST_TICK_MS );
+    DeviceDataPoller poller( &timer );
+    DeviceDataPoller::s_stats stats;
+    Device devA( "a" );
+    Device devB( "b" );
+    std::vector< DeviceDataPoller::t_handle > handles;
+
+    TestDeviceData a0( "a0", DeviceData::ACCESS_READ, &devA );
+    TestDeviceData a1( "a1", DeviceData::ACCESS_READ, &devA );
+    TestDeviceData a2( "a2", DeviceData::ACCESS_READ, &devA );
+    TestDeviceData aObs( "aObs",
+        DeviceData::ACCESS_READ | DeviceData::ACCESS_OBSERVE, &devA );
+    TestDeviceData b0( "b0", DeviceData::ACCESS_READ, &devB );
+    TestDeviceData b1( "b1", DeviceData::ACCESS_READ, &devB );
+    TestDeviceData bSlow( "bSlow", DeviceData::ACCESS_READ, &devB );
+
+    devA.addData( &a0 );
+    devA.addData( &a1 );
+    devA.addData( &a2 );
+    devA.addData( &aObs );
+
+    /* observable elements are not polled */
+    TEST_CHECK( poller.addDevice( &devA, std::chrono::milliseconds( 20 ), &handles ) == 3 );
+
+    /* intervals rounded up to the same ticks share the group */
+    handles.push_back( poller.add( &b0, std::chrono::milliseconds( 20 ), &devB ) );
+    handles.push_back( poller.add( &b1, std::chrono::milliseconds( 17 ), &devB ) );
+    handles.push_back( poller.add( &bSlow, std::chrono::milliseconds( 60 ), &devB ) );
+    TEST_CHECK( poller.add( &b0, std::chrono::milliseconds( 0 ), &devB ) ==
+        DeviceDataPoller::HANDLE_INVALID );
+    TEST_CHECK( handles.size() == 6 );
+
+    poller.getStats( stats );
+    TEST_CHECK( stats.polled == 6 );
+    TEST_CHECK( stats.groups == 3 );
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( TEST_POLL_MS ) );
+
+    /* removing waits for a running poll, so the counts are final */
+    for( size_t i = 0; i < handles.size(); i++ )
+        TEST_CHECK( poller.remove( handles[i] ) == 0 );
+    TEST_CHECK( poller.remove( handles[0] ) == -1 );
+
+    poller.getStats( stats );
+    TEST_CHECK( stats.polled == 0 );
+    TEST_CHECK( stats.groups == 0 );
+    TEST_CHECK( stats.failed == 0 );
+
+    /* the elements of a group are read together using a single request */
+    TEST_CHECK( a0.m_reads > 0 );
+    TEST_CHECK( (a1.m_reads == a0.m_reads) && (a2.m_reads == a0.m_reads) );
+    TEST_CHECK( b0.m_reads > 0 );
+    TEST_CHECK( b1.m_reads == b0.m_reads );
+    TEST_CHECK( (bSlow.m_reads > 0) && (bSlow.m_reads < b0.m_reads) );
+    TEST_CHECK( aObs.m_reads == 0 );
+
+    TEST_CHECK( stats.polls == a0.m_batches + a1.m_batches + a2.m_batches +
+        b0.m_batches + b1.m_batches + bSlow.m_batches );
+    TEST_CHECK( stats.polls == a0.m_reads + b0.m_reads + bSlow.m_reads );
+    TEST_CHECK( stats.reads == 3 * a0.m_reads + 2 * b0.m_reads + bSlow.m_reads );
+
+    /* no more polls */
+    uint32_t reads = a0.m_reads;
+    std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+    TEST_CHECK( a0.m_reads == reads );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testRemoveFromPoll()
+*/
+static void testRemoveFromPoll( void )
+{
+    DeviceDataTimer timer( TEST_TICK_MS );
+    DeviceDataPoller poller( &timer );
+    DeviceDataPoller::s_stats stats;
+    TestObserver obs( &poller );
+    TestDeviceData data( "c0", DeviceData::ACCESS_READ );
+
+    /* the observer removes the last element of the group during the poll */
+    obs.m_handle = poller.add( &data, std::chrono::milliseconds( 10 ) );
+    TEST_CHECK( obs.m_handle != DeviceDataPoller::HANDLE_INVALID );
+    TEST_CHECK( data.observeVal( &obs, NULL ) == 0 );
+
+    for( int i = 0; (i < 100) && (obs.m_count == 0); i++ )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 10 ) );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+
+    TEST_CHECK( obs.m_count == 1 );
+    TEST_CHECK( obs.m_removed == 0 );
+    TEST_CHECK( data.m_reads == 1 );
+
+    poller.getStats( stats );
+    TEST_CHECK( stats.polled == 0 );
+    TEST_CHECK( stats.groups == 0 );
+    TEST_CHECK( stats.polls == 1 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testBlockingPoll()
+*/
+static void testBlockingPoll( void )
+{
+    DeviceDataTimer timer( TEST_TICK_MS );
+    DeviceDataExecutor exec( 2 );
+    DeviceDataPoller poller( &timer, &exec );
+    BlockingObserver obs;
+    Device devA( "a" );
+    Device devB( "b" );
+    TestDeviceData slow( "slow", DeviceData::ACCESS_READ, &devA );
+    TestDeviceData fast( "fast", DeviceData::ACCESS_READ, &devB );
+
+    DeviceDataPoller::t_handle hSlow = poller.add( &slow,
+        std::chrono::milliseconds( 10 ), &devA );
+    TEST_CHECK( slow.observeVal( &obs, NULL ) == 0 );
+    DeviceDataPoller::t_handle hFast = poller.add( &fast,
+        std::chrono::milliseconds( 10 ), &devB );
+
+    for( int i = 0; (i < 100) && (obs.m_count == 0); i++ )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    uint32_t reads = fast.m_reads;
+    std::this_thread::sleep_for( std::chrono::milliseconds( TEST_BLOCK_MS / 2 ) );
+
+    /* other groups are polled while a poll blocks */
+    TEST_CHECK( obs.m_count == 1 );
+    TEST_CHECK( fast.m_reads > reads + 2 );
+
+    /* the blocked group is not polled again before its poll finished */
+    TEST_CHECK( slow.m_reads == 1 );
+
+    TEST_CHECK( poller.remove( hSlow ) == 0 );
+    TEST_CHECK( obs.m_count == 1 );
+    TEST_CHECK( poller.remove( hFast ) == 0 );
+    TEST_CHECK( slow.unobserveVal( &obs, NULL ) == 1 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* main()
+*/
+int main( void )
+{
+    TEST_RUN( testGroups );
+    TEST_RUN( testRemoveFromPoll );
+    TEST_RUN( testBlockingPoll );
+
+    return TEST_RESULT();
+}
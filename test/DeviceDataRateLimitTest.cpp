@@ -0,0 +1,244 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataRateLimitTest.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Test of the rate limited observers.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "DeviceData.h"
+#include "DeviceDataObserver.h"
+#include "DeviceDataTimer.h"
+#include "DeviceDataTest.h"
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** resolution of the timer of the test in ms */
+#define TEST_TICK_MS                5
+
+/** minimum interval between two notifications in ms */
+#define TEST_INTERVAL_MS            100
+
+/*
+ * --- Local Class Definition ----------------------------------------------- *
+ */
+
+/**
+ * \brief   Observer recording the coalesced notifications.
+ *
+ *          If a value to write is set, the observer writes it to the
+ *          element from within its first notification.
+ */
+class TestObserver
+        : public DeviceDataObserver
+{
+
+public:
+
+    TestObserver( DeviceData* p_data = NULL, int32_t write = 0 )
+        : m_count( 0 )
+        , m_val( 0 )
+        , m_suppressed( 0 )
+        , m_concurrent( 0 )
+        , m_active( 0 )
+        , mp_data( p_data )
+        , m_write( write ) {};
+
+    virtual int8_t notify( const DeviceDataValue* val, const DeviceData* p_data,
+            void* p_param ) {
+        return notifyCoalesced( val, p_data, p_param, 0 );
+    }
+
+    virtual int8_t notifyCoalesced( const DeviceDataValue* val, const DeviceData*,
+            void*, uint32_t suppressed ) {
+        if( m_active++ != 0 )
+            m_concurrent++;
+
+        m_val = val->getVal().i32;
+        m_suppressed += suppressed;
+        if( (m_count++ == 0) && (mp_data != NULL) )
+        {
+            DeviceDataValue w( DeviceDataValue::TYPE_INTEGER );
+            w.setVal( m_write );
+            mp_data->setVal( &w );
+        }
+
+        m_active--;
+        return 0;
+    }
+
+    /** number of notifications */
+    std::atomic<uint32_t> m_count;
+    /** last value notified */
+    std::atomic<int32_t> m_val;
+    /** sum of the suppressed values reported */
+    std::atomic<uint32_t> m_suppressed;
+    /** number of notifications delivered while another one was running */
+    std::atomic<uint32_t> m_concurrent;
+
+private:
+
+    /** number of notifications running */
+    std::atomic<uint32_t> m_active;
+    /** element to write from within the first notification */
+    DeviceData* mp_data;
+    /** value to write */
+    int32_t m_write;
+};
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* setVal()
+*/
+static int16_t setVal( DeviceData* p_data, int32_t val )
+{
+    DeviceDataValue v( DeviceDataValue::TYPE_INTEGER );
+    v.setVal( val );
+    return p_data->setVal( &v );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testLatest()
+*/
+static void testLatest( void )
+{
+    TestDeviceData data;
+    TestObserver obs;
+
+    TEST_CHECK( data.observeVal( &obs, NULL,
+        std::chrono::milliseconds( TEST_INTERVAL_MS ) ) == 0 );
+
+    /* the first change is delivered directly */
+    TEST_CHECK( setVal( &data, 1 ) == 0 );
+    TEST_CHECK( (obs.m_count == 1) && (obs.m_val == 1) );
+
+    /* changes within the interval are coalesced, the latest one wins */
+    TEST_CHECK( setVal( &data, 2 ) == 0 );
+    TEST_CHECK( setVal( &data, 3 ) == 0 );
+    TEST_CHECK( setVal( &data, 4 ) == 0 );
+    TEST_CHECK( obs.m_count == 1 );
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 3 * TEST_INTERVAL_MS ) );
+    TEST_CHECK( obs.m_count == 2 );
+    TEST_CHECK( obs.m_val == 4 );
+    TEST_CHECK( obs.m_suppressed == 2 );
+
+    /* after a quiet period the next change is delivered directly again */
+    TEST_CHECK( setVal( &data, 5 ) == 0 );
+    TEST_CHECK( (obs.m_count == 3) && (obs.m_val == 5) );
+    TEST_CHECK( obs.m_concurrent == 0 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testCancel()
+*/
+static void testCancel( void )
+{
+    TestDeviceData data;
+    TestObserver obs;
+    DeviceData::t_obsHandle handle;
+
+    TEST_CHECK( data.observeVal( &obs, NULL,
+        std::chrono::milliseconds( TEST_INTERVAL_MS ), DeviceDataFilter(),
+        true, &handle ) == 0 );
+
+    TEST_CHECK( setVal( &data, 1 ) == 0 );
+    TEST_CHECK( setVal( &data, 2 ) == 0 );
+
+    /* the value waiting for the interval is dropped */
+    TEST_CHECK( data.unobserveVal( handle ) == 0 );
+    std::this_thread::sleep_for( std::chrono::milliseconds( 3 * TEST_INTERVAL_MS ) );
+    TEST_CHECK( obs.m_count == 1 );
+    TEST_CHECK( obs.m_val == 1 );
+
+    TEST_CHECK( setVal( &data, 3 ) == 0 );
+    TEST_CHECK( obs.m_count == 1 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testReentrant()
+*/
+static void testReentrant( void )
+{
+    TestDeviceData data;
+    TestObserver obs( &data, 10 );
+
+    TEST_CHECK( data.observeVal( &obs, NULL,
+        std::chrono::milliseconds( TEST_INTERVAL_MS ) ) == 0 );
+
+    /* the change within the notification is delivered afterwards */
+    TEST_CHECK( setVal( &data, 1 ) == 0 );
+    TEST_CHECK( obs.m_count == 1 );
+
+    std::this_thread::sleep_for( std::chrono::milliseconds( 3 * TEST_INTERVAL_MS ) );
+    TEST_CHECK( obs.m_count == 2 );
+    TEST_CHECK( obs.m_val == 10 );
+    TEST_CHECK( obs.m_concurrent == 0 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* main()
+*/
+int main( void )
+{
+    DeviceDataTimer timer( TEST_TICK_MS );
+    DeviceData::setTimer( &timer );
+
+    TEST_RUN( testLatest );
+    TEST_RUN( testCancel );
+    TEST_RUN( testReentrant );
+
+    DeviceData::setTimer( NULL );
+    return TEST_RESULT();
+}
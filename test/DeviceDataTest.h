@@ -0,0 +1,216 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataTest.h
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Checks and a backend shared by the device data tests.
+ *
+ *          Each test is an executable of its own. A failed check prints
+ *          its location and the test returns a non-zero exit code.
+ */
+
+
+#ifndef __DEVICEDATATEST_H__
+#define __DEVICEDATATEST_H__
+#ifndef __DECL_DEVICEDATATEST_H__
+#define __DECL_DEVICEDATATEST_H__ extern
+#endif /* #ifndef __DECL_DEVICEDATATEST_H__ */
+
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <string>
+#include <vector>
+#include "DeviceData.h"
+
+/*
+ * --- Macro Definitions ---------------------------------------------------- *
+ */
+
+/** check a condition and count the failure */
+#define TEST_CHECK( cond )                                                  \
+    do {                                                                    \
+        if( !(cond) )                                                       \
+        {                                                                   \
+            fprintf( stderr, "%s:%d: check failed: %s\n",                   \
+                __FILE__, __LINE__, #cond );                                \
+            testFailed()++;                                                 \
+        }                                                                   \
+    } while( 0 )
+
+/** run a test case */
+#define TEST_RUN( func )                                                    \
+    do {                                                                    \
+        printf( "%s\n", #func );                                            \
+        func();                                                             \
+    } while( 0 )
+
+/** exit code of the test */
+#define TEST_RESULT()                                                       \
+    ((testFailed() == 0) ? EXIT_SUCCESS : EXIT_FAILURE)
+
+/*
+ * --- Local Class Definition ----------------------------------------------- *
+ */
+
+/**
+ * \brief   Backend keeping the value in memory.
+ *
+ *          The native functions only copy the value and count the
+ *          accesses. Like a device the backend keeps the value in the
+ *          type of the element. Elements sharing a group are read using
+ *          a single native request. The value of an element shall not be
+ *          written from several threads at once.
+ */
+class TestDeviceData
+        : public DeviceData
+{
+
+public:
+
+    TestDeviceData( std::string name = "test",
+            int access = DeviceData::ACCESS_READ | DeviceData::ACCESS_WRITE |
+                DeviceData::ACCESS_OBSERVE,
+            const void* p_group = NULL )
+        : DeviceData( name, "test", DeviceDataValue::TYPE_INTEGER, access )
+        , m_reads( 0 )
+        , m_writes( 0 )
+        , m_batches( 0 )
+        , m_native( DeviceDataValue::TYPE_INTEGER )
+        , mp_group( p_group ) {};
+
+    TestDeviceData( std::string name, std::string descr,
+            DeviceDataValue::e_type type, int access )
+        : DeviceData( name, descr, type, access )
+        , m_reads( 0 )
+        , m_writes( 0 )
+        , m_batches( 0 )
+        , m_native( type )
+        , mp_group( NULL ) {};
+
+    virtual const char* getBackend( void ) const {
+        return "test";
+    }
+
+    /** number of native reads */
+    std::atomic<uint32_t> m_reads;
+    /** number of native writes */
+    std::atomic<uint32_t> m_writes;
+    /** number of native requests issued on the element reading a group */
+    std::atomic<uint32_t> m_batches;
+
+private:
+
+    virtual int16_t getValNative( DeviceDataValue* val ) {
+        m_reads++;
+        *val = m_native;
+        return 0;
+    }
+
+    virtual int16_t setValNative( const DeviceDataValue* val ) {
+        m_writes++;
+        return m_native.convert( *val );
+    }
+
+    virtual int8_t observeValNative( bool = true ) {
+        return 0;
+    }
+
+    virtual bool batchCompatible( const DeviceData* p_data ) const {
+        const TestDeviceData* p_other = dynamic_cast< const TestDeviceData* >( p_data );
+        return (mp_group != NULL) && (p_other != NULL) &&
+            (p_other->mp_group == mp_group);
+    }
+
+    virtual void getValsNative( const std::vector<DeviceData*>& data,
+            const std::vector<DeviceDataValue*>& vals,
+            std::vector<int16_t>& ret ) {
+        m_batches++;
+        for( size_t i = 0; i < data.size(); i++ )
+            ret[i] = static_cast< TestDeviceData* >( data[i] )->getValNative( vals[i] );
+    }
+
+    /** value of the backend */
+    DeviceDataValue m_native;
+
+    /** group of the element */
+    const void* mp_group;
+};
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* testFailed()
+*/
+/**
+ * \brief   Number of failed checks.
+ *
+ * \return  Counter of the failed checks.
+ */
+static inline int& testFailed( void )
+{
+    static int failed = 0;
+    return failed;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testDir()
+*/
+/**
+ * \brief   Create an empty directory for the files of a test.
+ *
+ * \return  Path of the directory or an empty string on error.
+ */
+static inline std::string testDir( void )
+{
+    char path[] = "/tmp/devicedatatestXXXXXX";
+
+    if( mkdtemp( path ) == NULL )
+        return std::string();
+    return std::string( path );
+}
+
+#endif /* #ifndef __DEVICEDATATEST_H__ */
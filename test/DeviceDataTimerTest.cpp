@@ -0,0 +1,269 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataTimerTest.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Test of the timing wheel of the device data elements.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "DeviceDataTimer.h"
+#include "DeviceDataTest.h"
+
+/*
+ * --- DEFINES -------------------------------------------------------------- *
+ */
+
+/** resolution of the timers of the test in ms */
+#define TEST_TICK_MS                5
+
+/** slots of the timing wheel, few to let the timers need several rounds */
+#define TEST_SLOTS                  8
+
+/** tolerated delay of an expiry in ms */
+#define TEST_LATE_MS                500
+
+/*
+ * --- Local Class Definition ----------------------------------------------- *
+ */
+
+/**
+ * \brief   Timer entry recording its expiries.
+ */
+class TestEntry
+        : public DeviceDataTimer::Entry
+{
+
+public:
+
+    TestEntry( DeviceDataTimer* p_timer, uint32_t period = 0 )
+        : m_delayMs( 0 )
+        , m_count( 0 )
+        , m_running( false )
+        , m_sleepMs( 0 )
+        , mp_timer( p_timer )
+        , m_period( period ) {};
+
+    /** start the timer and remember the time */
+    int16_t start( uint32_t delay ) {
+        m_started = std::chrono::steady_clock::now();
+        return mp_timer->start( this, delay );
+    }
+
+    /** expiry time of the first expiry in ms */
+    std::atomic<int64_t> m_delayMs;
+    /** number of expiries */
+    std::atomic<uint32_t> m_count;
+    /** the expiry function is running */
+    std::atomic<bool> m_running;
+    /** time the expiry function sleeps in ms */
+    uint32_t m_sleepMs;
+
+private:
+
+    virtual void expired( void ) {
+        m_running = true;
+        if( m_count++ == 0 )
+            m_delayMs = std::chrono::duration_cast< std::chrono::milliseconds >(
+                    std::chrono::steady_clock::now() - m_started ).count();
+
+        if( m_sleepMs > 0 )
+            std::this_thread::sleep_for( std::chrono::milliseconds( m_sleepMs ) );
+
+        /* periodic timers restart themselves */
+        if( m_period > 0 )
+            mp_timer->start( this, m_period );
+        m_running = false;
+    }
+
+    DeviceDataTimer* mp_timer;
+    uint32_t m_period;
+    std::chrono::steady_clock::time_point m_started;
+};
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* waitCount()
+*/
+static bool waitCount( TestEntry& entry, uint32_t count, uint32_t timeoutMs )
+{
+    std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now() +
+        std::chrono::milliseconds( timeoutMs );
+
+    while( entry.m_count < count )
+    {
+        if( std::chrono::steady_clock::now() > end )
+            return false;
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+    }
+    return true;
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testExpiry()
+*/
+static void testExpiry( void )
+{
+    DeviceDataTimer timer( TEST_TICK_MS, TEST_SLOTS );
+    std::vector< TestEntry* > entries;
+    const uint32_t delays[] = { 0, 1, 12, 40, 41, 100, 333 };
+    const size_t num = sizeof(delays) / sizeof(delays[0]);
+
+    TEST_CHECK( timer.getTick() == TEST_TICK_MS );
+
+    /* delays above the wheel size need several rounds */
+    for( size_t i = 0; i < num; i++ )
+    {
+        entries.push_back( new TestEntry( &timer ) );
+        TEST_CHECK( entries[i]->start( delays[i] ) == 0 );
+    }
+    TEST_CHECK( timer.getArmed() == num );
+
+    for( size_t i = 0; i < num; i++ )
+    {
+        TEST_CHECK( waitCount( *entries[i], 1, delays[i] + TEST_LATE_MS ) );
+
+        /* the actual tick counts to the delay */
+        int64_t d = entries[i]->m_delayMs;
+        TEST_CHECK( d + TEST_TICK_MS >= (int64_t)delays[i] );
+        TEST_CHECK( d <= (int64_t)delays[i] + TEST_LATE_MS );
+    }
+
+    /* each timer expired once */
+    std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+    TEST_CHECK( timer.getArmed() == 0 );
+    for( size_t i = 0; i < num; i++ )
+    {
+        TEST_CHECK( entries[i]->m_count == 1 );
+        delete entries[i];
+    }
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testRestartStop()
+*/
+static void testRestartStop( void )
+{
+    DeviceDataTimer timer( TEST_TICK_MS, TEST_SLOTS );
+    TestEntry restarted( &timer );
+    TestEntry stopped( &timer );
+
+    /* a restart replaces the delay */
+    TEST_CHECK( restarted.start( 20 ) == 0 );
+    TEST_CHECK( restarted.start( 150 ) == 0 );
+    TEST_CHECK( timer.getArmed() == 1 );
+
+    TEST_CHECK( stopped.start( 20 ) == 0 );
+    timer.stop( &stopped );
+    timer.stop( &stopped );
+    TEST_CHECK( timer.getArmed() == 1 );
+
+    TEST_CHECK( waitCount( restarted, 1, 150 + TEST_LATE_MS ) );
+    TEST_CHECK( restarted.m_delayMs + TEST_TICK_MS >= 150 );
+    TEST_CHECK( stopped.m_count == 0 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testPeriodic()
+*/
+static void testPeriodic( void )
+{
+    DeviceDataTimer timer( TEST_TICK_MS, TEST_SLOTS );
+    TestEntry entry( &timer, 10 );
+
+    /* the expiry function restarts the timer */
+    TEST_CHECK( entry.start( 10 ) == 0 );
+    TEST_CHECK( waitCount( entry, 5, 50 + TEST_LATE_MS ) );
+
+    /* a restart within a running expiry needs a second stop */
+    timer.stop( &entry );
+    timer.stop( &entry );
+    uint32_t count = entry.m_count;
+    std::this_thread::sleep_for( std::chrono::milliseconds( 50 ) );
+    TEST_CHECK( entry.m_count == count );
+    TEST_CHECK( timer.getArmed() == 0 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testStopRunning()
+*/
+static void testStopRunning( void )
+{
+    DeviceDataTimer timer( TEST_TICK_MS, TEST_SLOTS );
+    TestEntry entry( &timer );
+
+    entry.m_sleepMs = 100;
+    TEST_CHECK( entry.start( 10 ) == 0 );
+
+    while( entry.m_running == false )
+        std::this_thread::sleep_for( std::chrono::milliseconds( 1 ) );
+
+    /* stopping waits for the running expiry function */
+    timer.stop( &entry );
+    TEST_CHECK( entry.m_running == false );
+    TEST_CHECK( entry.m_count == 1 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* main()
+*/
+int main( void )
+{
+    TEST_RUN( testExpiry );
+    TEST_RUN( testRestartStop );
+    TEST_RUN( testPeriodic );
+    TEST_RUN( testStopRunning );
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,243 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataValueConvTest.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Test of the text conversions of the device data values.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include "DeviceDataValue.h"
+#include "DeviceDataValueConv.h"
+#include "DeviceDataTest.h"
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* format()
+*/
+template < typename T >
+static std::string format( T val )
+{
+    char buf[DEVICEDATAVALUE_NUMSTRMAX];
+    size_t len = DeviceDataValueConv::toChars( buf, sizeof(buf), val );
+
+    return std::string( buf, len );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* parseInt()
+*/
+static int16_t parseInt( const char* str, int64_t& val )
+{
+    return DeviceDataValueConv::fromChars( str, str + strlen( str ), val );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* parseDouble()
+*/
+static int16_t parseDouble( const char* str, double& val )
+{
+    return DeviceDataValueConv::fromChars( str, str + strlen( str ), val );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testFormat()
+*/
+static void testFormat( void )
+{
+    char buf[4];
+
+    TEST_CHECK( format( (int32_t)0 ) == "0" );
+    TEST_CHECK( format( (int32_t)-42 ) == "-42" );
+    TEST_CHECK( format( INT64_MAX ) == "9223372036854775807" );
+    TEST_CHECK( format( INT64_MIN ) == "-9223372036854775808" );
+
+    /* the shortest lossless representation */
+    TEST_CHECK( format( 0.1f ) == "0.1" );
+    TEST_CHECK( format( 0.1 ) == "0.1" );
+    TEST_CHECK( format( 1.5 ) == "1.5" );
+    TEST_CHECK( format( -2.0f ) == "-2" );
+
+    /* too small buffers */
+    TEST_CHECK( DeviceDataValueConv::toChars( buf, sizeof(buf), (int64_t)12345 ) == 0 );
+    TEST_CHECK( DeviceDataValueConv::toChars( buf, sizeof(buf), (int64_t)-123 ) == 4 );
+    TEST_CHECK( DeviceDataValueConv::toChars( buf, sizeof(buf), 0.123456 ) == 0 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testParse()
+*/
+static void testParse( void )
+{
+    int64_t i = 0;
+    double d = 0;
+
+    TEST_CHECK( (parseInt( "42", i ) == 0) && (i == 42) );
+    TEST_CHECK( (parseInt( " \t+42", i ) == 0) && (i == 42) );
+    TEST_CHECK( (parseInt( "-17abc", i ) == 0) && (i == -17) );
+    TEST_CHECK( (parseInt( "-9223372036854775808", i ) == 0) && (i == INT64_MIN) );
+    TEST_CHECK( parseInt( "9223372036854775808", i ) != 0 );
+    TEST_CHECK( parseInt( "abc", i ) != 0 );
+    TEST_CHECK( parseInt( "", i ) != 0 );
+    TEST_CHECK( parseInt( "+-1", i ) != 0 );
+
+    TEST_CHECK( (parseDouble( "1.5", d ) == 0) && (d == 1.5) );
+    TEST_CHECK( (parseDouble( " +2.5e3", d ) == 0) && (d == 2500.0) );
+    TEST_CHECK( (parseDouble( "-0.25\n", d ) == 0) && (d == -0.25) );
+    TEST_CHECK( parseDouble( "x1", d ) != 0 );
+    TEST_CHECK( parseDouble( "", d ) != 0 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testRoundTrip()
+*/
+static void testRoundTrip( void )
+{
+    uint64_t state = 88172645463325252ULL;
+    int failed = 0;
+
+    /* formatted values are read back without loss */
+    for( int n = 0; n < 100000; n++ )
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+
+        double d;
+        float f;
+        uint32_t u32 = (uint32_t)state;
+        memcpy( &d, &state, sizeof(d) );
+        memcpy( &f, &u32, sizeof(f) );
+        if( (d != d) || (f != f) || (d - d != 0) || (f - f != 0) )
+            /* skip NaN and infinity */
+            continue;
+
+        int64_t i = (int64_t)state;
+        int64_t iBack = 0;
+        double dBack = 0;
+        std::string s = format( i );
+        if( (parseInt( s.c_str(), iBack ) != 0) || (iBack != i) )
+            failed++;
+
+        s = format( d );
+        if( (parseDouble( s.c_str(), dBack ) != 0) || (dBack != d) )
+            failed++;
+
+        s = format( f );
+        if( (parseDouble( s.c_str(), dBack ) != 0) || ((float)dBack != f) )
+            failed++;
+    }
+
+    TEST_CHECK( failed == 0 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testValue()
+*/
+static void testValue( void )
+{
+    char buf[DEVICEDATAVALUE_NUMSTRMAX];
+
+    /* numbers parsed from strings */
+    DeviceDataValue i32( DeviceDataValue::TYPE_INTEGER );
+    TEST_CHECK( i32.setVal( "12\r\n" ) == 0 );
+    TEST_CHECK( i32.getVal().i32 == 12 );
+    TEST_CHECK( i32.setVal( "twelve" ) != 0 );
+    TEST_CHECK( i32.getVal().i32 == 12 );
+
+    DeviceDataValue flt( DeviceDataValue::TYPE_FLOAT );
+    TEST_CHECK( flt.setVal( "0.1" ) == 0 );
+    TEST_CHECK( flt.getVal().f == 0.1f );
+
+    DeviceDataValue dbl( DeviceDataValue::TYPE_DOUBLE );
+    TEST_CHECK( dbl.setVal( std::string( "-1e-5" ) ) == 0 );
+    TEST_CHECK( dbl.getVal().d == -1e-5 );
+
+    /* strings formatted from numbers, a CR or LF ends a string */
+    DeviceDataValue str( DeviceDataValue::TYPE_STRING );
+    TEST_CHECK( str.setVal( (int32_t)-7 ) == 0 );
+    TEST_CHECK( strcmp( str.getStr(), "-7" ) == 0 );
+    TEST_CHECK( str.setVal( 0.1 ) == 0 );
+    TEST_CHECK( strcmp( str.getStr(), "0.1" ) == 0 );
+    TEST_CHECK( str.setVal( "line\nnext" ) == 0 );
+    TEST_CHECK( strcmp( str.getStr(), "line" ) == 0 );
+
+    /* conversions between the types */
+    TEST_CHECK( str.setVal( "2.5" ) == 0 );
+    TEST_CHECK( dbl.convert( str ) == 0 );
+    TEST_CHECK( dbl.getVal().d == 2.5 );
+    TEST_CHECK( str.convert( i32 ) == 0 );
+    TEST_CHECK( strcmp( str.getStr(), "12" ) == 0 );
+
+    /* values written as text */
+    size_t len = flt.toChars( buf, sizeof(buf) );
+    TEST_CHECK( std::string( buf, len ) == "0.1" );
+    len = str.toChars( buf, sizeof(buf) );
+    TEST_CHECK( std::string( buf, len ) == "12" );
+
+    DeviceDataValue opaque( DeviceDataValue::TYPE_OPAQUE );
+    TEST_CHECK( opaque.toChars( buf, sizeof(buf) ) == 0 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* main()
+*/
+int main( void )
+{
+    TEST_RUN( testFormat );
+    TEST_RUN( testParse );
+    TEST_RUN( testRoundTrip );
+    TEST_RUN( testValue );
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,234 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    DeviceDataValueTest.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Test of the small buffer storage and the buffer pool of the
+ *          device data values.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <string.h>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "DeviceDataValue.h"
+#include "DeviceDataTest.h"
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* isInline()
+*/
+static bool isInline( const DeviceDataValue& val )
+{
+    const uint8_t* p = val.getOpaque();
+    const uint8_t* p_obj = (const uint8_t*)&val;
+
+    return (p >= p_obj) && (p < p_obj + sizeof(val));
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testInline()
+*/
+static void testInline( void )
+{
+    DeviceDataValue str( DeviceDataValue::TYPE_STRING );
+    std::string s( DEVICEDATAVALUE_INLINEMAX - 1, 'a' );
+
+    /* a string fits inline including its termination */
+    TEST_CHECK( str.setVal( s ) == 0 );
+    TEST_CHECK( isInline( str ) );
+    TEST_CHECK( str.getLen() == s.length() );
+    TEST_CHECK( strcmp( str.getStr(), s.c_str() ) == 0 );
+
+    s += 'b';
+    TEST_CHECK( str.setVal( s ) == 0 );
+    TEST_CHECK( isInline( str ) == false );
+    TEST_CHECK( strcmp( str.getStr(), s.c_str() ) == 0 );
+
+    /* opaque values need no termination */
+    DeviceDataValue opaque( DeviceDataValue::TYPE_OPAQUE );
+    uint8_t data[DEVICEDATAVALUE_INLINEMAX];
+    for( size_t i = 0; i < sizeof(data); i++ )
+        data[i] = (uint8_t)i;
+    TEST_CHECK( opaque.setVal( data, sizeof(data) ) == 0 );
+    TEST_CHECK( isInline( opaque ) );
+    TEST_CHECK( opaque.getLen() == sizeof(data) );
+    TEST_CHECK( memcmp( opaque.getOpaque(), data, sizeof(data) ) == 0 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testBuffer()
+*/
+static void testBuffer( void )
+{
+    DeviceDataValue str( DeviceDataValue::TYPE_STRING );
+    std::string lng( 40, 'x' );
+    std::string shrt( 20, 'y' );
+
+    TEST_CHECK( str.setVal( lng ) == 0 );
+    const uint8_t* p = str.getOpaque();
+
+    /* the buffer is kept while the values fit into it */
+    TEST_CHECK( str.setVal( shrt ) == 0 );
+    TEST_CHECK( str.getOpaque() == p );
+    TEST_CHECK( strcmp( str.getStr(), shrt.c_str() ) == 0 );
+
+    /* a numeric value gives the buffer back */
+    DeviceDataValue num( DeviceDataValue::TYPE_INTEGER );
+    num.setVal( (int32_t)42 );
+    str = num;
+    TEST_CHECK( str.getType() == DeviceDataValue::TYPE_INTEGER );
+    TEST_CHECK( str.getVal().i32 == 42 );
+
+    /* the pool hands out the buffer returned last */
+    DeviceDataValue other( DeviceDataValue::TYPE_STRING );
+    TEST_CHECK( other.setVal( lng ) == 0 );
+    TEST_CHECK( other.getOpaque() == p );
+
+    /* values too large for the pool */
+    std::string huge( 100000, 'z' );
+    TEST_CHECK( other.setVal( huge ) == 0 );
+    TEST_CHECK( other.getLen() == huge.length() );
+    TEST_CHECK( other.getStr() == huge );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testCopyMove()
+*/
+static void testCopyMove( void )
+{
+    DeviceDataValue str( DeviceDataValue::TYPE_STRING );
+    std::string lng( 50, 'c' );
+
+    TEST_CHECK( str.setVal( lng ) == 0 );
+
+    /* a copy gets a buffer of its own */
+    DeviceDataValue copy( str );
+    TEST_CHECK( copy == str );
+    TEST_CHECK( copy.getOpaque() != str.getOpaque() );
+
+    /* a move takes over the buffer */
+    const uint8_t* p = str.getOpaque();
+    DeviceDataValue moved( std::move( str ) );
+    TEST_CHECK( moved.getOpaque() == p );
+    TEST_CHECK( moved == copy );
+    TEST_CHECK( str.getLen() == 0 );
+
+    DeviceDataValue assigned( DeviceDataValue::TYPE_STRING );
+    assigned = std::move( moved );
+    TEST_CHECK( assigned.getOpaque() == p );
+    TEST_CHECK( assigned == copy );
+
+    /* copying a short value keeps it inline */
+    DeviceDataValue shrt( DeviceDataValue::TYPE_STRING );
+    shrt.setVal( "short" );
+    DeviceDataValue shrtCopy( shrt );
+    TEST_CHECK( isInline( shrtCopy ) );
+    TEST_CHECK( shrtCopy == shrt );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testConcurrent()
+*/
+static void testConcurrent( void )
+{
+    std::vector< std::thread > threads;
+    std::vector< int > bad( 4, 0 );
+
+    /* the threads share the pool, every value keeps its content */
+    for( int t = 0; t < 4; t++ )
+    {
+        threads.push_back( std::thread( [&bad, t]( void ) {
+            std::vector< DeviceDataValue > vals;
+
+            for( int round = 0; round < 2000; round++ )
+            {
+                std::string s( 17 + ((round * 31 + t) % 400), (char)('a' + t) );
+                DeviceDataValue val( DeviceDataValue::TYPE_STRING );
+                val.setVal( s );
+                vals.push_back( val );
+
+                if( vals.size() > 16 )
+                {
+                    for( size_t i = 0; i < vals.size(); i++ )
+                    {
+                        const char* p = vals[i].getStr();
+                        for( uint32_t j = 0; j < vals[i].getLen(); j++ )
+                        {
+                            if( p[j] != (char)('a' + t) )
+                                bad[t]++;
+                        }
+                    }
+                    vals.clear();
+                }
+            }
+        } ) );
+    }
+
+    for( size_t i = 0; i < threads.size(); i++ )
+        threads[i].join();
+
+    for( size_t i = 0; i < bad.size(); i++ )
+        TEST_CHECK( bad[i] == 0 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* main()
+*/
+int main( void )
+{
+    TEST_RUN( testInline );
+    TEST_RUN( testBuffer );
+    TEST_RUN( testCopyMove );
+    TEST_RUN( testConcurrent );
+
+    return TEST_RESULT();
+}
@@ -0,0 +1,194 @@
+/*
+ * --- License -------------------------------------------------------------- *
+ */
+
+/*
+ * Copyright 2017 NIKI 4.0 project team
+ *
+ * NIKI 4.0 was financed by the Baden-Württemberg Stiftung gGmbH (www.bwstiftung.de).
+ * Project partners are FZI Forschungszentrum Informatik am Karlsruher
+ * Institut für Technologie (www.fzi.de), Hahn-Schickard-Gesellschaft
+ * für angewandte Forschung e.V. (www.hahn-schickard.de) and
+ * Hochschule Offenburg (www.hs-offenburg.de).
+ * This file was developed by the Institute of reliable Embedded Systems
+ * and Communication Electronics
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+*/
+
+/*
+ * --- Module Description --------------------------------------------------- *
+ */
+
+/**
+ * \file    TypedDeviceDataTest.cpp
+ * \author  Institute of reliable Embedded Systems
+ *          and Communication Electronics
+ * \date    $Date$
+ * \version $Version$
+ *
+ * \brief   Test of the device data elements of a type known at compile time.
+ */
+
+/*
+ * --- Includes ------------------------------------------------------------- *
+ */
+#include <stdint.h>
+#include <string>
+#include "DeviceData.h"
+#include "DeviceDataObserver.h"
+#include "TypedDeviceData.h"
+#include "DeviceDataTest.h"
+
+/*
+ * --- Local Class Definition ----------------------------------------------- *
+ */
+
+/**
+ * \brief   Observer keeping the last value notified as integer.
+ */
+class TestObserver
+        : public DeviceDataObserver
+{
+
+public:
+
+    TestObserver( void )
+        : m_count( 0 )
+        , m_val( 0 ) {};
+
+    virtual int8_t notify( const DeviceDataValue* val, const DeviceData*, void* ) {
+        m_count++;
+        m_val = TypedDeviceData< int32_t, TestDeviceData >::valueOf( *val );
+        return 0;
+    }
+
+    /** number of notifications */
+    uint32_t m_count;
+    /** last value notified */
+    int32_t m_val;
+};
+
+/*
+ * --- Local Functions ------------------------------------------------------ *
+ */
+
+/*---------------------------------------------------------------------------*/
+/*
+* testAccess()
+*/
+static void testAccess( void )
+{
+    TypedDeviceData< double, TestDeviceData > dbl( "dbl", "double",
+        DeviceData::ACCESS_READ | DeviceData::ACCESS_WRITE );
+    TypedDeviceData< std::string, TestDeviceData > str( "str", "string",
+        DeviceData::ACCESS_READ | DeviceData::ACCESS_WRITE );
+    TypedDeviceData< bool, TestDeviceData > flag( "flag", "boolean",
+        DeviceData::ACCESS_READ | DeviceData::ACCESS_WRITE );
+    TypedDeviceData< int32_t, TestDeviceData > ro( "ro", "read only",
+        DeviceData::ACCESS_READ );
+    double d = 0;
+    std::string s;
+    bool b = false;
+
+    /* the type of the element is given by the C++ type */
+    TEST_CHECK( dbl.getVal()->getType() == DeviceDataValue::TYPE_DOUBLE );
+    TEST_CHECK( str.getVal()->getType() == DeviceDataValue::TYPE_STRING );
+    TEST_CHECK( flag.getVal()->getType() == DeviceDataValue::TYPE_INTEGER );
+
+    TEST_CHECK( dbl.set( 2.5 ) == 0 );
+    TEST_CHECK( dbl.get( d ) == 0 );
+    TEST_CHECK( d == 2.5 );
+    TEST_CHECK( (dbl.m_writes == 1) && (dbl.m_reads == 2) );
+
+    /* the cached value is used within the maximum age */
+    TEST_CHECK( dbl.get( d, 1000 ) == 0 );
+    TEST_CHECK( (d == 2.5) && (dbl.m_reads == 2) );
+
+    TEST_CHECK( str.set( "abc" ) == 0 );
+    TEST_CHECK( str.get( s ) == 0 );
+    TEST_CHECK( s == "abc" );
+
+    /* booleans are stored as integer 0 or 1 */
+    TEST_CHECK( flag.set( true ) == 0 );
+    TEST_CHECK( flag.get( b ) == 0 );
+    TEST_CHECK( b == true );
+    TEST_CHECK( flag.getVal()->getVal().i32 == 1 );
+
+    /* the access permissions of the element apply */
+    TEST_CHECK( ro.set( 1 ) != 0 );
+    TEST_CHECK( ro.m_writes == 0 );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testGeneric()
+*/
+static void testGeneric( void )
+{
+    TypedDeviceData< int32_t, TestDeviceData > i32( "i32", "integer",
+        DeviceData::ACCESS_READ | DeviceData::ACCESS_WRITE |
+        DeviceData::ACCESS_OBSERVE );
+    DeviceData* p_data = &i32;
+    DeviceDataValue str( DeviceDataValue::TYPE_STRING );
+    TestObserver obs;
+    int32_t val = 0;
+
+    /* the typed element is still a generic element */
+    TEST_CHECK( p_data->observeVal( &obs, NULL ) == 0 );
+    TEST_CHECK( str.setVal( "7" ) == 0 );
+    TEST_CHECK( p_data->setVal( &str ) == 0 );
+
+    /* values of other types are converted to the type of the element */
+    TEST_CHECK( obs.m_count == 1 );
+    TEST_CHECK( obs.m_val == 7 );
+    TEST_CHECK( i32.get( val ) == 0 );
+    TEST_CHECK( val == 7 );
+    TEST_CHECK( p_data->getVal()->getType() == DeviceDataValue::TYPE_INTEGER );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* testValues()
+*/
+static void testValues( void )
+{
+    typedef TypedDeviceData< float, TestDeviceData > t_flt;
+    DeviceDataValue a( DeviceDataValue::TYPE_FLOAT );
+    DeviceDataValue b( DeviceDataValue::TYPE_FLOAT );
+    char buf[32];
+
+    TEST_CHECK( t_flt::fromChars( a, "0.5", 3 ) == 0 );
+    TEST_CHECK( t_flt::valueOf( a ) == 0.5f );
+    TEST_CHECK( t_flt::fromChars( b, "x", 1 ) != 0 );
+    TEST_CHECK( t_flt::equal( a, b ) == false );
+
+    TEST_CHECK( b.setVal( 0.5f ) == 0 );
+    TEST_CHECK( t_flt::equal( a, b ) );
+
+    size_t len = t_flt::toChars( a, buf, sizeof(buf) );
+    TEST_CHECK( std::string( buf, len ) == "0.5" );
+}
+
+/*---------------------------------------------------------------------------*/
+/*
+* main()
+*/
+int main( void )
+{
+    TEST_RUN( testAccess );
+    TEST_RUN( testGeneric );
+    TEST_RUN( testValues );
+
+    return TEST_RESULT();
+}